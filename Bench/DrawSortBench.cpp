@@ -0,0 +1,128 @@
+// Draw sorting: 64-bit sort keys through std::sort, the radix sorter on one
+// thread and over the pool, then the state changes recording would make in
+// submission order against sorted and instanced order.
+//
+//   DrawSortBench [draw-count...]      default: 10000 100000 1000000
+//
+// The scene is instanced content the way it is usually submitted: each
+// object picks a mesh (popular meshes far more often), each mesh has one
+// material, each material one of a few pipelines; ~10% is translucent.
+#include <Core/Render/DrawList.h>
+#include <Core/Utils/RadixSort.h>
+#include <Core/Utils/ThreadPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace Core::Render;
+
+    constexpr uint32_t kPipelines = 8;
+    constexpr uint32_t kMaterials = 300;
+    constexpr uint32_t kMeshes = 2000;
+
+    std::vector<DrawItem> makeScene(size_t count) {
+        std::mt19937 rng(7);
+        // zipf-like popularity: a few meshes account for most instances
+        std::vector<double> weights(kMeshes);
+        for (uint32_t m = 0; m < kMeshes; ++m) weights[m] = 1.0 / (m + 1);
+        std::discrete_distribution<uint32_t> meshDist(weights.begin(), weights.end());
+        std::uniform_real_distribution<float> depth(0.0f, 1.0f), coin(0.0f, 1.0f);
+
+        std::vector<DrawItem> items(count);
+        for (size_t i = 0; i < count; ++i) {
+            DrawItem& d = items[i];
+            d.mesh = meshDist(rng);
+            d.material = d.mesh % kMaterials;
+            d.pipeline = d.material % kPipelines;
+            d.object = static_cast<uint32_t>(i);
+            const float z = depth(rng);
+            d.key = coin(rng) < 0.1f
+                ? SortKey::translucent(d.pipeline, d.material, d.mesh, z)
+                : SortKey::opaque(d.pipeline, d.material, d.mesh, z);
+        }
+        return items;
+    }
+
+    template <class F>
+    double bestMs(int runs, F&& body) {
+        double best = 1e30;
+        for (int i = 0; i < runs; ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            body();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+        }
+        return best;
+    }
+
+    void printCounters(const char* label, DrawCounters const& c) {
+        std::printf("  %-10s draws %9llu  pipeline binds %9llu  descriptor binds %9llu  mesh binds %9llu\n",
+            label, (unsigned long long)c.draws, (unsigned long long)c.pipelineBinds,
+            (unsigned long long)c.descriptorBinds, (unsigned long long)c.meshBinds);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i) counts.push_back(std::stoul(argv[i]));
+    if (counts.empty()) counts = { 10000, 100000, 1000000 };
+
+    Core::ThreadPool pool;
+    std::printf("pool: %u threads\n\n", pool.concurrency());
+
+    bool ok = true;
+    for (size_t count : counts) {
+        const auto items = makeScene(count);
+        std::vector<uint64_t> source(count);
+        for (size_t i = 0; i < count; ++i) source[i] = items[i].key;
+        const int runs = count >= 1000000 ? 5 : 20;
+
+        // reference: pairs through std::stable_sort
+        std::vector<std::pair<uint64_t, uint32_t>> pairs(count);
+        const double stdMs = bestMs(runs, [&] {
+            for (size_t i = 0; i < count; ++i) pairs[i] = { source[i], static_cast<uint32_t>(i) };
+            std::stable_sort(pairs.begin(), pairs.end(),
+                [] (auto const& a, auto const& b) { return a.first < b.first; });
+        });
+
+        Core::RadixSorter sorter;
+        std::vector<uint64_t> keys(count);
+        std::vector<uint32_t> values(count);
+        const auto radix = [&] (Core::ThreadPool* p) {
+            return bestMs(runs, [&] {
+                keys = source;
+                std::iota(values.begin(), values.end(), 0u);
+                sorter.sort(keys, values, p);
+            });
+        };
+        const double radixMs = radix(nullptr);
+        bool same = true;
+        for (size_t i = 0; i < count; ++i)
+            same &= keys[i] == pairs[i].first && values[i] == pairs[i].second;
+        const double radixMtMs = radix(&pool);
+        for (size_t i = 0; i < count; ++i)
+            same &= keys[i] == pairs[i].first && values[i] == pairs[i].second;
+        ok &= same;
+
+        DrawList list;
+        list.reserve(count);
+        for (auto const& item : items) list.add(item);
+        const double buildMs = bestMs(runs, [&] { list.build(&pool); });
+
+        std::printf("%zu draws: std::stable_sort %.2f ms, radix %.2f ms, radix mt %.2f ms "
+            "(%.1fx), build %.2f ms%s\n", count, stdMs, radixMs, radixMtMs,
+            stdMs / std::min(radixMs, radixMtMs), buildMs, same ? "" : "  MISMATCH");
+        printCounters("submitted", list.stats().submitted);
+        printCounters("merged", list.stats().merged);
+        std::printf("\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,832 @@
+// Frame-time harness and regression gate. Runs scripted scenes on a headless
+// device (lavapipe / SwiftShader in CI) for a fixed number of frames, one
+// command buffer and one submit per frame, and reports:
+//
+//   - CPU frame time p50 / p95 / p99 / max, overall and per scene; the
+//     overall time leaves out the wait for the frame slot, which is GPU-bound
+//     and reported on its own (frame_wait_*, not gated)
+//   - queue submissions per frame (the harness's plus the compute dispatcher's)
+//   - Vulkan host allocations per frame (HostAllocator churn across all tags)
+//   - shader loader and pipeline cache hits / misses
+//   - scene counters (merged draws, streaming stalls, ...)
+//
+//   FrameBench [--scene cull,draws,stream,compute,static] [--frames 300]
+//              [--warmup 30] [--objects 50000] [--shaders shaders]
+//              [--no-command-cache] [--json out.json]
+//              [--compare baseline.json] [--threshold 10] [--count-threshold 5]
+//              [--capture out.ctrace]
+//
+// --json writes {"scene", "device", "frames", "metrics": {name: number},
+// "gated": [name...]}. --compare reads such a file and exits 1 when a gated
+// metric got worse by more than the threshold (percent; times use
+// --threshold, counts --count-threshold) or is missing from this run. Cache
+// hits, max times and timing-dependent scene counters are reported but
+// never gated.
+//
+// --capture writes the measured frames' compute dispatcher submissions to a
+// command trace for TraceReplay. Capturing adds its own cost to the frame
+// times, so don't gate a captured run.
+#include <Core/Capture/TraceRecorder.h>
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Culling/GpuCuller.h>
+#include <Core/Memory/FrameAllocator.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Render/CommandCache.h>
+#include <Core/Render/DrawList.h>
+#include <Core/Texture/TextureFormat.h>
+#include <Core/Texture/TextureSource.h>
+#include <Core/Texture/TextureStreamer.h>
+#include <Core/Utils/Report.h>
+#include <Core/Utils/ThreadPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t kFramesInFlight = 2;
+
+    struct Options {
+        std::vector<std::string> scenes{ "cull", "draws", "stream", "compute", "static" };
+        uint64_t frames = 300;
+        uint64_t warmup = 30;
+        uint32_t objects = 50000;
+        std::filesystem::path shaderDir = "shaders";
+        std::string json;
+        std::string compare;
+        std::string capture;
+        double threshold = 10.0;
+        double countThreshold = 5.0;
+        bool commandCache = true;
+    };
+
+    // How --compare treats a metric. Lower is better for everything gated.
+    enum class Gate { Time, Count, None };
+
+    struct Metric {
+        std::string name;
+        double value;
+        Gate gate;
+    };
+    // Ordered, so JSON and tables come out the same way every run.
+    using Metrics = std::vector<Metric>;
+
+    struct FrameInput {
+        uint64_t frame;
+        float angle;               // scripted camera yaw
+        vk::raii::CommandBuffer& cmd;
+        vk::raii::Semaphore const& timeline;
+    };
+
+    class Scene {
+    public:
+        virtual ~Scene() = default;
+        virtual const char* name() const = 0;
+        virtual void frame(FrameInput const& in) = 0;
+        virtual void report(Metrics&) const {}
+    };
+
+    // Column-major perspective(60 deg, 16:9, 0.1..2000) * yaw rotation,
+    // Vulkan clip space, looking down +z at angle 0.
+    void viewProjection(float angle, float out[16]) {
+        const float f = 1.0f / std::tan(0.5f * 1.0472f), aspect = 16.0f / 9.0f;
+        const float zn = 0.1f, zf = 2000.0f;
+        const float p[16] = {
+            f / aspect, 0, 0, 0,
+            0, -f, 0, 0,
+            0, 0, zf / (zf - zn), 1,
+            0, 0, -zn * zf / (zf - zn), 0 };
+        const float c = std::cos(angle), s = std::sin(angle);
+        // rows right = (c, 0, -s), up = (0, 1, 0), forward = (s, 0, c)
+        const float v[16] = {
+            c, 0, s, 0,
+            0, 1, 0, 0,
+            -s, 0, c, 0,
+            0, 0, 0, 1 };
+        for (int col = 0; col < 4; ++col)
+            for (int row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) sum += p[k * 4 + row] * v[col * 4 + k];
+                out[col * 4 + row] = sum;
+            }
+    }
+
+    Core::Geometry::Bounds randomBounds(std::mt19937& rng) {
+        std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f), size(0.5f, 8.0f);
+        Core::Geometry::Bounds b{};
+        const float half = size(rng);
+        for (int i = 0; i < 3; ++i) {
+            b.center[i] = pos(rng);
+            b.min[i] = b.center[i] - half;
+            b.max[i] = b.center[i] + half;
+        }
+        b.radius = half * 1.7320508f;
+        return b;
+    }
+
+    // GPU-driven culling: `objects` instances, 1% of them moving every
+    // frame, culled against the orbiting camera. Exercises the dirty-range
+    // upload, the frame allocator and the culling dispatch.
+    class CullScene final : public Scene {
+    public:
+        CullScene(Core::Compute::ComputeContext& context, Options const& options)
+            : frameAllocator_(context.device(), 1u << 20, kFramesInFlight),
+              culler_(context.device(), context.shaders(), kFramesInFlight, options.shaderDir),
+              rng_(11) {
+            culler_.reserve(options.objects);
+            for (uint32_t i = 0; i < options.objects; ++i)
+                culler_.add(Core::Culling::GpuInstance::from(randomBounds(rng_), 36, 0, 0, i));
+        }
+        const char* name() const override { return "cull"; }
+
+        void frame(FrameInput const& in) override {
+            frameAllocator_.beginFrame(in.frame, in.timeline);
+            std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(culler_.size() - 1));
+            for (size_t i = 0; i < culler_.size() / 100; ++i) {
+                const uint32_t index = pick(rng_);
+                culler_.set(index, Core::Culling::GpuInstance::from(randomBounds(rng_), 36, 0, 0, index));
+            }
+            float m[16];
+            viewProjection(in.angle, m);
+            culler_.record(in.cmd, frameAllocator_, Core::Culling::Frustum::fromViewProjection(m));
+        }
+
+    private:
+        Core::Memory::FrameAllocator frameAllocator_;
+        Core::Culling::GpuCuller culler_;
+        std::mt19937 rng_;
+    };
+
+    // CPU draw submission: the whole list re-added with view depths and
+    // built (radix sort + instancing) every frame.
+    class DrawScene final : public Scene {
+    public:
+        explicit DrawScene(Options const& options) {
+            std::mt19937 rng(7);
+            std::vector<double> weights(kMeshes);
+            for (uint32_t m = 0; m < kMeshes; ++m) weights[m] = 1.0 / (m + 1);
+            std::discrete_distribution<uint32_t> meshDist(weights.begin(), weights.end());
+            std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f), coin(0.0f, 1.0f);
+            objects_.resize(options.objects);
+            for (auto& o : objects_) {
+                o.mesh = meshDist(rng);
+                o.x = pos(rng);
+                o.z = pos(rng);
+                o.translucent = coin(rng) < 0.1f;
+            }
+            list_.reserve(objects_.size());
+        }
+        const char* name() const override { return "draws"; }
+
+        void frame(FrameInput const& in) override {
+            const float fx = std::sin(in.angle), fz = std::cos(in.angle);
+            list_.clear();
+            for (uint32_t i = 0; i < objects_.size(); ++i) {
+                auto const& o = objects_[i];
+                Core::Render::DrawItem d;
+                d.mesh = o.mesh;
+                d.material = o.mesh % kMaterials;
+                d.pipeline = d.material % kPipelines;
+                d.object = i;
+                const float depth = std::clamp((o.x * fx + o.z * fz + 1500.0f) / 3000.0f, 0.0f, 1.0f);
+                d.key = o.translucent
+                    ? Core::Render::SortKey::translucent(d.pipeline, d.material, d.mesh, depth)
+                    : Core::Render::SortKey::opaque(d.pipeline, d.material, d.mesh, depth);
+                list_.add(d);
+            }
+            list_.build(&Core::ThreadPool::shared());
+        }
+
+        void report(Metrics& out) const override {
+            auto const& s = list_.stats();
+            out.push_back({ "draws.submitted_draws", double(s.submitted.draws), Gate::None });
+            out.push_back({ "draws.merged_draws", double(s.merged.draws), Gate::Count });
+            out.push_back({ "draws.merged_pipeline_binds", double(s.merged.pipelineBinds), Gate::Count });
+            out.push_back({ "draws.merged_descriptor_binds", double(s.merged.descriptorBinds), Gate::Count });
+        }
+
+    private:
+        static constexpr uint32_t kPipelines = 8;
+        static constexpr uint32_t kMaterials = 300;
+        static constexpr uint32_t kMeshes = 2000;
+        struct Object { uint32_t mesh; float x, z; bool translucent; };
+        std::vector<Object> objects_;
+        Core::Render::DrawList list_;
+    };
+
+    // Texture streaming: a ring of textures around the orbiting camera with
+    // four times more mip data than the budget. Even textures are requested
+    // from the CPU; odd ones through the GPU feedback buffer, by a dispatch
+    // standing in for the shaders that sample them.
+    class StreamScene final : public Scene {
+    public:
+        explicit StreamScene(Core::Compute::ComputeContext& context)
+            : device_(&context.device()),
+              streamer_(context.device(), Core::Texture::TextureStreamerOptions{
+                  .budgetBytes = 16u << 20,
+                  .stagingBytesPerFrame = 4u << 20,
+                  .framesInFlight = kFramesInFlight,
+                  .consumerStages = vk::PipelineStageFlagBits2::eComputeShader }) {
+            using namespace Core::Texture;
+            const auto dir = std::filesystem::temp_directory_path() / "frame-bench";
+            std::filesystem::create_directories(dir);
+            constexpr uint32_t kTextures = 24, kSize = 512;
+            for (uint32_t i = 0; i < kTextures; ++i) {
+                const auto path = (dir / ("t" + std::to_string(i) + ".ctex")).string();
+                if (!std::filesystem::exists(path)) {
+                    TextureData d{ kSize, kSize, TexelFormat::RGBA8Unorm, {} };
+                    d.texels.resize(size_t(kSize) * kSize * 4);
+                    auto* p = reinterpret_cast<uint8_t*>(d.texels.data());
+                    for (uint32_t t = 0; t < kSize * kSize; ++t, p += 4) {
+                        p[0] = static_cast<uint8_t>(t);
+                        p[1] = static_cast<uint8_t>(t >> 8);
+                        p[2] = static_cast<uint8_t>(i * 37);
+                        p[3] = 255;
+                    }
+                    writeTexture(path, d);
+                }
+                ids_.push_back(streamer_.add(std::make_shared<TextureFile>(path)));
+            }
+
+            // the same choice as frame() makes on the CPU; ids are 0..n-1 in
+            // a fresh streamer, so the feedback index is the ring position
+            const auto shader = dir / "feedback.comp";
+            std::ofstream(shader) <<
+                "#version 450\n"
+                "layout(local_size_x = 64) in;\n"
+                "layout(std430, set = 0, binding = 0) buffer Feedback { uint mip[]; };\n"
+                "layout(push_constant) uniform Push { uint count; float vx; float vz; };\n"
+                "void main() {\n"
+                "    uint i = gl_GlobalInvocationID.x;\n"
+                "    if (i >= count || (i & 1u) == 0u) return;\n"
+                "    float a = 6.2831853 * float(i) / float(count);\n"
+                "    float facing = sin(a) * vx + cos(a) * vz;\n"
+                "    if (facing < 0.5) return;\n"
+                "    atomicMin(mip[i], facing > 0.95 ? 0u : facing > 0.8 ? 1u : 2u);\n"
+                "}\n";
+            pipeline_ = &context.pipeline(Core::Shaders::ShaderKey(
+                std::filesystem::weakly_canonical(shader).string(), Core::Shaders::Stage::Compute,
+                "main", uint64_t{ 0 }));
+
+            auto& dev = device_->vkDevice();
+            const vk::DescriptorPoolSize size{ vk::DescriptorType::eStorageBuffer, kFramesInFlight };
+            pool_ = vk::raii::DescriptorPool(dev, vk::DescriptorPoolCreateInfo{
+                .maxSets = kFramesInFlight, .poolSizeCount = 1, .pPoolSizes = &size },
+                Core::Memory::hostCallbacks(Core::Memory::HostTag::Pipeline));
+            const std::vector<vk::DescriptorSetLayout> layouts(kFramesInFlight,
+                *pipeline_->setLayouts().at(0));
+            for (auto& set : dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+                    .descriptorPool = *pool_,
+                    .descriptorSetCount = kFramesInFlight,
+                    .pSetLayouts = layouts.data() }))
+                sets_.push_back(set.release());
+        }
+        const char* name() const override { return "stream"; }
+
+        void frame(FrameInput const& in) override {
+            streamer_.beginFrame(in.frame, in.timeline);
+            const float vx = std::sin(in.angle), vz = std::cos(in.angle);
+            for (size_t i = 0; i < ids_.size(); i += 2) {
+                const float a = 6.2831853f * float(i) / float(ids_.size());
+                const float facing = std::sin(a) * vx + std::cos(a) * vz;
+                if (facing < 0.5f)
+                    continue;
+                // closest to the view direction gets the full chain
+                streamer_.request(ids_[i], facing > 0.95f ? 0u : facing > 0.8f ? 1u : 2u);
+            }
+            streamer_.update(in.cmd);
+            writeFeedback(in);
+            streamer_.finishFrame(in.cmd);
+        }
+
+        void report(Metrics& out) const override {
+            const auto s = streamer_.stats();
+            // uploads, evictions and stalls depend on decode timing against
+            // the frame loop; only the budget is deterministic
+            out.push_back({ "stream.uploads", double(s.uploads), Gate::None });
+            out.push_back({ "stream.evictions", double(s.evictions), Gate::None });
+            out.push_back({ "stream.stalled_texture_frames", double(s.stalledTextureFrames), Gate::None });
+            out.push_back({ "stream.peak_resident_mib", s.peakResidentBytes / 1048576.0, Gate::Count });
+        }
+
+    private:
+        // The set's previous frame has retired: the harness waited for it
+        // before running the scenes.
+        void writeFeedback(FrameInput const& in) {
+            const vk::DescriptorSet set = sets_[in.frame % kFramesInFlight];
+            const vk::DescriptorBufferInfo info{ streamer_.feedbackBuffer(), 0, vk::WholeSize };
+            device_->vkDevice().updateDescriptorSets(vk::WriteDescriptorSet{
+                .dstSet = set, .dstBinding = 0, .descriptorCount = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &info }, nullptr);
+
+            struct Push { uint32_t count; float vx, vz; };
+            const uint32_t count = static_cast<uint32_t>(ids_.size());
+            in.cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_->handle());
+            in.cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_->layout(), 0, set, nullptr);
+            in.cmd.pushConstants<Push>(pipeline_->layout(), vk::ShaderStageFlagBits::eCompute, 0,
+                Push{ count, std::sin(in.angle), std::cos(in.angle) });
+            in.cmd.dispatch(pipeline_->groupsFor(count), 1, 1);
+        }
+
+        Core::Device* device_;
+        Core::Texture::TextureStreamer streamer_;
+        std::vector<Core::Texture::TextureId> ids_;
+        Core::Compute::ComputePipeline const* pipeline_ = nullptr;
+        vk::raii::DescriptorPool pool_ = nullptr;
+        std::vector<vk::DescriptorSet> sets_; // owned by pool_, one per frame slot
+    };
+
+    // Batched GPGPU work through the dispatcher: per frame, four shader
+    // permutations are looked up by key (the way a material system would)
+    // and chained over one buffer. Submits separately from the frame.
+    class ComputeScene final : public Scene {
+    public:
+        explicit ComputeScene(Core::Compute::ComputeContext& context)
+            : context_(context),
+              data_(context.storageBuffer(kCount * sizeof(float), false)) {
+            const auto dir = std::filesystem::temp_directory_path() / "frame-bench";
+            std::filesystem::create_directories(dir);
+            const auto path = dir / "scale_bias.comp";
+            std::ofstream(path) <<
+                "#version 450\n"
+                "layout(local_size_x = 64) in;\n"
+                "layout(std430, set = 0, binding = 0) buffer Data { float v[]; };\n"
+                "layout(push_constant) uniform Push { uint count; float bias; };\n"
+                "void main() {\n"
+                "    uint i = gl_GlobalInvocationID.x;\n"
+                "    if (i < count) v[i] = v[i] * SCALE + bias;\n"
+                "}\n";
+            path_ = std::filesystem::weakly_canonical(path).string();
+        }
+        ~ComputeScene() override { context_.dispatcher().waitIdle(); }
+        const char* name() const override { return "compute"; }
+
+        void frame(FrameInput const& in) override {
+            while (pending_.size() >= kFramesInFlight) {
+                pending_.front().get();
+                pending_.pop_front();
+            }
+            static constexpr const char* kScales[] = { "SCALE=0.5", "SCALE=2.0", "SCALE=0.25", "SCALE=4.0" };
+            struct Push { uint32_t count; float bias; };
+            Core::Compute::ComputeBatch batch;
+            for (const char* scale : kScales) {
+                auto const& pipeline = context_.pipeline(Core::Shaders::ShaderKey(
+                    path_, Core::Shaders::Stage::Compute, "main", { scale }));
+                batch.dispatch(pipeline, pipeline.groupsFor(kCount))
+                    .bind(0, data_)
+                    .push(Push{ kCount, float(in.frame & 7) });
+            }
+            pending_.push_back(context_.dispatcher().submit(std::move(batch)));
+        }
+
+    private:
+        static constexpr uint32_t kCount = 1u << 18;
+        Core::Compute::ComputeContext& context_;
+        Core::Memory::Buffer data_;
+        std::string path_;
+        std::deque<std::future<Core::Compute::ComputeResult>> pending_;
+    };
+
+    // A fixed post-processing style chain: 256 small dependent dispatches
+    // whose inputs never change. With the command cache they are recorded
+    // once into a secondary buffer and replayed; --no-command-cache records
+    // them into the frame every time for comparison.
+    class StaticScene final : public Scene {
+    public:
+        StaticScene(Core::Compute::ComputeContext& context, Options const& options)
+            : cache_(context.device(), context.device().queues().computeFamily),
+              data_(context.storageBuffer(kInvocations * sizeof(float), false)),
+              cached_(options.commandCache) {
+            const auto dir = std::filesystem::temp_directory_path() / "frame-bench";
+            std::filesystem::create_directories(dir);
+            const auto path = dir / "chain.comp";
+            std::ofstream(path) <<
+                "#version 450\n"
+                "layout(local_size_x = 64) in;\n"
+                "layout(std430, set = 0, binding = 0) buffer Data { float v[]; };\n"
+                "layout(push_constant) uniform Push { uint pass; float weight; };\n"
+                "void main() {\n"
+                "    uint i = gl_GlobalInvocationID.x;\n"
+                "    v[i] = v[i] * weight + float(pass);\n"
+                "}\n";
+            pipeline_ = &context.pipeline(Core::Shaders::ShaderKey(
+                std::filesystem::weakly_canonical(path).string(), Core::Shaders::Stage::Compute,
+                "main", uint64_t{ 0 }));
+
+            auto& dev = context.device().vkDevice();
+            const vk::DescriptorPoolSize size{ vk::DescriptorType::eStorageBuffer, 1 };
+            pool_ = vk::raii::DescriptorPool(dev, vk::DescriptorPoolCreateInfo{
+                .maxSets = 1, .poolSizeCount = 1, .pPoolSizes = &size },
+                Core::Memory::hostCallbacks(Core::Memory::HostTag::Pipeline));
+            const vk::DescriptorSetLayout layout = *pipeline_->setLayouts().at(0);
+            set_ = dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+                .descriptorPool = *pool_, .descriptorSetCount = 1, .pSetLayouts = &layout })
+                .front().release();
+            const vk::DescriptorBufferInfo info{ data_.handle(), 0, vk::WholeSize };
+            dev.updateDescriptorSets(vk::WriteDescriptorSet{
+                .dstSet = set_, .dstBinding = 0, .descriptorCount = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &info }, nullptr);
+        }
+        const char* name() const override { return "static"; }
+
+        void frame(FrameInput const& in) override {
+            if (!cached_) {
+                record(in.cmd);
+                return;
+            }
+            cache_.collect(in.timeline.getCounterValue());
+            Core::Render::CommandKey key;
+            key.add(pipeline_->handle()).add(set_).add(kPasses);
+            in.cmd.executeCommands(cache_.get(0, key, in.frame, nullptr,
+                [this] (vk::raii::CommandBuffer& cmd) { record(cmd); }));
+        }
+
+        void report(Metrics& out) const override {
+            if (!cached_) return;
+            auto const& s = cache_.stats();
+            out.push_back({ "static.cache_records", double(s.records), Gate::Count });
+            out.push_back({ "static.cache_hit_rate", s.hitRate(), Gate::None });
+            out.push_back({ "static.cache_saved_ms", s.savedMs, Gate::None });
+        }
+
+    private:
+        void record(vk::raii::CommandBuffer& cmd) const {
+            struct Push { uint32_t pass; float weight; };
+            cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_->handle());
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_->layout(), 0, set_, nullptr);
+            const vk::MemoryBarrier2 barrier{
+                .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead |
+                    vk::AccessFlagBits2::eShaderStorageWrite };
+            for (uint32_t pass = 0; pass < kPasses; ++pass) {
+                cmd.pushConstants<Push>(pipeline_->layout(), vk::ShaderStageFlagBits::eCompute, 0,
+                    Push{ pass, 0.5f });
+                cmd.dispatch(1, 1, 1);
+                cmd.pipelineBarrier2(vk::DependencyInfo{
+                    .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+            }
+        }
+
+        static constexpr uint32_t kPasses = 256;
+        static constexpr uint32_t kInvocations = 64;
+        Core::Render::CommandCache cache_;
+        Core::Memory::Buffer data_;
+        bool cached_;
+        Core::Compute::ComputePipeline const* pipeline_ = nullptr;
+        vk::raii::DescriptorPool pool_ = nullptr;
+        vk::DescriptorSet set_{}; // owned by pool_
+    };
+
+    using Core::Report::percentile;
+
+    void addTimes(Metrics& out, std::string const& prefix, std::vector<double> const& ms) {
+        out.push_back({ prefix + "_p50_ms", percentile(ms, 0.50), Gate::Time });
+        out.push_back({ prefix + "_p95_ms", percentile(ms, 0.95), Gate::Time });
+        out.push_back({ prefix + "_p99_ms", percentile(ms, 0.99), Gate::Time });
+        // a single descheduling on a shared CI box; reported, not gated
+        out.push_back({ prefix + "_max_ms", percentile(ms, 1.0), Gate::None });
+    }
+
+    uint64_t hostAllocations() {
+        auto& allocator = Core::Memory::HostAllocator::instance();
+        uint64_t total = 0;
+        for (size_t tag = 0; tag < size_t(Core::Memory::HostTag::Count); ++tag)
+            total += allocator.stats(static_cast<Core::Memory::HostTag>(tag)).totalAllocations;
+        return total;
+    }
+
+    std::string joined(std::vector<std::string> const& parts) {
+        std::string out;
+        for (auto const& p : parts) out += (out.empty() ? "" : ",") + p;
+        return out;
+    }
+
+    void writeJson(std::string const& path, std::string const& scene, std::string const& device,
+        uint64_t frames, Metrics const& metrics) {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("Failed to open " + path);
+        out << "{\n  \"scene\": " << Core::Report::jsonString(scene)
+            << ",\n  \"device\": " << Core::Report::jsonString(device)
+            << ",\n  \"frames\": " << frames << ",\n  \"metrics\": {\n";
+        for (size_t i = 0; i < metrics.size(); ++i)
+            out << "    " << Core::Report::jsonString(metrics[i].name) << ": "
+                << Core::Report::jsonNumber(metrics[i].value)
+                << (i + 1 < metrics.size() ? ",\n" : "\n");
+        out << "  },\n  \"gated\": [";
+        bool first = true;
+        for (auto const& m : metrics)
+            if (m.gate != Gate::None) {
+                out << (first ? "\n    " : ",\n    ") << Core::Report::jsonString(m.name);
+                first = false;
+            }
+        out << "\n  ]\n}\n";
+    }
+
+    struct Baseline {
+        std::map<std::string, double> metrics;
+        std::set<std::string> gated;
+        bool hasGates = false; // written before the list existed: treat all as gated
+    };
+
+    // The quote closing the string opened at `open`, past escaped ones.
+    size_t stringEnd(std::string const& text, size_t open) {
+        for (size_t i = open + 1; i < text.size(); ++i) {
+            if (text[i] == '\\') ++i;
+            else if (text[i] == '"') return i;
+        }
+        return std::string::npos;
+    }
+
+    // Only what writeJson produces: every `"name": number` pair, wherever
+    // it is, and the names in the "gated" array. Other strings and nesting
+    // are skipped; names are taken as written, escapes and all.
+    Baseline readBaseline(std::string const& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Failed to open baseline " + path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        const std::string text = ss.str();
+
+        Baseline baseline;
+        if (const size_t key = text.find("\"gated\""); key != std::string::npos) {
+            const size_t open = text.find('[', key), close = text.find(']', key);
+            if (open != std::string::npos && close != std::string::npos && open < close) {
+                baseline.hasGates = true;
+                for (size_t i = text.find('"', open); i < close; i = text.find('"', i)) {
+                    const size_t end = stringEnd(text, i);
+                    if (end == std::string::npos || end > close) break;
+                    baseline.gated.insert(text.substr(i + 1, end - i - 1));
+                    i = end + 1;
+                }
+            }
+        }
+
+        auto& out = baseline.metrics;
+        size_t i = 0;
+        while ((i = text.find('"', i)) != std::string::npos) {
+            const size_t end = stringEnd(text, i);
+            if (end == std::string::npos) break;
+            std::string name = text.substr(i + 1, end - i - 1);
+            size_t j = text.find_first_not_of(" \t\r\n", end + 1);
+            i = end + 1;
+            if (j == std::string::npos || text[j] != ':') continue;
+            j = text.find_first_not_of(" \t\r\n", j + 1);
+            if (j == std::string::npos) break;
+            char* parsedEnd = nullptr;
+            const double value = std::strtod(text.c_str() + j, &parsedEnd);
+            if (parsedEnd != text.c_str() + j) {
+                out[std::move(name)] = value;
+                i = size_t(parsedEnd - text.c_str());
+            }
+        }
+        return baseline;
+    }
+
+    // Tiny absolute changes are noise whatever their ratio (a 0.01 ms scene
+    // going to 0.02 ms).
+    bool compare(Baseline const& baselineFile, Metrics const& current, Options const& options) {
+        auto const& baseline = baselineFile.metrics;
+        std::printf("\n%-36s %12s %12s %9s\n", "metric", "baseline", "current", "change");
+        bool ok = true;
+        for (auto const& [name, value, gate] : current) {
+            const auto it = baseline.find(name);
+            if (it == baseline.end()) {
+                std::printf("%-36s %12s %12.4g %9s\n", name.c_str(), "-", value, "new");
+                continue;
+            }
+            const double base = it->second;
+            const double change = base != 0.0 ? (value - base) / base * 100.0 : (value != 0.0 ? 100.0 : 0.0);
+            bool regressed = false;
+            if (gate == Gate::Time)
+                regressed = change > options.threshold && value - base > 0.05;
+            else if (gate == Gate::Count)
+                regressed = change > options.countThreshold && value - base >= 1.0;
+            ok = ok && !regressed;
+            std::printf("%-36s %12.4g %12.4g %+8.1f%%%s\n", name.c_str(), base, value, change,
+                regressed ? "  REGRESSED" : gate == Gate::None ? "  (info)" : "");
+        }
+        // a gated metric that disappeared (scene dropped or renamed) would
+        // otherwise pass the gate forever
+        for (auto const& [name, value] : baseline) {
+            if (name == "frames" ||
+                std::any_of(current.begin(), current.end(), [&] (auto const& m) { return m.name == name; }))
+                continue;
+            const bool gated = !baselineFile.hasGates || baselineFile.gated.contains(name);
+            ok = ok && !gated;
+            std::printf("%-36s %12.4g %12s %9s%s\n", name.c_str(), value, "-", "missing",
+                gated ? "  REGRESSED" : "  (info)");
+        }
+        return ok;
+    }
+
+    Options parse(int argc, char** argv) {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--no-command-cache") {
+                o.commandCache = false;
+                continue;
+            }
+            if (i + 1 >= argc)
+                throw std::runtime_error("missing value for " + arg);
+            const std::string value = argv[++i];
+            if (arg == "--scene") {
+                o.scenes.clear();
+                std::stringstream ss(value);
+                for (std::string s; std::getline(ss, s, ',');) o.scenes.push_back(s);
+            }
+            else if (arg == "--frames") o.frames = std::stoull(value);
+            else if (arg == "--warmup") o.warmup = std::stoull(value);
+            else if (arg == "--objects") o.objects = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--shaders") o.shaderDir = value;
+            else if (arg == "--json") o.json = value;
+            else if (arg == "--compare") o.compare = value;
+            else if (arg == "--capture") o.capture = value;
+            else if (arg == "--threshold") o.threshold = std::stod(value);
+            else if (arg == "--count-threshold") o.countThreshold = std::stod(value);
+            else throw std::runtime_error("unknown option " + arg);
+        }
+        if (o.frames == 0) throw std::runtime_error("--frames must be positive");
+        return o;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parse(argc, argv);
+
+        Core::Compute::ComputeContext context;
+        Core::Device& device = context.device();
+        auto& dev = device.vkDevice();
+        const std::string deviceName = device.properties().deviceName.data();
+        std::printf("device: %s\n", deviceName.c_str());
+
+        std::vector<std::unique_ptr<Scene>> scenes;
+        for (auto const& name : options.scenes) {
+            if (name == "cull") scenes.push_back(std::make_unique<CullScene>(context, options));
+            else if (name == "draws") scenes.push_back(std::make_unique<DrawScene>(options));
+            else if (name == "stream") scenes.push_back(std::make_unique<StreamScene>(context));
+            else if (name == "compute") scenes.push_back(std::make_unique<ComputeScene>(context));
+            else if (name == "static") scenes.push_back(std::make_unique<StaticScene>(context, options));
+            else throw std::runtime_error("unknown scene " + name);
+        }
+
+        vk::raii::CommandPool pool(dev, vk::CommandPoolCreateInfo{
+            .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueFamilyIndex = device.queues().computeFamily },
+            Core::Memory::hostCallbacks(Core::Memory::HostTag::Commands));
+        vk::raii::CommandBuffers cmds(dev, vk::CommandBufferAllocateInfo{
+            .commandPool = *pool,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = kFramesInFlight });
+        vk::SemaphoreTypeCreateInfo timelineInfo{
+            .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+        vk::raii::Semaphore timeline(dev, vk::SemaphoreCreateInfo{ .pNext = &timelineInfo },
+            Core::Memory::hostCallbacks(Core::Memory::HostTag::Sync));
+
+        std::optional<Core::Capture::TraceRecorder> recorder;
+        if (!options.capture.empty())
+            recorder.emplace(options.capture, device, *context.shaders().blobCache());
+
+        std::vector<double> frameMs, waitMs;
+        std::vector<std::vector<double>> sceneMs(scenes.size());
+        uint64_t submits = 0, dispatcherStart = 0, allocationsStart = 0;
+        const uint64_t total = options.warmup + options.frames;
+        for (uint64_t frame = 1; frame <= total; ++frame) {
+            if (frame == options.warmup + 1) {
+                dispatcherStart = context.dispatcher().submitted();
+                allocationsStart = hostAllocations();
+                if (recorder)
+                    context.dispatcher().setCapture(&*recorder);
+            }
+            const bool measured = frame > options.warmup;
+            const auto t0 = std::chrono::steady_clock::now();
+
+            // the command buffer was last submitted kFramesInFlight frames ago
+            auto waited = std::chrono::steady_clock::duration::zero();
+            if (frame > kFramesInFlight) {
+                const uint64_t wait = frame - kFramesInFlight;
+                const vk::Semaphore semaphore = *timeline;
+                if (dev.waitSemaphores(vk::SemaphoreWaitInfo{
+                        .semaphoreCount = 1, .pSemaphores = &semaphore, .pValues = &wait },
+                        UINT64_MAX) != vk::Result::eSuccess)
+                    throw std::runtime_error("timeline wait failed");
+                waited = std::chrono::steady_clock::now() - t0;
+            }
+            auto& cmd = cmds[frame % kFramesInFlight];
+            cmd.reset();
+            cmd.begin(vk::CommandBufferBeginInfo{
+                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+            const FrameInput in{ frame, 6.2831853f * float(frame) / float(total), cmd, timeline };
+            for (size_t s = 0; s < scenes.size(); ++s) {
+                const auto s0 = std::chrono::steady_clock::now();
+                scenes[s]->frame(in);
+                if (measured)
+                    sceneMs[s].push_back(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - s0).count());
+            }
+
+            cmd.end();
+            const vk::CommandBufferSubmitInfo cmdInfo{ .commandBuffer = *cmd };
+            const vk::SemaphoreSubmitInfo signal{
+                .semaphore = *timeline,
+                .value = frame,
+                .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+            device.computeQueue().submit2(vk::SubmitInfo2{
+                .commandBufferInfoCount = 1,
+                .pCommandBufferInfos = &cmdInfo,
+                .signalSemaphoreInfoCount = 1,
+                .pSignalSemaphoreInfos = &signal });
+            if (recorder && measured)
+                recorder->endFrame();
+
+            if (measured) {
+                ++submits;
+                frameMs.push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0 - waited).count());
+                waitMs.push_back(std::chrono::duration<double, std::milli>(waited).count());
+            }
+        }
+        const uint64_t dispatcherSubmits = context.dispatcher().submitted() - dispatcherStart;
+        const uint64_t allocations = hostAllocations() - allocationsStart;
+        context.dispatcher().setCapture(nullptr);
+        dev.waitIdle();
+
+        Metrics metrics;
+        addTimes(metrics, "frame", frameMs);
+        // how far the GPU is behind; depends on the device, not on this code
+        metrics.push_back({ "frame_wait_p50_ms", percentile(waitMs, 0.50), Gate::None });
+        metrics.push_back({ "frame_wait_p95_ms", percentile(waitMs, 0.95), Gate::None });
+        metrics.push_back({ "frame_wait_max_ms", percentile(waitMs, 1.0), Gate::None });
+        for (size_t s = 0; s < scenes.size(); ++s)
+            addTimes(metrics, std::string(scenes[s]->name()), sceneMs[s]);
+        const double frames = double(options.frames);
+        metrics.push_back({ "submits_per_frame", double(submits + dispatcherSubmits) / frames, Gate::Count });
+        metrics.push_back({ "host_allocations_per_frame", double(allocations) / frames, Gate::Count });
+        auto const& shaders = context.shaders().stats();
+        metrics.push_back({ "shader.compiles", double(shaders.compiles), Gate::Count });
+        metrics.push_back({ "shader.modules_created", double(shaders.modulesCreated), Gate::Count });
+        metrics.push_back({ "shader.handle_hits", double(shaders.handleHits), Gate::None });
+        metrics.push_back({ "shader.blob_hits", double(shaders.blobHits), Gate::None });
+        metrics.push_back({ "shader.module_hits", double(shaders.moduleHits), Gate::None });
+        auto const& pipelines = context.pipelineStats();
+        metrics.push_back({ "pipeline.misses", double(pipelines.misses), Gate::Count });
+        metrics.push_back({ "pipeline.hits", double(pipelines.hits), Gate::None });
+        for (auto const& scene : scenes)
+            scene->report(metrics);
+
+        std::printf("%llu frames (+%llu warmup), scenes %s\n\n",
+            static_cast<unsigned long long>(options.frames),
+            static_cast<unsigned long long>(options.warmup), joined(options.scenes).c_str());
+        for (auto const& [name, value, gate] : metrics)
+            std::printf("%-36s %12.4g\n", name.c_str(), value);
+
+        if (recorder) {
+            auto const& c = recorder->stats();
+            std::printf("\ncaptured %llu batches over %llu frames to %s (%.1f KiB, %.1f KiB uploads)\n",
+                static_cast<unsigned long long>(c.batches), static_cast<unsigned long long>(c.frames),
+                options.capture.c_str(), double(c.fileBytes) / 1024.0, double(c.uploadBytes) / 1024.0);
+        }
+
+        if (!options.json.empty())
+            writeJson(options.json, joined(options.scenes), deviceName, options.frames, metrics);
+
+        if (!options.compare.empty()) {
+            const auto baseline = readBaseline(options.compare);
+            if (auto it = baseline.metrics.find("frames"); it != baseline.metrics.end() && it->second != frames)
+                std::printf("\nwarning: baseline ran %.0f frames, this run %llu\n", it->second,
+                    static_cast<unsigned long long>(options.frames));
+            if (!compare(baseline, metrics, options)) {
+                std::printf("\nperformance regression against %s\n", options.compare.c_str());
+                return 1;
+            }
+            std::printf("\nno regressions against %s\n", options.compare.c_str());
+        }
+        return 0;
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
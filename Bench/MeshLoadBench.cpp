@@ -0,0 +1,160 @@
+// Mesh loading throughput: OBJ text import against the .cmesh container,
+// read with ifstream or memory-mapped, each ending with the streams copied
+// into a staging-sized buffer. Files are written to the temp directory and
+// read warm (page cache), so the numbers are parse/copy cost, not disk.
+//
+//   MeshLoadBench [grid-size] [--gpu]
+//
+// --gpu also uploads through Geometry::MeshLoader on a headless device.
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Geometry/MeshImport.h>
+#include <Core/Geometry/MeshLoader.h>
+#include <Core/Utils/MappedFile.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr int kRuns = 5;
+
+    Core::Geometry::MeshData makeGrid(uint32_t n) {
+        Core::Geometry::MeshData mesh;
+        mesh.attributes = Core::Geometry::AttributePosition | Core::Geometry::AttributeNormal |
+            Core::Geometry::AttributeTexCoord;
+        for (uint32_t y = 0; y <= n; ++y)
+            for (uint32_t x = 0; x <= n; ++x) {
+                const float u = float(x) / float(n), v = float(y) / float(n);
+                mesh.vertices.push_back({ { u, 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f), v },
+                    { 0.0f, 1.0f, 0.0f }, { u, v } });
+            }
+        for (uint32_t y = 0; y < n; ++y)
+            for (uint32_t x = 0; x < n; ++x) {
+                const uint32_t i = y * (n + 1) + x;
+                mesh.indices.insert(mesh.indices.end(),
+                    { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+            }
+        return mesh;
+    }
+
+    void writeObj(const std::string& path, Core::Geometry::MeshData const& mesh) {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) throw std::runtime_error("cannot write " + path);
+        for (auto const& v : mesh.vertices)
+            std::fprintf(f, "v %.6f %.6f %.6f\n", v.position[0], v.position[1], v.position[2]);
+        for (auto const& v : mesh.vertices)
+            std::fprintf(f, "vt %.6f %.6f\n", v.uv[0], v.uv[1]);
+        for (auto const& v : mesh.vertices)
+            std::fprintf(f, "vn %.6f %.6f %.6f\n", v.normal[0], v.normal[1], v.normal[2]);
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const uint32_t a = mesh.indices[i] + 1, b = mesh.indices[i + 1] + 1, c = mesh.indices[i + 2] + 1;
+            std::fprintf(f, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+        }
+        std::fclose(f);
+    }
+
+    // Best of kRuns, in MB/s of `bytes`.
+    double measure(uint64_t bytes, std::function<void()> const& body) {
+        double best = 1e30;
+        for (int i = 0; i < kRuns; ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            body();
+            best = std::min(best,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        }
+        return static_cast<double>(bytes) / (1024.0 * 1024.0) / best;
+    }
+
+    void copyStreams(Core::Geometry::MeshView const& view, std::vector<std::byte>& staging) {
+        staging.resize(view.vertices.size() + view.indices.size());
+        std::memcpy(staging.data(), view.vertices.data(), view.vertices.size());
+        std::memcpy(staging.data() + view.vertices.size(), view.indices.data(), view.indices.size());
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t grid = 512;
+    bool gpu = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--gpu") == 0) gpu = true;
+        else grid = static_cast<uint32_t>(std::stoul(argv[i]));
+    }
+
+    try {
+        const auto dir = std::filesystem::temp_directory_path();
+        const std::string obj = (dir / "MeshLoadBench.obj").string();
+        const std::string cmesh = (dir / "MeshLoadBench.cmesh").string();
+
+        const auto mesh = makeGrid(grid);
+        writeObj(obj, mesh);
+        Core::Geometry::writeMesh(cmesh, mesh);
+        const uint64_t objBytes = std::filesystem::file_size(obj);
+        const uint64_t cmeshBytes = std::filesystem::file_size(cmesh);
+
+        std::printf("%zu vertices, %zu triangles; obj %.1f MiB, cmesh %.1f MiB\n",
+            mesh.vertices.size(), mesh.indices.size() / 3,
+            double(objBytes) / (1 << 20), double(cmeshBytes) / (1 << 20));
+        // throughput is against each format's own size and against the
+        // geometry delivered, which is what a scene load actually waits on
+        const uint64_t payload = mesh.vertices.size() * sizeof(Core::Geometry::Vertex) +
+            mesh.indices.size() * sizeof(uint32_t);
+        std::printf("%-22s %12s %14s\n", "path", "file MB/s", "geometry MB/s");
+        const auto report = [&] (const char* name, uint64_t fileBytes, double fileRate) {
+            std::printf("%-22s %12.1f %14.1f\n", name, fileRate,
+                fileRate * double(payload) / double(fileBytes));
+        };
+
+        std::vector<std::byte> staging;
+
+        report("obj import", objBytes, measure(objBytes, [&] {
+            const auto data = Core::Geometry::importMesh(obj);
+            staging.resize(data.vertices.size() * sizeof(Core::Geometry::Vertex));
+            std::memcpy(staging.data(), data.vertices.data(), staging.size());
+        }));
+
+        report("cmesh ifstream", cmeshBytes, measure(cmeshBytes, [&] {
+            std::ifstream in(cmesh, std::ios::binary);
+            // vector<uint64_t> for the 8-byte alignment parseMesh wants
+            std::vector<uint64_t> words((cmeshBytes + 7) / 8);
+            in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(cmeshBytes));
+            copyStreams(Core::Geometry::parseMesh(
+                { reinterpret_cast<const std::byte*>(words.data()), cmeshBytes }), staging);
+        }));
+
+        report("cmesh mmap", cmeshBytes, measure(cmeshBytes, [&] {
+            Core::MappedFile file(cmesh);
+            file.adviseSequential();
+            copyStreams(Core::Geometry::parseMesh(file.bytes()), staging);
+        }));
+
+        if (gpu) {
+            Core::Compute::ComputeContext context;
+            Core::Geometry::MeshLoader loader(context.device());
+            report("cmesh mmap -> gpu", cmeshBytes, measure(cmeshBytes, [&] {
+                (void)loader.load(cmesh);
+            }));
+            std::printf("device: %s, direct writes %llu / %llu\n",
+                context.device().properties().deviceName.data(),
+                static_cast<unsigned long long>(loader.stats().directWrites),
+                static_cast<unsigned long long>(loader.stats().meshes));
+        }
+
+        std::filesystem::remove(obj);
+        std::filesystem::remove(cmesh);
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Meshlet build and vertex quantization: memory per stream, post-transform
+// cache behaviour before/after meshlet ordering, encode throughput of the
+// SIMD and scalar quantizers, and the decode error the compression costs.
+//
+//   MeshletBench [grid-size]
+//
+// The source is a displaced grid, in row order ("exported" order is the
+// same triangles shuffled, which is what scanned / merged assets look like).
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Geometry/Meshlets.h>
+#include <Core/Geometry/VertexQuantization.h>
+#include <Core/Utils/Simd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace Core::Geometry;
+
+    MeshData makeGrid(uint32_t n) {
+        MeshData mesh;
+        mesh.attributes = AttributePosition | AttributeNormal | AttributeTexCoord;
+        for (uint32_t y = 0; y <= n; ++y)
+            for (uint32_t x = 0; x <= n; ++x) {
+                const float u = float(x) / float(n), v = float(y) / float(n);
+                const float h = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+                // analytic normal of the height field
+                const float dx = 2.0f * std::cos(u * 40.0f) * std::cos(v * 40.0f);
+                const float dz = -2.0f * std::sin(u * 40.0f) * std::sin(v * 40.0f);
+                const float len = std::sqrt(dx * dx + 1.0f + dz * dz);
+                mesh.vertices.push_back({ { u * 10.0f, h, v * 10.0f },
+                    { -dx / len, 1.0f / len, -dz / len }, { u, v } });
+            }
+        for (uint32_t y = 0; y < n; ++y)
+            for (uint32_t x = 0; x < n; ++x) {
+                const uint32_t i = y * (n + 1) + x;
+                mesh.indices.insert(mesh.indices.end(),
+                    { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+            }
+        return mesh;
+    }
+
+    std::vector<uint32_t> shuffleTriangles(std::vector<uint32_t> const& indices) {
+        std::vector<uint32_t> order(indices.size() / 3);
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+        std::vector<uint32_t> out;
+        out.reserve(indices.size());
+        for (uint32_t t : order)
+            out.insert(out.end(), { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] });
+        return out;
+    }
+
+    template <class F>
+    double bestSeconds(int runs, F&& body) {
+        double best = 1e30;
+        for (int i = 0; i < runs; ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            body();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        }
+        return best;
+    }
+
+    double mib(size_t bytes) { return double(bytes) / (1024.0 * 1024.0); }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t grid = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1024;
+    MeshData mesh = makeGrid(grid);
+    const std::vector<uint32_t> shuffled = shuffleTriangles(mesh.indices);
+    const size_t vertexCount = mesh.vertices.size();
+    std::printf("%zu vertices, %zu triangles, simd path: %s\n\n", vertexCount,
+        mesh.indices.size() / 3, Core::Simd::kPathName);
+
+    // ---- meshlets ----
+    MeshletData meshlets;
+    const double buildSeconds = bestSeconds(1, [&] {
+        meshlets = {};
+        appendMeshlets(meshlets, mesh.vertices, shuffled);
+    });
+    const std::vector<uint32_t> ordered = meshletIndices(meshlets);
+    size_t maxVerts = 0, maxTris = 0;
+    for (auto const& m : meshlets.meshlets) {
+        maxVerts = std::max<size_t>(maxVerts, m.vertexCount);
+        maxTris = std::max<size_t>(maxTris, m.triangleCount);
+    }
+    std::printf("meshlets: %zu in %.1f ms, avg %.1f vertices / %.1f triangles (max %zu / %zu)\n\n",
+        meshlets.meshlets.size(), buildSeconds * 1e3,
+        double(meshlets.vertices.size()) / double(meshlets.meshlets.size()),
+        double(shuffled.size() / 3) / double(meshlets.meshlets.size()), maxVerts, maxTris);
+
+    std::printf("%-18s %8s %8s %10s %8s %10s\n", "index order", "ACMR/16", "ATVR/16", "hit rate/16",
+        "ACMR/32", "hit rate/32");
+    const auto cacheRow = [&] (const char* name, std::vector<uint32_t> const& indices) {
+        const auto c16 = analyzeVertexCache(indices, vertexCount, 16);
+        const auto c32 = analyzeVertexCache(indices, vertexCount, 32);
+        std::printf("%-18s %8.3f %8.3f %10.1f%% %8.3f %10.1f%%\n", name, c16.acmr, c16.atvr,
+            c16.hitRate * 100.0, c32.acmr, c32.hitRate * 100.0);
+    };
+    cacheRow("row order", mesh.indices);
+    cacheRow("shuffled (input)", shuffled);
+    cacheRow("meshlet order", ordered);
+
+    // ---- quantization ----
+    const QuantizationTransform transform = quantizationTransform(computeBounds(mesh.vertices));
+    std::vector<QuantizedVertex> simd(vertexCount), scalar(vertexCount);
+    const double simdSeconds = bestSeconds(5, [&] { quantizeVertices(mesh.vertices, simd, transform); });
+    const double scalarSeconds = bestSeconds(5, [&] { quantizeVerticesScalar(mesh.vertices, scalar, transform); });
+    const bool identical = std::memcmp(simd.data(), scalar.data(), vertexCount * sizeof(QuantizedVertex)) == 0;
+
+    float maxPosition = 0.0f, maxAngle = 0.0f, maxUv = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const Vertex d = dequantize(simd[i], transform);
+        Vertex const& v = mesh.vertices[i];
+        float dot = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            maxPosition = std::max(maxPosition, std::abs(d.position[k] - v.position[k]));
+            dot += d.normal[k] * v.normal[k];
+        }
+        maxAngle = std::max(maxAngle, std::acos(std::clamp(dot, -1.0f, 1.0f)) * 57.29578f);
+        for (int k = 0; k < 2; ++k)
+            maxUv = std::max(maxUv, std::abs(d.uv[k] - v.uv[k]));
+    }
+    const float extent = std::max({ transform.scale[0], transform.scale[1], transform.scale[2] });
+
+    std::printf("\n%-18s %12s %12s\n", "encode", "Mvertices/s", "GB/s in");
+    const auto encodeRow = [&] (const char* name, double seconds) {
+        std::printf("%-18s %12.1f %12.2f\n", name, double(vertexCount) / seconds / 1e6,
+            double(vertexCount * sizeof(Vertex)) / seconds / 1e9);
+    };
+    encodeRow(Core::Simd::kPathName, simdSeconds);
+    encodeRow("scalar", scalarSeconds);
+    std::printf("simd output %s scalar output\n", identical ? "matches" : "DIFFERS FROM");
+    std::printf("max error: position %.2e (%.2e of extent), normal %.3f deg, uv %.2e\n\n",
+        maxPosition, maxPosition / extent, maxAngle, maxUv);
+
+    // ---- memory ----
+    const size_t floatVertices = vertexCount * sizeof(Vertex);
+    const size_t packedVertices = vertexCount * sizeof(QuantizedVertex);
+    const size_t indexBytes = mesh.indices.size() * (vertexCount > 0x10000 ? 4 : 2);
+    const size_t meshletBytes = meshlets.meshlets.size() * sizeof(Meshlet) +
+        meshlets.vertices.size() * sizeof(uint32_t) + meshlets.triangles.size();
+    std::printf("%-30s %10s\n", "memory", "MiB");
+    std::printf("%-30s %10.2f\n", "vertices, float (32 B)", mib(floatVertices));
+    std::printf("%-30s %10.2f  (%.0f%% smaller)\n", "vertices, quantized (16 B)", mib(packedVertices),
+        100.0 * (1.0 - double(packedVertices) / double(floatVertices)));
+    std::printf("%-30s %10.2f\n", "index buffer", mib(indexBytes));
+    std::printf("%-30s %10.2f  (%.2f B/triangle)\n", "meshlet streams", mib(meshletBytes),
+        double(meshletBytes) / double(mesh.indices.size() / 3));
+    std::printf("%-30s %10.2f -> %.2f\n", "vertices + indices", mib(floatVertices + indexBytes),
+        mib(packedVertices + indexBytes));
+    return identical ? 0 : 1;
+}
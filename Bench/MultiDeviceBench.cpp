@@ -0,0 +1,163 @@
+// Compute throughput across a DeviceGroup against its first device alone.
+// Each batch chains four define permutations of one scale/bias shader over
+// a per-device buffer; up to --depth batches per device stay in flight.
+//
+// Reports batches per second for both runs, the speedup, how many batches
+// each device took, and the shader work: compiles happen once for the whole
+// group (the shared blob cache), modules and pipelines once per device.
+//
+// On a machine with one suitable device the two runs are the same; add
+// --mix-cpu to bring lavapipe / SwiftShader in next to a GPU.
+//
+//   MultiDeviceBench [--batches 2000] [--depth 4] [--count 262144]
+//                    [--max-devices 0] [--mix-cpu 1]
+#include <Core/Compute/DeviceGroup.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Core::Compute::ComputeBatch;
+    using Core::Compute::ComputeContext;
+    using Core::Compute::ComputeResult;
+    using Core::Compute::DeviceGroup;
+
+    struct Options {
+        uint64_t batches = 2000;
+        size_t depth = 4;
+        uint32_t count = 1u << 18;
+        Core::Compute::DeviceGroupOptions group{};
+    };
+
+    std::string writeShader() {
+        const auto dir = std::filesystem::temp_directory_path() / "multi-device-bench";
+        std::filesystem::create_directories(dir);
+        const auto path = dir / "scale_bias.comp";
+        std::ofstream(path) <<
+            "#version 450\n"
+            "layout(local_size_x = 64) in;\n"
+            "layout(std430, set = 0, binding = 0) buffer Data { float v[]; };\n"
+            "layout(push_constant) uniform Push { uint count; float bias; };\n"
+            "void main() {\n"
+            "    uint i = gl_GlobalInvocationID.x;\n"
+            "    if (i < count) v[i] = v[i] * SCALE + bias;\n"
+            "}\n";
+        return std::filesystem::weakly_canonical(path).string();
+    }
+
+    class Workload {
+    public:
+        Workload(DeviceGroup& group, std::string path, uint32_t count)
+            : path_(std::move(path)), count_(count) {
+            for (size_t i = 0; i < group.size(); ++i)
+                buffers_.push_back(group[i].storageBuffer(count * sizeof(float), false));
+        }
+
+        ComputeBatch build(ComputeContext& context, size_t device, uint64_t n) {
+            static constexpr const char* kScales[] = { "SCALE=0.5", "SCALE=2.0", "SCALE=0.25", "SCALE=4.0" };
+            struct Push { uint32_t count; float bias; };
+            ComputeBatch batch;
+            for (const char* scale : kScales) {
+                auto const& pipeline = context.pipeline(Core::Shaders::ShaderKey(
+                    path_, Core::Shaders::Stage::Compute, "main", { scale }));
+                batch.dispatch(pipeline, pipeline.groupsFor(count_))
+                    .bind(0, buffers_[device])
+                    .push(Push{ count_, float(n & 7) });
+            }
+            return batch;
+        }
+
+    private:
+        std::string path_;
+        uint32_t count_;
+        std::vector<Core::Memory::Buffer> buffers_;
+    };
+
+    // Batches per second. `submit(n)` returns the batch's future.
+    template <class Submit>
+    double run(uint64_t batches, size_t maxPending, Submit&& submit) {
+        std::deque<std::future<ComputeResult>> pending;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t n = 0; n < batches; ++n) {
+            while (pending.size() >= maxPending) {
+                pending.front().get();
+                pending.pop_front();
+            }
+            pending.push_back(submit(n));
+        }
+        for (auto& f : pending) f.get();
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return double(batches) / s;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string arg = argv[i], value = argv[i + 1];
+            if (arg == "--batches") options.batches = std::stoull(value);
+            else if (arg == "--depth") options.depth = std::max<size_t>(1, std::stoul(value));
+            else if (arg == "--count") options.count = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--max-devices") options.group.maxDevices = std::stoul(value);
+            else if (arg == "--mix-cpu") options.group.mixCpuDevices = value != "0";
+            else throw std::runtime_error("unknown option " + arg);
+        }
+
+        DeviceGroup group(options.group);
+        Workload work(group, writeShader(), options.count);
+        std::printf("%zu device(s):\n", group.size());
+        for (size_t i = 0; i < group.size(); ++i)
+            std::printf("  [%zu] %s\n", i, group[i].device().properties().deviceName.data());
+
+        // warm every device's pipelines so neither run pays for them
+        for (size_t i = 0; i < group.size(); ++i)
+            group[i].dispatcher().submit(work.build(group[i], i, 0)).get();
+
+        const double single = run(options.batches, options.depth, [&](uint64_t n) {
+            return group[0].dispatcher().submit(work.build(group[0], 0, n));
+        });
+        const auto before = group.scheduled();
+        const double all = run(options.batches, options.depth * group.size(), [&](uint64_t n) {
+            return group.submit([&](ComputeContext& context, size_t device) {
+                return work.build(context, device, n);
+            });
+        });
+        group.waitIdle();
+
+        std::printf("\n%-28s %12.1f\n", "device 0 batches/s", single);
+        std::printf("%-28s %12.1f\n", "group batches/s", all);
+        std::printf("%-28s %12.2fx\n", "speedup", all / single);
+        for (size_t i = 0; i < group.size(); ++i)
+            std::printf("  device %zu batches %17llu\n", i,
+                static_cast<unsigned long long>(group.scheduled()[i] - before[i]));
+
+        uint64_t compiles = 0, blobHits = 0, modules = 0;
+        for (size_t i = 0; i < group.size(); ++i) {
+            auto const& s = group[i].shaders().stats();
+            compiles += s.compiles;
+            blobHits += s.blobHits;
+            modules += s.modulesCreated;
+        }
+        std::printf("\n%-28s %12zu\n", "shared blobs", group.blobs().size());
+        std::printf("%-28s %12llu\n", "compiles", static_cast<unsigned long long>(compiles));
+        std::printf("%-28s %12llu\n", "shared blob hits", static_cast<unsigned long long>(blobHits));
+        std::printf("%-28s %12llu\n", "modules created", static_cast<unsigned long long>(modules));
+        return 0;
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
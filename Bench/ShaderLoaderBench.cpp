@@ -0,0 +1,256 @@
+// ShaderLoader stage costs over a synthetic compute-shader corpus, written
+// to a temp directory on first run:
+//
+//   include-tree   one root over a binary include tree (depth 6, 63 headers)
+//   permutations   one source with 8 feature blocks, 64 define permutations
+//   large          one ~6000-line source of generated functions
+//
+// Scenarios, each on a fresh loader:
+//   cold           get() on empty caches: read, preprocess, hash, compile,
+//                  reflect, module creation
+//   warm-blob      blobs prewarmed, then get(): everything but the compile
+//   warm-handle    get() of keys already handed out (liveHandles_ hits)
+//
+// Per-stage times come from ShaderLoader::stats(); handle hits are timed
+// around get(). Every metric is the median over --runs, in microseconds per
+// shader (nanoseconds per call for handle hits). The file cache is warm after
+// the first run, so "cold" means cold loader caches, not a cold disk.
+//
+//   ShaderLoaderBench [--corpus include-tree,permutations,large] [--runs 5]
+//                     [--json out.json]
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Shaders/ShaderLoader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    namespace fs = std::filesystem;
+    using Core::Shaders::ShaderKey;
+    using Core::Shaders::ShaderLoader;
+    using Core::Shaders::Stage;
+
+    constexpr const char* kHeader =
+        "#version 450\n"
+        "#extension GL_GOOGLE_include_directive : require\n"
+        "layout(local_size_x = 64) in;\n"
+        "layout(std430, set = 0, binding = 0) buffer Data { float v[]; };\n";
+
+    struct Corpus {
+        std::string name;
+        std::vector<ShaderKey> keys;
+    };
+
+    void writeFile(fs::path const& path, std::string const& text) {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) throw std::runtime_error("Failed to write " + path.string());
+        out << text;
+    }
+
+    // Some arithmetic per function so the compiler has real work to do.
+    std::string function(std::string const& name, int salt) {
+        std::ostringstream f;
+        f << "float " << name << "(float x) {\n"
+          << "    float a = x * " << (salt % 7 + 1) << ".0 + " << salt << ".0;\n"
+          << "    for (int i = 0; i < " << (salt % 4 + 2) << "; ++i)\n"
+          << "        a = a * 0.5 + sin(a + float(i));\n"
+          << "    return a + cos(x);\n"
+          << "}\n";
+        return f.str();
+    }
+
+    std::string writeIncludeNode(fs::path const& dir, int node, int depth) {
+        const std::string name = "node" + std::to_string(node) + ".glsl";
+        std::ostringstream s;
+        s << "#ifndef NODE_" << node << "\n#define NODE_" << node << "\n";
+        if (depth > 0) {
+            s << "#include \"" << writeIncludeNode(dir, node * 2 + 1, depth - 1) << "\"\n";
+            s << "#include \"" << writeIncludeNode(dir, node * 2 + 2, depth - 1) << "\"\n";
+        }
+        s << function("f" + std::to_string(node), node) << "#endif\n";
+        writeFile(dir / name, s.str());
+        return name;
+    }
+
+    Corpus includeTree(fs::path const& dir) {
+        writeIncludeNode(dir, 0, 5);
+        std::ostringstream s;
+        s << kHeader << "#include \"node0.glsl\"\n"
+          << "void main() {\n    uint i = gl_GlobalInvocationID.x;\n    float x = v[i];\n";
+        for (int node = 0; node < 63; ++node) s << "    x = f" << node << "(x);\n";
+        s << "    v[i] = x;\n}\n";
+        const fs::path root = dir / "include_tree.comp";
+        writeFile(root, s.str());
+        return { "include-tree",
+            { ShaderKey(fs::weakly_canonical(root).string(), Stage::Compute, "main", uint64_t{ 0 }) } };
+    }
+
+    Corpus permutations(fs::path const& dir) {
+        std::ostringstream s;
+        s << kHeader;
+        for (int f = 0; f < 8; ++f)
+            s << "#ifdef FEATURE_" << f << "\n" << function("feature" + std::to_string(f), f) << "#endif\n";
+        s << "void main() {\n    uint i = gl_GlobalInvocationID.x;\n    float x = v[i];\n";
+        for (int f = 0; f < 8; ++f)
+            s << "#ifdef FEATURE_" << f << "\n    x = feature" << f << "(x);\n#endif\n";
+        s << "    v[i] = x * float(QUALITY);\n}\n";
+        const fs::path root = dir / "permutations.comp";
+        writeFile(root, s.str());
+
+        Corpus c{ "permutations", {} };
+        const std::string path = fs::weakly_canonical(root).string();
+        for (uint32_t mask = 0; mask < 64; ++mask) {
+            // six feature bits, plus two that follow a quality level
+            std::vector<std::string> defines{ "QUALITY=" + std::to_string(mask % 3 + 1) };
+            for (int f = 0; f < 6; ++f)
+                if (mask & (1u << f)) defines.push_back("FEATURE_" + std::to_string(f));
+            if (mask % 3 >= 1) defines.push_back("FEATURE_6");
+            if (mask % 3 == 2) defines.push_back("FEATURE_7");
+            c.keys.emplace_back(path, Stage::Compute, "main", defines);
+        }
+        return c;
+    }
+
+    Corpus large(fs::path const& dir) {
+        std::ostringstream s;
+        s << kHeader;
+        constexpr int kFunctions = 1000;
+        for (int f = 0; f < kFunctions; ++f) s << function("g" + std::to_string(f), f);
+        s << "void main() {\n    uint i = gl_GlobalInvocationID.x;\n    float x = v[i];\n";
+        for (int f = 0; f < kFunctions; f += 10) s << "    x = g" << f << "(x);\n";
+        s << "    v[i] = x;\n}\n";
+        const fs::path root = dir / "large.comp";
+        writeFile(root, s.str());
+        return { "large",
+            { ShaderKey(fs::weakly_canonical(root).string(), Stage::Compute, "main", uint64_t{ 0 }) } };
+    }
+
+    using Metrics = std::vector<std::pair<std::string, std::vector<double>>>;
+
+    void add(Metrics& m, std::string const& name, double value) {
+        for (auto& [n, values] : m)
+            if (n == name) { values.push_back(value); return; }
+        m.push_back({ name, { value } });
+    }
+
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    void addStages(Metrics& m, std::string const& prefix, ShaderLoader const& loader,
+        double wallNs, size_t shaders) {
+        auto const& t = loader.stats().times;
+        const double n = 1000.0 * double(shaders); // ns -> us per shader
+        add(m, prefix + ".read_us", double(t.readNs) / n);
+        add(m, prefix + ".preprocess_us", double(t.preprocessNs) / n);
+        add(m, prefix + ".hash_us", double(t.hashNs) / n);
+        add(m, prefix + ".compile_us", double(t.compileNs) / n);
+        add(m, prefix + ".reflect_us", double(t.reflectNs) / n);
+        add(m, prefix + ".module_us", double(t.moduleNs) / n);
+        add(m, prefix + ".get_us", wallNs / n);
+    }
+
+    template <class F>
+    double timeNs(F&& body) {
+        const auto t0 = std::chrono::steady_clock::now();
+        body();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void run(Core::Device& device, Corpus const& corpus, Metrics& m) {
+        const size_t n = corpus.keys.size();
+        {
+            auto loader = std::make_unique<ShaderLoader>(device);
+            const double wall = timeNs([&] { for (auto const& k : corpus.keys) loader->get(k); });
+            addStages(m, corpus.name + ".cold", *loader, wall, n);
+
+            constexpr int kRepeats = 10000;
+            const double hits = timeNs([&] {
+                for (int r = 0; r < kRepeats; ++r)
+                    for (auto const& k : corpus.keys) loader->get(k);
+            });
+            add(m, corpus.name + ".warm-handle.get_ns", hits / double(kRepeats * n));
+        }
+        {
+            auto loader = std::make_unique<ShaderLoader>(device);
+            for (auto const& k : corpus.keys) loader->prewarm(k);
+            loader->resetStats();
+            const double wall = timeNs([&] { for (auto const& k : corpus.keys) loader->get(k); });
+            addStages(m, corpus.name + ".warm-blob", *loader, wall, n);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> selected{ "include-tree", "permutations", "large" };
+    int runs = 5;
+    std::string json;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc)
+                throw std::runtime_error("missing value for " + arg);
+            const std::string value = argv[++i];
+            if (arg == "--corpus") {
+                selected.clear();
+                std::stringstream ss(value);
+                for (std::string s; std::getline(ss, s, ',');) selected.push_back(s);
+            }
+            else if (arg == "--runs") runs = std::max(1, std::stoi(value));
+            else if (arg == "--json") json = value;
+            else throw std::runtime_error("unknown option " + arg);
+        }
+
+        const fs::path dir = fs::temp_directory_path() / "shader-loader-bench";
+        fs::create_directories(dir);
+        std::vector<Corpus> corpora;
+        for (auto const& name : selected) {
+            if (name == "include-tree") corpora.push_back(includeTree(dir));
+            else if (name == "permutations") corpora.push_back(permutations(dir));
+            else if (name == "large") corpora.push_back(large(dir));
+            else throw std::runtime_error("unknown corpus " + name);
+        }
+
+        Core::Compute::ComputeContext context;
+        std::printf("device: %s, %d runs, median\n\n", context.device().properties().deviceName.data(), runs);
+
+        Metrics metrics;
+        for (int r = 0; r < runs; ++r)
+            for (auto const& corpus : corpora)
+                run(context.device(), corpus, metrics);
+
+        // name, value: one per line, the same order every run
+        for (auto const& [name, values] : metrics)
+            std::printf("%-40s %12.3f\n", name.c_str(), median(values));
+
+        if (!json.empty()) {
+            std::ofstream out(json);
+            if (!out) throw std::runtime_error("Failed to open " + json);
+            out << "{\n  \"runs\": " << runs << ",\n  \"metrics\": {\n";
+            char buf[64];
+            for (size_t i = 0; i < metrics.size(); ++i) {
+                std::snprintf(buf, sizeof(buf), "%.6g", median(metrics[i].second));
+                out << "    \"" << metrics[i].first << "\": " << buf
+                    << (i + 1 < metrics.size() ? ",\n" : "\n");
+            }
+            out << "  }\n}\n";
+        }
+        return 0;
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,191 @@
+// Texture streaming on a headless device (runs on lavapipe / SwiftShader):
+// a camera orbits a ring of textures whose combined mip chains are several
+// times the memory budget. Every frame the textures in front of the camera
+// request a level by distance; the streamer decodes on workers, uploads
+// through per-frame staging and evicts by LRU. Prints residency, stalls,
+// request-to-resident latency and the CPU cost of update().
+//
+//   TextureStreamBench [textures] [size] [budget-MiB] [frames]
+//                      default: 48 1024 64 600
+//
+// Exits non-zero if resident memory overshoots the budget or if, after the
+// camera stops, requests are still unsatisfied.
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Texture/TextureFormat.h>
+#include <Core/Texture/TextureSource.h>
+#include <Core/Texture/TextureStreamer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace Core::Texture;
+
+    TextureData makePattern(uint32_t size, uint32_t seed) {
+        TextureData d{ size, size, TexelFormat::RGBA8Unorm, {} };
+        d.texels.resize(size_t(size) * size * 4);
+        auto* p = reinterpret_cast<uint8_t*>(d.texels.data());
+        for (uint32_t y = 0; y < size; ++y)
+            for (uint32_t x = 0; x < size; ++x, p += 4) {
+                const bool checker = ((x >> 5) ^ (y >> 5)) & 1;
+                p[0] = static_cast<uint8_t>(x * 255 / size);
+                p[1] = static_cast<uint8_t>(y * 255 / size);
+                p[2] = static_cast<uint8_t>(checker ? seed * 37 : 255 - seed * 37);
+                p[3] = 255;
+            }
+        return d;
+    }
+
+    struct Camera {
+        float angle = 0.0f; // radians around the ring
+    };
+
+    // Textures sit on a ring of radius 10; the camera orbits at radius 4
+    // looking outwards. Visible: within 60 degrees of the view direction.
+    // Level: one per doubling of distance beyond 1 unit.
+    void requestVisible(TextureStreamer& streamer, std::vector<TextureId> const& ids,
+        Camera const& camera) {
+        const float cx = 4.0f * std::cos(camera.angle), cy = 4.0f * std::sin(camera.angle);
+        const float vx = std::cos(camera.angle), vy = std::sin(camera.angle);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const float a = 6.2831853f * float(i) / float(ids.size());
+            const float dx = 10.0f * std::cos(a) - cx, dy = 10.0f * std::sin(a) - cy;
+            const float dist = std::sqrt(dx * dx + dy * dy);
+            if ((dx * vx + dy * vy) / dist < 0.5f)
+                continue;
+            const auto mip = static_cast<uint32_t>(std::max(0.0f, std::floor(std::log2(dist / 6.0f)) + 1.0f));
+            streamer.request(ids[i], mip);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t textureCount = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 48;
+    const uint32_t size = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 1024;
+    const vk::DeviceSize budget = (argc > 3 ? std::stoull(argv[3]) : 64) << 20;
+    const uint64_t frames = argc > 4 ? std::stoull(argv[4]) : 600;
+    constexpr uint32_t kFramesInFlight = 2;
+    constexpr uint64_t kSettleFrames = 240;
+
+    try {
+        const auto dir = std::filesystem::temp_directory_path() / "texture-stream-bench";
+        std::filesystem::create_directories(dir);
+        std::vector<std::string> paths;
+        for (uint32_t i = 0; i < textureCount; ++i) {
+            paths.push_back((dir / ("t" + std::to_string(i) + ".ctex")).string());
+            if (!std::filesystem::exists(paths.back()))
+                writeTexture(paths.back(), makePattern(size, i));
+        }
+
+        Core::Compute::ComputeContext context;
+        Core::Device& device = context.device();
+        auto& dev = device.vkDevice();
+        std::printf("device: %s\n", device.properties().deviceName.data());
+
+        vk::raii::CommandPool pool(dev, vk::CommandPoolCreateInfo{
+            .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueFamilyIndex = device.queues().computeFamily },
+            Core::Memory::hostCallbacks(Core::Memory::HostTag::Commands));
+        vk::raii::CommandBuffers cmds(dev, vk::CommandBufferAllocateInfo{
+            .commandPool = *pool,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = kFramesInFlight });
+        vk::SemaphoreTypeCreateInfo timelineInfo{
+            .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+        vk::raii::Semaphore timeline(dev, vk::SemaphoreCreateInfo{ .pNext = &timelineInfo },
+            Core::Memory::hostCallbacks(Core::Memory::HostTag::Sync));
+
+        TextureStreamer streamer(device, TextureStreamerOptions{
+            .budgetBytes = budget,
+            .framesInFlight = kFramesInFlight,
+            .consumerStages = vk::PipelineStageFlagBits2::eComputeShader });
+        std::vector<TextureId> ids;
+        vk::DeviceSize totalBytes = 0;
+        for (auto const& path : paths) {
+            auto file = std::make_shared<TextureFile>(path);
+            for (uint32_t mip = 0; mip < file->info().mipCount; ++mip)
+                totalBytes += file->info().mipBytes(mip);
+            ids.push_back(streamer.add(std::move(file)));
+        }
+        std::printf("%u textures of %ux%u: %.1f MiB of mip chains, budget %.1f MiB\n\n",
+            textureCount, size, size, totalBytes / 1048576.0, budget / 1048576.0);
+        std::printf("%6s %10s %8s %9s %9s %9s %6s %11s %11s %10s\n", "frame", "resident", "stalled",
+            "uploads", "upload MB", "evictions", "bias", "latency avg", "latency max", "update us");
+
+        Camera camera;
+        double updateUs = 0.0, maxUpdateUs = 0.0;
+        bool ok = true;
+        for (uint64_t frame = 1; frame <= frames + kSettleFrames; ++frame) {
+            // orbit, then hold still so streaming can catch up
+            if (frame <= frames)
+                camera.angle = 6.2831853f * float(frame) / float(frames);
+
+            streamer.beginFrame(frame, timeline);
+            requestVisible(streamer, ids, camera);
+
+            auto& cmd = cmds[frame % kFramesInFlight];
+            cmd.reset();
+            cmd.begin(vk::CommandBufferBeginInfo{
+                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            const auto t0 = std::chrono::steady_clock::now();
+            streamer.update(cmd);
+            const double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - t0).count();
+            updateUs += us;
+            maxUpdateUs = std::max(maxUpdateUs, us);
+            cmd.end();
+
+            const vk::CommandBufferSubmitInfo cmdInfo{ .commandBuffer = *cmd };
+            const vk::SemaphoreSubmitInfo signal{
+                .semaphore = *timeline,
+                .value = frame,
+                .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+            device.computeQueue().submit2(vk::SubmitInfo2{
+                .commandBufferInfoCount = 1,
+                .pCommandBufferInfos = &cmdInfo,
+                .signalSemaphoreInfoCount = 1,
+                .pSignalSemaphoreInfos = &signal });
+
+            const auto s = streamer.stats();
+            // an image may be up to one texture's padding over the estimate
+            if (s.residentBytes > budget + budget / 20) {
+                std::printf("frame %llu: resident %.1f MiB over budget\n",
+                    static_cast<unsigned long long>(frame), s.residentBytes / 1048576.0);
+                ok = false;
+            }
+            if (frame % 60 == 0 || frame == frames + kSettleFrames)
+                std::printf("%6llu %7.1f MiB %4u/%-3u %9llu %9.1f %9llu %6u %8.2f ms %8.2f ms %10.1f\n",
+                    static_cast<unsigned long long>(frame), s.residentBytes / 1048576.0,
+                    s.stalledThisFrame, s.requestedThisFrame,
+                    static_cast<unsigned long long>(s.uploads), s.uploadedBytes / 1048576.0,
+                    static_cast<unsigned long long>(s.evictions), s.mipBias,
+                    s.averageLatencyMs, s.maxLatencyMs, updateUs / double(frame));
+        }
+        dev.waitIdle();
+
+        const auto s = streamer.stats();
+        std::printf("\npeak resident %.1f MiB, stalled texture-frames %llu, budget misses %llu, "
+            "update max %.1f us\n", s.peakResidentBytes / 1048576.0,
+            static_cast<unsigned long long>(s.stalledTextureFrames),
+            static_cast<unsigned long long>(s.budgetMisses), maxUpdateUs);
+        if (s.stalledThisFrame != 0) {
+            std::printf("still %u stalled textures after %llu settle frames\n", s.stalledThisFrame,
+                static_cast<unsigned long long>(kSettleFrames));
+            ok = false;
+        }
+        return ok ? 0 : 1;
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,246 @@
+#include <Core/Capture/CommandTrace.h>
+#include <Core/Utils/MappedFile.h>
+
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+    using namespace Core::Capture;
+
+    class Encoder {
+    public:
+        explicit Encoder(std::vector<std::byte>& out) : out_(out) { out_.clear(); }
+
+        template <class T>
+        void put(T const& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            bytes(&value, sizeof(T));
+        }
+        void bytes(const void* data, size_t size) {
+            const auto* p = static_cast<const std::byte*>(data);
+            out_.insert(out_.end(), p, p + size);
+        }
+        void string(std::string const& s) {
+            put(static_cast<uint32_t>(s.size()));
+            bytes(s.data(), s.size());
+        }
+        void blob(std::vector<std::byte> const& b) {
+            put(static_cast<uint64_t>(b.size()));
+            bytes(b.data(), b.size());
+        }
+
+    private:
+        std::vector<std::byte>& out_;
+    };
+
+    class Decoder {
+    public:
+        explicit Decoder(std::span<const std::byte> in) : in_(in) {}
+
+        template <class T>
+        T get() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+        std::string string() {
+            const auto size = get<uint32_t>();
+            const auto* p = reinterpret_cast<const char*>(take(size));
+            return std::string(p, size);
+        }
+        std::vector<std::byte> blob() {
+            const auto size = get<uint64_t>();
+            const std::byte* p = take(size);
+            return std::vector<std::byte>(p, p + size);
+        }
+        template <class T>
+        std::vector<T> array(uint64_t count) {
+            if (count > in_.size() / sizeof(T))
+                throw std::runtime_error("trace: record truncated");
+            std::vector<T> out(count);
+            std::memcpy(out.data(), take(count * sizeof(T)), count * sizeof(T));
+            return out;
+        }
+
+    private:
+        const std::byte* take(uint64_t size) {
+            if (size > in_.size())
+                throw std::runtime_error("trace: record truncated");
+            const std::byte* p = in_.data();
+            in_ = in_.subspan(size);
+            return p;
+        }
+
+        std::span<const std::byte> in_;
+    };
+
+    struct Encode {
+        Encoder& e;
+
+        RecordType operator()(TraceInfo const& r) const {
+            e.string(r.device);
+            return RecordType::Info;
+        }
+        RecordType operator()(TraceShader const& r) const {
+            e.put(r.contentHash);
+            e.string(r.entry);
+            e.put(static_cast<uint64_t>(r.spirv.size()));
+            e.bytes(r.spirv.data(), r.spirv.size() * sizeof(uint32_t));
+            return RecordType::Shader;
+        }
+        RecordType operator()(TraceBuffer const& r) const {
+            e.put(r);
+            return RecordType::Buffer;
+        }
+        RecordType operator()(TraceUpload const& r) const {
+            e.put(r.buffer);
+            e.put(r.offset);
+            e.blob(r.bytes);
+            return RecordType::Upload;
+        }
+        RecordType operator()(TraceBatch const& r) const {
+            e.put(static_cast<uint32_t>(r.jobs.size()));
+            e.put(static_cast<uint32_t>(r.readbacks.size()));
+            for (auto const& job : r.jobs) {
+                e.put(job.shader);
+                e.put(job.groups);
+                e.put(static_cast<uint32_t>(job.bindings.size()));
+                for (auto const& b : job.bindings) {
+                    e.put(b.set);
+                    e.put(b.binding);
+                    e.put(b.buffer);
+                    e.put(uint32_t{ 0 }); // padding, zeroed so traces of identical runs match
+                    e.put(b.offset);
+                    e.put(b.range);
+                }
+                e.blob(job.pushConstants);
+            }
+            for (auto const& rb : r.readbacks) {
+                e.put(rb.buffer);
+                e.put(uint32_t{ 0 });
+                e.put(rb.offset);
+                e.put(rb.size);
+            }
+            return RecordType::Batch;
+        }
+        RecordType operator()(TraceFrameEnd const&) const {
+            return RecordType::FrameEnd;
+        }
+    };
+
+    TraceBatch decodeBatch(Decoder& d) {
+        TraceBatch batch;
+        const auto jobCount = d.get<uint32_t>();
+        const auto readbackCount = d.get<uint32_t>();
+        batch.jobs.reserve(jobCount);
+        for (uint32_t j = 0; j < jobCount; ++j) {
+            TraceJob job;
+            job.shader = d.get<uint64_t>();
+            for (auto& g : job.groups) g = d.get<uint32_t>();
+            job.bindings = d.array<TraceBinding>(d.get<uint32_t>());
+            job.pushConstants = d.blob();
+            batch.jobs.push_back(std::move(job));
+        }
+        batch.readbacks = d.array<TraceReadback>(readbackCount);
+        return batch;
+    }
+
+    // Bindings and readbacks are written field by field with zeroed padding
+    // and read back as raw structs.
+    static_assert(std::is_trivially_copyable_v<TraceBinding> && sizeof(TraceBinding) == 32);
+    static_assert(std::is_trivially_copyable_v<TraceReadback> && sizeof(TraceReadback) == 24);
+    static_assert(std::is_trivially_copyable_v<TraceBuffer> && sizeof(TraceBuffer) == 16);
+
+} // namespace
+
+Core::Capture::TraceWriter::TraceWriter(std::string const& path)
+    : out_(path, std::ios::binary | std::ios::trunc) {
+    if (!out_)
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    const TraceHeader header{};
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    written_ = sizeof(header);
+}
+
+void Core::Capture::TraceWriter::write(TraceRecord const& record) {
+    Encoder encoder(payload_);
+    const TraceRecordHeader header{
+        .type = std::visit(Encode{ encoder }, record),
+        .size = payload_.size() };
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.write(reinterpret_cast<const char*>(payload_.data()),
+        static_cast<std::streamsize>(payload_.size()));
+    if (!out_)
+        throw std::runtime_error("trace: write failed");
+    written_ += sizeof(header) + payload_.size();
+}
+
+void Core::Capture::TraceWriter::flush() {
+    out_.flush();
+}
+
+std::vector<Core::Capture::TraceRecord> Core::Capture::readTrace(std::string const& path) {
+    const MappedFile file(path);
+    std::span<const std::byte> in = file.bytes();
+
+    TraceHeader header;
+    if (in.size() < sizeof(header))
+        throw std::runtime_error("trace: file too small for a header");
+    std::memcpy(&header, in.data(), sizeof(header));
+    if (header.magic != kTraceMagic)
+        throw std::runtime_error("trace: bad magic");
+    if (header.version > kTraceVersion)
+        throw std::runtime_error("trace: unsupported version " + std::to_string(header.version));
+    in = in.subspan(sizeof(header));
+
+    std::vector<TraceRecord> records;
+    while (!in.empty()) {
+        TraceRecordHeader rh;
+        if (in.size() < sizeof(rh))
+            throw std::runtime_error("trace: record header truncated");
+        std::memcpy(&rh, in.data(), sizeof(rh));
+        in = in.subspan(sizeof(rh));
+        if (rh.size > in.size())
+            throw std::runtime_error("trace: record outside the file (truncated?)");
+        Decoder d(in.first(rh.size));
+        in = in.subspan(rh.size);
+
+        switch (rh.type) {
+        case RecordType::Info:
+            records.emplace_back(TraceInfo{ d.string() });
+            break;
+        case RecordType::Shader: {
+            TraceShader s;
+            s.contentHash = d.get<uint64_t>();
+            s.entry = d.string();
+            s.spirv = d.array<uint32_t>(d.get<uint64_t>());
+            records.emplace_back(std::move(s));
+            break;
+        }
+        case RecordType::Buffer:
+            records.emplace_back(d.get<TraceBuffer>());
+            break;
+        case RecordType::Upload: {
+            TraceUpload u;
+            u.buffer = d.get<uint32_t>();
+            u.offset = d.get<uint64_t>();
+            u.bytes = d.blob();
+            records.emplace_back(std::move(u));
+            break;
+        }
+        case RecordType::Batch:
+            records.emplace_back(decodeBatch(d));
+            break;
+        case RecordType::FrameEnd:
+            records.emplace_back(TraceFrameEnd{});
+            break;
+        default:
+            break; // from a newer writer
+        }
+    }
+    return records;
+}
@@ -0,0 +1,127 @@
+#include <Core/Capture/TraceRecorder.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    // Uniform buffers and NonWritable storage buffers; anything unreflected
+    // is assumed written.
+    bool writable(Core::Compute::ComputePipeline const& pipeline, uint32_t set, uint32_t binding) {
+        for (auto const& b : pipeline.reflection().bindings)
+            if (b.set == set && b.binding == binding)
+                return b.kind == Core::Shaders::DescriptorKind::StorageBuffer && !b.readOnly;
+        return true;
+    }
+
+} // namespace
+
+Core::Capture::TraceRecorder::TraceRecorder(std::string const& path, Device const& device,
+    Shaders::ShaderBlobCache const& blobs)
+    : writer_(path), device_(*device.vkDevice()), blobs_(blobs) {
+    writer_.write(TraceInfo{ device.properties().deviceName.data() });
+}
+
+uint32_t Core::Capture::TraceRecorder::buffer(const Memory::Buffer* source, vk::Buffer handle,
+    bool writable) {
+    if (!source)
+        throw std::runtime_error("TraceRecorder: binding without a source buffer; "
+            "use ComputeJob::bind(binding, Memory::Buffer)");
+    auto [it, inserted] = buffers_.try_emplace(static_cast<VkBuffer>(handle));
+    Tracked& tracked = it->second;
+    // a handle reused after a free comes back as a new buffer
+    if (inserted || tracked.size != source->size()) {
+        tracked = Tracked{ .id = nextId_++, .size = source->size() };
+        writer_.write(TraceBuffer{
+            .id = tracked.id,
+            .memory = static_cast<uint32_t>(source->memoryFlags()),
+            .size = source->size() });
+        ++stats_.buffers;
+    }
+    if (source->mapped() && !tracked.gpuWritten)
+        upload(tracked, *source);
+    if (writable && !tracked.gpuWritten) {
+        tracked.gpuWritten = true;
+        tracked.shadow = {};
+    }
+    return tracked.id;
+}
+
+void Core::Capture::TraceRecorder::upload(Tracked& tracked, Memory::Buffer const& source) {
+    const auto* bytes = static_cast<const std::byte*>(source.mapped());
+    const size_t size = static_cast<size_t>(source.size());
+    size_t first = 0, last = size;
+    if (tracked.shadow.size() == size) {
+        const auto* shadow = tracked.shadow.data();
+        while (first < size && bytes[first] == shadow[first]) ++first;
+        if (first == size)
+            return;
+        while (last > first && bytes[last - 1] == shadow[last - 1]) --last;
+    }
+    else {
+        tracked.shadow.resize(size);
+    }
+    std::memcpy(tracked.shadow.data() + first, bytes + first, last - first);
+
+    writer_.write(TraceUpload{
+        .buffer = tracked.id,
+        .offset = first,
+        .bytes = std::vector<std::byte>(bytes + first, bytes + last) });
+    stats_.uploadBytes += last - first;
+}
+
+void Core::Capture::TraceRecorder::shader(Compute::ComputePipeline const& pipeline) {
+    if (!shaders_.insert(pipeline.blobHash()).second)
+        return;
+    const auto blob = blobs_.find(pipeline.blobHash());
+    if (!blob)
+        throw std::runtime_error("TraceRecorder: no blob for shader " + std::to_string(pipeline.blobHash()));
+    writer_.write(TraceShader{
+        .contentHash = blob->contentHash,
+        .entry = pipeline.entry(),
+        .spirv = blob->spirv });
+    ++stats_.shaders;
+}
+
+void Core::Capture::TraceRecorder::batch(Compute::ComputeBatch const& batch, vk::Semaphore timeline,
+    uint64_t value) {
+    CORE_PROFILE_ZONE("TraceRecorder::batch");
+    // anything submitted before the capture may still be writing buffers
+    // this batch is about to snapshot
+    if (!started_ && value > 1) {
+        const uint64_t previous = value - 1;
+        if (device_.waitSemaphores(vk::SemaphoreWaitInfo{
+                .semaphoreCount = 1, .pSemaphores = &timeline, .pValues = &previous },
+                UINT64_MAX) != vk::Result::eSuccess)
+            throw std::runtime_error("TraceRecorder: waiting for earlier batches failed");
+    }
+    started_ = true;
+
+    TraceBatch out;
+    out.jobs.reserve(batch.jobs().size());
+    for (auto const& job : batch.jobs()) {
+        shader(*job.pipeline);
+        TraceJob& j = out.jobs.emplace_back();
+        j.shader = job.pipeline->blobHash();
+        std::copy(job.groups.begin(), job.groups.end(), j.groups);
+        for (auto const& b : job.buffers)
+            j.bindings.push_back({ b.set, b.binding,
+                buffer(b.source, b.buffer, writable(*job.pipeline, b.set, b.binding)), b.offset, b.range });
+        j.pushConstants = job.pushConstants;
+    }
+    for (auto const& r : batch.readbacks())
+        out.readbacks.push_back({ buffer(r.source, r.buffer, false), r.offset, r.size });
+    writer_.write(out);
+    ++stats_.batches;
+    stats_.fileBytes = writer_.bytesWritten();
+}
+
+void Core::Capture::TraceRecorder::endFrame() {
+    writer_.write(TraceFrameEnd{});
+    writer_.flush();
+    ++stats_.frames;
+    stats_.fileBytes = writer_.bytesWritten();
+}
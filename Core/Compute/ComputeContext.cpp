@@ -0,0 +1,82 @@
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <glslang/Public/ShaderLang.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Reference counted by glslang; tools without a Renderer have nobody else
+// to do it.
+Core::Compute::ComputeContext::GlslangProcess::GlslangProcess() { glslang::InitializeProcess(); }
+Core::Compute::ComputeContext::GlslangProcess::~GlslangProcess() { glslang::FinalizeProcess(); }
+
+Core::Compute::ComputeContext::ComputeContext(ComputeContextOptions options) {
+    const vk::ApplicationInfo appInfo{
+        .pApplicationName = "Core Compute",
+        .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+        .pEngineName = "No Engine",
+        .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+        .apiVersion = options.apiVersion };
+
+    std::vector<const char*> layers;
+    if (options.validation) {
+        constexpr const char* validationLayer = "VK_LAYER_KHRONOS_validation";
+        const auto available = context_.enumerateInstanceLayerProperties();
+        if (std::ranges::none_of(available, [validationLayer](auto const& layer) {
+                return strcmp(layer.layerName, validationLayer) == 0;
+            }))
+            throw std::runtime_error("Required layer not supported: " + std::string(validationLayer));
+        layers.push_back(validationLayer);
+    }
+
+    // no surface extensions: this instance never presents
+    instance_ = vk::raii::Instance(context_, vk::InstanceCreateInfo{
+        .pApplicationInfo = &appInfo,
+        .enabledLayerCount = static_cast<uint32_t>(layers.size()),
+        .ppEnabledLayerNames = layers.data() },
+        Memory::hostCallbacks(Memory::HostTag::Instance));
+
+    device_ = Device(instance_, options.apiVersion);
+    shaders_.emplace(device_, std::move(options.shaderBlobs));
+    dispatcher_.emplace(device_);
+}
+
+Core::Compute::ComputeContext::ComputeContext(vk::raii::Instance& instance,
+    vk::raii::PhysicalDevice physical, ComputeContextOptions options)
+    : device_(instance, std::move(physical), options.apiVersion) {
+    shaders_.emplace(device_, std::move(options.shaderBlobs));
+    dispatcher_.emplace(device_);
+}
+
+Core::Compute::ComputeContext::~ComputeContext() {
+    // resolve outstanding futures before the device goes away
+    dispatcher_.reset();
+    pipelines_.clear();
+    shaders_.reset();
+}
+
+Core::Compute::ComputePipeline const&
+Core::Compute::ComputeContext::pipeline(Shaders::ShaderKey const& key) {
+    if (auto it = pipelines_.find(key); it != pipelines_.end()) {
+        ++pipelineStats_.hits;
+        return *it->second;
+    }
+    ++pipelineStats_.misses;
+    auto pipeline = std::make_unique<ComputePipeline>(device_, shaders_->get(key));
+    return *pipelines_.emplace(key, std::move(pipeline)).first->second;
+}
+
+Core::Memory::Buffer
+Core::Compute::ComputeContext::storageBuffer(vk::DeviceSize size, bool hostVisible) {
+    const auto usage = vk::BufferUsageFlagBits::eStorageBuffer |
+        vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+    if (hostVisible)
+        return Memory::Buffer(device_, size, usage,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+    return Memory::Buffer(device_, size, usage, vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
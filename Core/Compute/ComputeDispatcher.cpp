@@ -0,0 +1,299 @@
+#include <Core/Compute/ComputeDispatcher.h>
+#include <Core/Capture/TraceRecorder.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    // smallest descriptor pool, so that typical batches share a few pools
+    constexpr uint32_t kMinPoolSets = 16;
+    constexpr uint32_t kMinPoolBuffers = 64;
+
+    void memoryBarrier(vk::raii::CommandBuffer& cmd,
+        vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess,
+        vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess) {
+        const vk::MemoryBarrier2 barrier{
+            .srcStageMask = srcStage,
+            .srcAccessMask = srcAccess,
+            .dstStageMask = dstStage,
+            .dstAccessMask = dstAccess };
+        cmd.pipelineBarrier2(vk::DependencyInfo{
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &barrier });
+    }
+
+    const Core::Compute::BufferBinding* findBinding(Core::Compute::ComputeJob const& job,
+        uint32_t set, uint32_t binding) {
+        for (auto const& b : job.buffers)
+            if (b.set == set && b.binding == binding)
+                return &b;
+        return nullptr;
+    }
+
+} // namespace
+
+Core::Compute::ComputeDispatcher::ComputeDispatcher(Device& device) : device_(&device) {
+    if (device.queues().computeFamily == UINT32_MAX)
+        throw std::runtime_error("ComputeDispatcher: device has no compute queue");
+
+    pool_ = vk::raii::CommandPool(device.vkDevice(), vk::CommandPoolCreateInfo{
+        .flags = vk::CommandPoolCreateFlagBits::eTransient,
+        .queueFamilyIndex = device.queues().computeFamily },
+        Memory::hostCallbacks(Memory::HostTag::Commands));
+
+    vk::SemaphoreTypeCreateInfo timelineInfo{
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0 };
+    timeline_ = vk::raii::Semaphore(device.vkDevice(),
+        vk::SemaphoreCreateInfo{ .pNext = &timelineInfo },
+        Memory::hostCallbacks(Memory::HostTag::Sync));
+    readback_.emplace(device);
+
+    completion_ = std::thread([this] { complete(); });
+}
+
+Core::Compute::ComputeDispatcher::~ComputeDispatcher() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    // the completion thread drains everything in flight before it exits
+    if (completion_.joinable())
+        completion_.join();
+    retired_.clear();
+}
+
+std::future<Core::Compute::ComputeResult>
+Core::Compute::ComputeDispatcher::submit(ComputeBatch batch) {
+    CORE_PROFILE_ZONE("ComputeDispatcher::submit");
+    collectRetired();
+
+    auto s = std::make_unique<Submission>();
+    s->value = submitted_ + 1;
+    record(*s, batch);
+    if (capture_)
+        capture_->batch(batch, *timeline_, s->value);
+
+    const vk::CommandBufferSubmitInfo cmdInfo{ .commandBuffer = *s->cmd };
+    const vk::SemaphoreSubmitInfo signal{
+        .semaphore = *timeline_,
+        .value = s->value,
+        .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+    device_->computeQueue().submit2(vk::SubmitInfo2{
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &cmdInfo,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signal });
+    submitted_ = s->value;
+
+    auto future = s->promise.get_future();
+    {
+        std::lock_guard lock(mutex_);
+        inFlight_.push_back(std::move(s));
+    }
+    cv_.notify_one();
+    return future;
+}
+
+void Core::Compute::ComputeDispatcher::record(Submission& s, ComputeBatch const& batch) {
+    auto& device = device_->vkDevice();
+
+    // validate against reflection and size the descriptor pool in one pass
+    std::map<vk::DescriptorType, uint32_t> typeCounts;
+    uint32_t setCount = 0, bufferCount = 0;
+    for (auto const& job : batch.jobs_) {
+        if (!job.pipeline)
+            throw std::runtime_error("ComputeDispatcher: job without a pipeline");
+        const auto& reflection = job.pipeline->reflection();
+        for (auto const& b : reflection.bindings) {
+            if (b.kind != Shaders::DescriptorKind::StorageBuffer &&
+                b.kind != Shaders::DescriptorKind::UniformBuffer)
+                throw std::runtime_error("ComputeDispatcher: set " + std::to_string(b.set) +
+                    " binding " + std::to_string(b.binding) + " is not a buffer");
+            if (!findBinding(job, b.set, b.binding))
+                throw std::runtime_error("ComputeDispatcher: set " + std::to_string(b.set) +
+                    " binding " + std::to_string(b.binding) + " is not bound");
+            typeCounts[toVk(b.kind)] += b.count;
+            bufferCount += b.count;
+        }
+        if (job.pushConstants.size() < reflection.pushConstantSize)
+            throw std::runtime_error("ComputeDispatcher: shader expects " +
+                std::to_string(reflection.pushConstantSize) + " bytes of push constants, got " +
+                std::to_string(job.pushConstants.size()));
+        setCount += static_cast<uint32_t>(job.pipeline->setLayouts().size());
+    }
+
+    if (setCount > 0) {
+        uint32_t perType = 0;
+        for (auto const& [type, count] : typeCounts)
+            perType = std::max(perType, count);
+        s.descriptors = takeDescriptors(setCount, perType);
+    }
+
+    s.cmd = std::move(device.allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        .commandPool = *pool_,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1 }).front());
+    auto& cmd = s.cmd;
+    cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    // stable storage for the pointers in the descriptor writes
+    std::vector<vk::DescriptorBufferInfo> bufferInfos;
+    bufferInfos.reserve(bufferCount);
+
+    for (size_t i = 0; i < batch.jobs_.size(); ++i) {
+        auto const& job = batch.jobs_[i];
+        auto const& pipeline = *job.pipeline;
+
+        if (i > 0)
+            memoryBarrier(cmd,
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+                vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.handle());
+
+        if (!pipeline.setLayouts().empty()) {
+            std::vector<vk::DescriptorSetLayout> layouts;
+            for (auto const& layout : pipeline.setLayouts())
+                layouts.push_back(*layout);
+            std::vector<vk::DescriptorSet> sets;
+            // owned by the pool, which is reset when the submission retires
+            for (auto& set : device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+                     .descriptorPool = *s.descriptors.pool,
+                     .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+                     .pSetLayouts = layouts.data() }))
+                sets.push_back(set.release());
+
+            std::vector<vk::WriteDescriptorSet> writes;
+            for (auto const& b : pipeline.reflection().bindings) {
+                const BufferBinding* bound = findBinding(job, b.set, b.binding);
+                bufferInfos.push_back({ bound->buffer, bound->offset, bound->range });
+                writes.push_back(vk::WriteDescriptorSet{
+                    .dstSet = sets[b.set],
+                    .dstBinding = b.binding,
+                    .descriptorCount = 1,
+                    .descriptorType = toVk(b.kind),
+                    .pBufferInfo = &bufferInfos.back() });
+            }
+            device.updateDescriptorSets(writes, nullptr);
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline.layout(), 0, sets, nullptr);
+        }
+
+        if (const uint32_t size = pipeline.reflection().pushConstantSize)
+            cmd.pushConstants<std::byte>(pipeline.layout(), vk::ShaderStageFlagBits::eCompute, 0,
+                vk::ArrayProxy<const std::byte>(size, job.pushConstants.data()));
+
+        cmd.dispatch(job.groups[0], job.groups[1], job.groups[2]);
+    }
+
+    // the manager adds the barriers around its copies
+    for (auto const& r : batch.readbacks_)
+        s.readbacks.push_back(readback_->readBuffer(cmd, r.buffer, r.offset, r.size,
+            timeline_, s.value));
+    cmd.end();
+}
+
+Core::Compute::ComputeDispatcher::Descriptors
+Core::Compute::ComputeDispatcher::takeDescriptors(uint32_t sets, uint32_t buffers) {
+    auto fits = std::find_if(freeDescriptors_.begin(), freeDescriptors_.end(),
+        [&](Descriptors const& d) { return d.sets >= sets && d.buffers >= buffers; });
+    if (fits != freeDescriptors_.end()) {
+        Descriptors d = std::move(*fits);
+        freeDescriptors_.erase(fits);
+        return d;
+    }
+    // replace a pool that is too small rather than keeping it around
+    if (!freeDescriptors_.empty())
+        freeDescriptors_.pop_back();
+
+    Descriptors d;
+    d.sets = std::max(kMinPoolSets, std::bit_ceil(sets));
+    d.buffers = std::max(kMinPoolBuffers, std::bit_ceil(buffers));
+    const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, d.buffers },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eUniformBuffer, d.buffers } };
+    d.pool = vk::raii::DescriptorPool(device_->vkDevice(), vk::DescriptorPoolCreateInfo{
+        .maxSets = d.sets,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data() },
+        Memory::hostCallbacks(Memory::HostTag::Pipeline));
+    return d;
+}
+
+void Core::Compute::ComputeDispatcher::complete() {
+    CORE_PROFILE_THREAD("compute completion");
+    for (;;) {
+        Submission* s;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !inFlight_.empty(); });
+            if (inFlight_.empty())
+                return;
+            s = inFlight_.front().get();
+        }
+
+        try {
+            const vk::Semaphore timeline = *timeline_;
+            const auto result = device_->vkDevice().waitSemaphores(vk::SemaphoreWaitInfo{
+                .semaphoreCount = 1,
+                .pSemaphores = &timeline,
+                .pValues = &s->value }, UINT64_MAX);
+            if (result != vk::Result::eSuccess)
+                throw std::runtime_error("ComputeDispatcher: timeline wait failed");
+
+            // the copies are resolved by the readback workers
+            readback_->poll();
+            ComputeResult out;
+            out.readbacks.reserve(s->readbacks.size());
+            for (auto& readback : s->readbacks)
+                out.readbacks.push_back(readback.get().bytes);
+            s->promise.set_value(std::move(out));
+        } catch (...) {
+            s->promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            retired_.push_back(std::move(inFlight_.front()));
+            inFlight_.pop_front();
+        }
+        idle_.notify_all();
+    }
+}
+
+void Core::Compute::ComputeDispatcher::collectRetired() {
+    std::vector<std::unique_ptr<Submission>> done;
+    {
+        std::lock_guard lock(mutex_);
+        done.swap(retired_);
+    }
+    // the timeline has passed these submissions: their descriptor sets are
+    // no longer in use
+    for (auto& s : done)
+        if (*s->descriptors.pool) {
+            s->descriptors.pool.reset();
+            freeDescriptors_.push_back(std::move(s->descriptors));
+        }
+    // frees command buffers back into pool_ on this thread
+}
+
+void Core::Compute::ComputeDispatcher::waitIdle() {
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return inFlight_.empty(); });
+    }
+    collectRetired();
+}
+
+size_t Core::Compute::ComputeDispatcher::inFlight() const {
+    std::lock_guard lock(mutex_);
+    return inFlight_.size();
+}
@@ -0,0 +1,75 @@
+#include <Core/Compute/ComputePipeline.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+vk::DescriptorType Core::Compute::toVk(Shaders::DescriptorKind kind) {
+    using Shaders::DescriptorKind;
+    switch (kind) {
+        case DescriptorKind::UniformBuffer:        return vk::DescriptorType::eUniformBuffer;
+        case DescriptorKind::StorageBuffer:        return vk::DescriptorType::eStorageBuffer;
+        case DescriptorKind::StorageImage:         return vk::DescriptorType::eStorageImage;
+        case DescriptorKind::SampledImage:         return vk::DescriptorType::eSampledImage;
+        case DescriptorKind::Sampler:              return vk::DescriptorType::eSampler;
+        case DescriptorKind::CombinedImageSampler: return vk::DescriptorType::eCombinedImageSampler;
+        case DescriptorKind::UniformTexelBuffer:   return vk::DescriptorType::eUniformTexelBuffer;
+        case DescriptorKind::StorageTexelBuffer:   return vk::DescriptorType::eStorageTexelBuffer;
+    }
+    return vk::DescriptorType::eStorageBuffer;
+}
+
+Core::Compute::ComputePipeline::ComputePipeline(Device& device, Shaders::ShaderHandle const& shader)
+    : reflection_(shader.module->reflect), blobHash_(shader.module->blobHash), entry_(shader.key.entry) {
+    if (shader.key.stage != Shaders::Stage::Compute)
+        throw std::runtime_error("ComputePipeline: " + shader.key.canonicalPath + " is not a compute shader");
+
+    const auto* callbacks = Memory::hostCallbacks(Memory::HostTag::Pipeline);
+
+    uint32_t setCount = 0;
+    for (auto const& b : reflection_.bindings) {
+        if (b.kind == Shaders::DescriptorKind::Sampler ||
+            b.kind == Shaders::DescriptorKind::UniformTexelBuffer ||
+            b.kind == Shaders::DescriptorKind::StorageTexelBuffer)
+            throw std::runtime_error("ComputePipeline: binding " + std::to_string(b.binding) +
+                " of " + shader.key.canonicalPath + " has an unsupported descriptor type");
+        if (b.count != 1)
+            throw std::runtime_error("ComputePipeline: descriptor arrays are not supported");
+        setCount = std::max(setCount, b.set + 1);
+    }
+
+    std::vector<std::vector<vk::DescriptorSetLayoutBinding>> perSet(setCount);
+    for (auto const& b : reflection_.bindings) {
+        perSet[b.set].push_back(vk::DescriptorSetLayoutBinding{
+            .binding = b.binding,
+            .descriptorType = toVk(b.kind),
+            .descriptorCount = b.count,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute });
+    }
+    for (auto const& bindings : perSet) {
+        setLayouts_.emplace_back(device.vkDevice(), vk::DescriptorSetLayoutCreateInfo{
+            .bindingCount = static_cast<uint32_t>(bindings.size()),
+            .pBindings = bindings.data() }, callbacks);
+    }
+
+    std::vector<vk::DescriptorSetLayout> rawLayouts;
+    for (auto const& layout : setLayouts_)
+        rawLayouts.push_back(*layout);
+    const vk::PushConstantRange pushRange{
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = reflection_.pushConstantSize };
+    layout_ = vk::raii::PipelineLayout(device.vkDevice(), vk::PipelineLayoutCreateInfo{
+        .setLayoutCount = static_cast<uint32_t>(rawLayouts.size()),
+        .pSetLayouts = rawLayouts.data(),
+        .pushConstantRangeCount = reflection_.pushConstantSize ? 1u : 0u,
+        .pPushConstantRanges = &pushRange }, callbacks);
+
+    pipeline_ = vk::raii::Pipeline(device.vkDevice(), nullptr, vk::ComputePipelineCreateInfo{
+        .stage = vk::PipelineShaderStageCreateInfo{
+            .stage = vk::ShaderStageFlagBits::eCompute,
+            .module = shader.module->raw(),
+            .pName = entry_.c_str() },
+        .layout = *layout_ }, callbacks);
+}
@@ -0,0 +1,80 @@
+#include <Core/Compute/DeviceGroup.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+Core::Compute::DeviceGroup::DeviceGroup(DeviceGroupOptions options)
+    : blobs_(std::make_shared<Shaders::ShaderBlobCache>()) {
+    const vk::ApplicationInfo appInfo{
+        .pApplicationName = "Core Compute",
+        .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+        .pEngineName = "No Engine",
+        .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+        .apiVersion = options.apiVersion };
+
+    std::vector<const char*> layers;
+    if (options.validation) {
+        constexpr const char* validationLayer = "VK_LAYER_KHRONOS_validation";
+        const auto available = context_.enumerateInstanceLayerProperties();
+        if (std::ranges::none_of(available, [validationLayer](auto const& layer) {
+                return strcmp(layer.layerName, validationLayer) == 0;
+            }))
+            throw std::runtime_error("Required layer not supported: " + std::string(validationLayer));
+        layers.push_back(validationLayer);
+    }
+
+    instance_ = vk::raii::Instance(context_, vk::InstanceCreateInfo{
+        .pApplicationInfo = &appInfo,
+        .enabledLayerCount = static_cast<uint32_t>(layers.size()),
+        .ppEnabledLayerNames = layers.data() },
+        Memory::hostCallbacks(Memory::HostTag::Instance));
+
+    auto physical = Device::selectAllPhysical(instance_, true);
+    const auto isCpu = [](vk::raii::PhysicalDevice const& d) {
+        return d.getProperties().deviceType == vk::PhysicalDeviceType::eCpu;
+    };
+    if (!options.mixCpuDevices && !std::ranges::all_of(physical, isCpu))
+        std::erase_if(physical, isCpu);
+    if (physical.empty())
+        throw std::runtime_error("failed to find a suitable GPU!");
+    if (options.maxDevices && physical.size() > options.maxDevices)
+        physical.erase(physical.begin() + static_cast<std::ptrdiff_t>(options.maxDevices), physical.end());
+
+    const ComputeContextOptions contextOptions{
+        .validation = options.validation,
+        .apiVersion = options.apiVersion,
+        .shaderBlobs = blobs_ };
+    for (auto& p : physical)
+        contexts_.push_back(std::make_unique<ComputeContext>(instance_, std::move(p), contextOptions));
+    scheduled_.assign(contexts_.size(), 0);
+}
+
+Core::Compute::DeviceGroup::~DeviceGroup() {
+    // contexts first: their devices were created from instance_
+    contexts_.clear();
+}
+
+size_t Core::Compute::DeviceGroup::pick() {
+    size_t best = next_ % contexts_.size();
+    size_t bestLoad = contexts_[best]->dispatcher().inFlight();
+    for (size_t i = 1; i < contexts_.size() && bestLoad > 0; ++i) {
+        const size_t index = (next_ + i) % contexts_.size();
+        const size_t load = contexts_[index]->dispatcher().inFlight();
+        if (load < bestLoad) {
+            best = index;
+            bestLoad = load;
+        }
+    }
+    next_ = best + 1;
+    return best;
+}
+
+void Core::Compute::DeviceGroup::waitIdle() {
+    for (auto& context : contexts_)
+        context->dispatcher().waitIdle();
+}
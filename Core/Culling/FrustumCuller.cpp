@@ -0,0 +1,226 @@
+#include <Core/Culling/FrustumCuller.h>
+#include <Core/Profiling/Profiler.h>
+#include <Core/Utils/Simd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    using Core::Culling::Frustum;
+
+    // Pointers to the ten streams, in CullingSet::Stream order.
+    struct Soa {
+        const float* cx; const float* cy; const float* cz; const float* r;
+        const float* bx; const float* by; const float* bz;
+        const float* ex; const float* ey; const float* ez;
+    };
+
+    size_t cullScalar(Soa const& s, Frustum const& f, size_t begin, size_t end, uint32_t* out) {
+        size_t n = 0;
+        for (size_t i = begin; i < end; ++i) {
+            bool visible = true;
+            for (auto const& p : f.planes) {
+                const float sphere = p.nx * s.cx[i] + p.ny * s.cy[i] + p.nz * s.cz[i] + p.d + s.r[i];
+                const float box = p.nx * s.bx[i] + p.ny * s.by[i] + p.nz * s.bz[i] + p.d +
+                    std::abs(p.nx) * s.ex[i] + std::abs(p.ny) * s.ey[i] + std::abs(p.nz) * s.ez[i];
+                visible &= (sphere >= 0.0f) & (box >= 0.0f);
+            }
+            out[n] = static_cast<uint32_t>(i);
+            n += visible; // branchless append
+        }
+        return n;
+    }
+
+    // Appends base + i for every set bit of `mask`.
+    size_t appendLanes(uint32_t mask, size_t base, uint32_t* out) {
+        size_t n = 0;
+        while (mask) {
+            out[n++] = static_cast<uint32_t>(base + std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+        return n;
+    }
+
+#if CORE_SIMD_AVX2
+    size_t cullSimd(Soa const& s, Frustum const& f, size_t begin, size_t end, uint32_t* out) {
+        size_t n = 0, i = begin;
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= end; i += 8) {
+            const __m256 cx = _mm256_loadu_ps(s.cx + i), cy = _mm256_loadu_ps(s.cy + i);
+            const __m256 cz = _mm256_loadu_ps(s.cz + i), r = _mm256_loadu_ps(s.r + i);
+            const __m256 bx = _mm256_loadu_ps(s.bx + i), by = _mm256_loadu_ps(s.by + i);
+            const __m256 bz = _mm256_loadu_ps(s.bz + i), ex = _mm256_loadu_ps(s.ex + i);
+            const __m256 ey = _mm256_loadu_ps(s.ey + i), ez = _mm256_loadu_ps(s.ez + i);
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (auto const& p : f.planes) {
+                const __m256 nx = _mm256_set1_ps(p.nx), ny = _mm256_set1_ps(p.ny);
+                const __m256 nz = _mm256_set1_ps(p.nz), d = _mm256_set1_ps(p.d);
+                const __m256 sphere = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy)), _mm256_mul_ps(nz, cz)), d), r);
+                __m256 box = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(nx, bx), _mm256_mul_ps(ny, by)), _mm256_mul_ps(nz, bz)), d);
+                box = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(box,
+                    _mm256_mul_ps(_mm256_set1_ps(std::abs(p.nx)), ex)),
+                    _mm256_mul_ps(_mm256_set1_ps(std::abs(p.ny)), ey)),
+                    _mm256_mul_ps(_mm256_set1_ps(std::abs(p.nz)), ez));
+                visible = _mm256_and_ps(visible, _mm256_and_ps(
+                    _mm256_cmp_ps(sphere, zero, _CMP_GE_OQ), _mm256_cmp_ps(box, zero, _CMP_GE_OQ)));
+            }
+            n += appendLanes(static_cast<uint32_t>(_mm256_movemask_ps(visible)), i, out + n);
+        }
+        return n + cullScalar(s, f, i, end, out + n);
+    }
+#elif CORE_SIMD_SSE2
+    size_t cullSimd(Soa const& s, Frustum const& f, size_t begin, size_t end, uint32_t* out) {
+        size_t n = 0, i = begin;
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= end; i += 4) {
+            const __m128 cx = _mm_loadu_ps(s.cx + i), cy = _mm_loadu_ps(s.cy + i);
+            const __m128 cz = _mm_loadu_ps(s.cz + i), r = _mm_loadu_ps(s.r + i);
+            const __m128 bx = _mm_loadu_ps(s.bx + i), by = _mm_loadu_ps(s.by + i);
+            const __m128 bz = _mm_loadu_ps(s.bz + i), ex = _mm_loadu_ps(s.ex + i);
+            const __m128 ey = _mm_loadu_ps(s.ey + i), ez = _mm_loadu_ps(s.ez + i);
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (auto const& p : f.planes) {
+                const __m128 nx = _mm_set1_ps(p.nx), ny = _mm_set1_ps(p.ny);
+                const __m128 nz = _mm_set1_ps(p.nz), d = _mm_set1_ps(p.d);
+                const __m128 sphere = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)), d), r);
+                __m128 box = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, bx), _mm_mul_ps(ny, by)), _mm_mul_ps(nz, bz)), d);
+                box = _mm_add_ps(_mm_add_ps(_mm_add_ps(box,
+                    _mm_mul_ps(_mm_set1_ps(std::abs(p.nx)), ex)),
+                    _mm_mul_ps(_mm_set1_ps(std::abs(p.ny)), ey)),
+                    _mm_mul_ps(_mm_set1_ps(std::abs(p.nz)), ez));
+                visible = _mm_and_ps(visible,
+                    _mm_and_ps(_mm_cmpge_ps(sphere, zero), _mm_cmpge_ps(box, zero)));
+            }
+            n += appendLanes(static_cast<uint32_t>(_mm_movemask_ps(visible)), i, out + n);
+        }
+        return n + cullScalar(s, f, i, end, out + n);
+    }
+#elif CORE_SIMD_NEON
+    size_t cullSimd(Soa const& s, Frustum const& f, size_t begin, size_t end, uint32_t* out) {
+        size_t n = 0, i = begin;
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint32x4_t laneBits = { 1, 2, 4, 8 };
+        for (; i + 4 <= end; i += 4) {
+            const float32x4_t cx = vld1q_f32(s.cx + i), cy = vld1q_f32(s.cy + i);
+            const float32x4_t cz = vld1q_f32(s.cz + i), r = vld1q_f32(s.r + i);
+            const float32x4_t bx = vld1q_f32(s.bx + i), by = vld1q_f32(s.by + i);
+            const float32x4_t bz = vld1q_f32(s.bz + i), ex = vld1q_f32(s.ex + i);
+            const float32x4_t ey = vld1q_f32(s.ey + i), ez = vld1q_f32(s.ez + i);
+            uint32x4_t visible = vdupq_n_u32(~0u);
+            for (auto const& p : f.planes) {
+                float32x4_t sphere = vaddq_f32(vmulq_n_f32(cx, p.nx), vmulq_n_f32(cy, p.ny));
+                sphere = vaddq_f32(vaddq_f32(vaddq_f32(sphere, vmulq_n_f32(cz, p.nz)), vdupq_n_f32(p.d)), r);
+                float32x4_t box = vaddq_f32(vmulq_n_f32(bx, p.nx), vmulq_n_f32(by, p.ny));
+                box = vaddq_f32(vaddq_f32(box, vmulq_n_f32(bz, p.nz)), vdupq_n_f32(p.d));
+                box = vaddq_f32(vaddq_f32(vaddq_f32(box, vmulq_n_f32(ex, std::abs(p.nx))),
+                    vmulq_n_f32(ey, std::abs(p.ny))), vmulq_n_f32(ez, std::abs(p.nz)));
+                visible = vandq_u32(visible, vandq_u32(vcgeq_f32(sphere, zero), vcgeq_f32(box, zero)));
+            }
+            n += appendLanes(vaddvq_u32(vandq_u32(visible, laneBits)), i, out + n);
+        }
+        return n + cullScalar(s, f, i, end, out + n);
+    }
+#else
+    size_t cullSimd(Soa const& s, Frustum const& f, size_t begin, size_t end, uint32_t* out) {
+        return cullScalar(s, f, begin, end, out);
+    }
+#endif
+
+} // namespace
+
+Core::Culling::Frustum Core::Culling::Frustum::fromViewProjection(const float m[16]) {
+    // Gribb/Hartmann: clip-space inequalities as combinations of the rows
+    const auto row = [m] (int r) { return std::array<float, 4>{ m[r], m[4 + r], m[8 + r], m[12 + r] }; };
+    const auto r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+    const auto plane = [] (std::array<float, 4> a, std::array<float, 4> b, float sign) {
+        Plane p{ a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2], a[3] + sign * b[3] };
+        const float len = std::sqrt(p.nx * p.nx + p.ny * p.ny + p.nz * p.nz);
+        if (len > 0.0f) { p.nx /= len; p.ny /= len; p.nz /= len; p.d /= len; }
+        return p;
+    };
+    constexpr std::array<float, 4> none{};
+    Frustum f;
+    f.planes = {
+        plane(r3, r0, 1.0f),   // -w <= x
+        plane(r3, r0, -1.0f),  //  x <= w
+        plane(r3, r1, 1.0f),   // -w <= y
+        plane(r3, r1, -1.0f),  //  y <= w
+        plane(r2, none, 0.0f), //  0 <= z
+        plane(r3, r2, -1.0f),  //  z <= w
+    };
+    return f;
+}
+
+uint32_t Core::Culling::CullingSet::add(Geometry::Bounds const& bounds) {
+    const auto index = static_cast<uint32_t>(count_++);
+    for (auto& stream : streams_)
+        stream.push_back(0.0f);
+    set(index, bounds);
+    return index;
+}
+
+void Core::Culling::CullingSet::set(uint32_t index, Geometry::Bounds const& b) {
+    if (index >= count_)
+        throw std::out_of_range("CullingSet::set: index out of range");
+    streams_[CenterX][index] = b.center[0];
+    streams_[CenterY][index] = b.center[1];
+    streams_[CenterZ][index] = b.center[2];
+    streams_[Radius][index] = b.radius;
+    streams_[BoxX][index] = 0.5f * (b.min[0] + b.max[0]);
+    streams_[BoxY][index] = 0.5f * (b.min[1] + b.max[1]);
+    streams_[BoxZ][index] = 0.5f * (b.min[2] + b.max[2]);
+    streams_[ExtentX][index] = 0.5f * (b.max[0] - b.min[0]);
+    streams_[ExtentY][index] = 0.5f * (b.max[1] - b.min[1]);
+    streams_[ExtentZ][index] = 0.5f * (b.max[2] - b.min[2]);
+}
+
+void Core::Culling::CullingSet::reserve(size_t count) {
+    for (auto& stream : streams_)
+        stream.reserve(count);
+}
+
+void Core::Culling::CullingSet::clear() {
+    for (auto& stream : streams_)
+        stream.clear();
+    count_ = 0;
+}
+
+void Core::Culling::CullingSet::cull(Frustum const& frustum, std::vector<uint32_t>& visible,
+    ThreadPool* pool, CullKernel kernel) const {
+    CORE_PROFILE_ZONE("CullingSet::cull");
+    const Soa soa{
+        streams_[CenterX].data(), streams_[CenterY].data(), streams_[CenterZ].data(),
+        streams_[Radius].data(),
+        streams_[BoxX].data(), streams_[BoxY].data(), streams_[BoxZ].data(),
+        streams_[ExtentX].data(), streams_[ExtentY].data(), streams_[ExtentZ].data() };
+    const auto run = kernel == CullKernel::Scalar ? cullScalar : cullSimd;
+
+    // worst case everything is visible; every chunk writes at its own offset
+    visible.resize(count_);
+    if (!pool || count_ <= kChunk) {
+        visible.resize(run(soa, frustum, 0, count_, visible.data()));
+        return;
+    }
+
+    const size_t chunks = (count_ + kChunk - 1) / kChunk;
+    std::vector<size_t> counts(chunks);
+    pool->parallelFor(count_, kChunk, [&] (size_t begin, size_t end) {
+        counts[begin / kChunk] = run(soa, frustum, begin, end, visible.data() + begin);
+    });
+
+    // compact: chunk c's results move down to the end of chunk c-1's
+    size_t n = counts[0];
+    for (size_t c = 1; c < chunks; ++c) {
+        std::memmove(visible.data() + n, visible.data() + c * kChunk, counts[c] * sizeof(uint32_t));
+        n += counts[c];
+    }
+    visible.resize(n);
+}
@@ -0,0 +1,235 @@
+#include <Core/Culling/GpuCuller.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    Core::Shaders::ShaderHandle loadCullShader(Core::Shaders::ShaderLoader& shaders,
+        std::filesystem::path const& shaderDir, bool hiZ) {
+        const auto path = std::filesystem::weakly_canonical(shaderDir / "cull_instances.comp").string();
+        return hiZ
+            ? shaders.get(Core::Shaders::ShaderKey(path, Core::Shaders::Stage::Compute, "main", { "HI_Z" }))
+            : shaders.get(Core::Shaders::ShaderKey(path, Core::Shaders::Stage::Compute, "main", uint64_t{ 0 }));
+    }
+
+    void memoryBarrier(vk::raii::CommandBuffer& cmd,
+        vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess,
+        vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess) {
+        const vk::MemoryBarrier2 barrier{
+            .srcStageMask = srcStage, .srcAccessMask = srcAccess,
+            .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+        cmd.pipelineBarrier2(vk::DependencyInfo{
+            .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+    }
+
+    constexpr size_t kMinCapacity = 256;
+
+} // namespace
+
+Core::Culling::GpuInstance Core::Culling::GpuInstance::from(Geometry::Bounds const& bounds,
+    uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceId) {
+    GpuInstance out{};
+    for (int i = 0; i < 3; ++i) {
+        out.center[i] = bounds.center[i];
+        out.boxCenter[i] = 0.5f * (bounds.min[i] + bounds.max[i]);
+        out.boxExtent[i] = 0.5f * (bounds.max[i] - bounds.min[i]);
+    }
+    out.radius = bounds.radius;
+    out.indexCount = indexCount;
+    out.firstIndex = firstIndex;
+    out.vertexOffset = vertexOffset;
+    out.instanceId = instanceId;
+    return out;
+}
+
+Core::Culling::GpuCuller::GpuCuller(Device& device, Shaders::ShaderLoader& shaders,
+    uint32_t framesInFlight, std::filesystem::path const& shaderDir)
+    : device_(&device),
+      frustumPipeline_(device, loadCullShader(shaders, shaderDir, false)),
+      hiZPipeline_(device, loadCullShader(shaders, shaderDir, true)),
+      staging_(framesInFlight),
+      framesInFlight_(framesInFlight) {
+    if (!device.drawIndirectCountEnabled())
+        throw std::runtime_error("GpuCuller: device does not support drawIndirectCount");
+
+    auto& dev = device.vkDevice();
+    const std::array poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eUniformBuffer, 2 * framesInFlight },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, 6 * framesInFlight },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, framesInFlight } };
+    pool_ = vk::raii::DescriptorPool(dev, vk::DescriptorPoolCreateInfo{
+        .maxSets = 2 * framesInFlight,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data() },
+        Memory::hostCallbacks(Memory::HostTag::Pipeline));
+
+    const auto allocate = [&] (Compute::ComputePipeline const& pipeline,
+                              std::vector<vk::DescriptorSet>& out) {
+        const std::vector<vk::DescriptorSetLayout> layouts(framesInFlight,
+            *pipeline.setLayouts().at(0));
+        for (auto& set : dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+                 .descriptorPool = *pool_,
+                 .descriptorSetCount = framesInFlight,
+                 .pSetLayouts = layouts.data() }))
+            out.push_back(set.release());
+    };
+    allocate(frustumPipeline_, frustumSets_);
+    allocate(hiZPipeline_, hiZSets_);
+
+    count_ = Memory::Buffer(device, sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+        vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    grow(kMinCapacity);
+}
+
+uint32_t Core::Culling::GpuCuller::add(GpuInstance const& instance) {
+    const auto index = static_cast<uint32_t>(instances_.size());
+    instances_.push_back(instance);
+    if (dirtyBegin_ == dirtyEnd_)
+        dirtyBegin_ = index;
+    dirtyEnd_ = index + 1;
+    return index;
+}
+
+void Core::Culling::GpuCuller::set(uint32_t index, GpuInstance const& instance) {
+    instances_.at(index) = instance;
+    if (dirtyBegin_ == dirtyEnd_) {
+        dirtyBegin_ = index;
+        dirtyEnd_ = index + 1;
+    } else {
+        dirtyBegin_ = std::min<size_t>(dirtyBegin_, index);
+        dirtyEnd_ = std::max<size_t>(dirtyEnd_, index + 1);
+    }
+}
+
+void Core::Culling::GpuCuller::reserve(size_t count) {
+    instances_.reserve(count);
+}
+
+void Core::Culling::GpuCuller::clear() {
+    instances_.clear();
+    dirtyBegin_ = dirtyEnd_ = 0;
+}
+
+void Core::Culling::GpuCuller::grow(size_t capacity) {
+    if (!instanceBuffer_.empty())
+        retired_.push_back({ std::move(instanceBuffer_), std::move(draws_),
+            records_ + framesInFlight_ - 1 });
+
+    capacity_ = capacity;
+    instanceBuffer_ = Memory::Buffer(*device_, capacity * sizeof(GpuInstance),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    draws_ = Memory::Buffer(*device_, capacity * kDrawStride,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    // the new buffer starts out empty
+    dirtyBegin_ = 0;
+    dirtyEnd_ = instances_.size();
+}
+
+void Core::Culling::GpuCuller::releaseRetired() {
+    std::erase_if(retired_, [this] (Retired const& r) { return records_ >= r.releaseAt; });
+}
+
+void Core::Culling::GpuCuller::record(vk::raii::CommandBuffer& cmd,
+    Memory::FrameAllocator& frameAllocator, Frustum const& frustum,
+    const float occlusionViewProj[16], HiZPyramid const* hiZ) {
+    CORE_PROFILE_ZONE("GpuCuller::record");
+    if (frameAllocator.framesInFlight() != framesInFlight_)
+        throw std::runtime_error("GpuCuller: frame allocator has a different frame count");
+    if (hiZ && !occlusionViewProj)
+        throw std::runtime_error("GpuCuller: Hi-Z culling needs the occlusion view-projection");
+
+    // beginFrame() has retired the frame that last used this slot
+    releaseRetired();
+    const uint32_t slot = frameAllocator.currentSlot();
+    if (instances_.size() > capacity_)
+        grow(std::max(instances_.size(), capacity_ * 2));
+
+    // the previous frame may still consume draws / read instances
+    memoryBarrier(cmd,
+        vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eComputeShader, {},
+        vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eComputeShader, {});
+
+    cmd.fillBuffer(count_.handle(), 0, sizeof(uint32_t), 0);
+    if (dirtyBegin_ < dirtyEnd_) {
+        const vk::DeviceSize offset = dirtyBegin_ * sizeof(GpuInstance);
+        const vk::DeviceSize bytes = (dirtyEnd_ - dirtyBegin_) * sizeof(GpuInstance);
+        auto& staging = staging_[slot];
+        if (staging.size() < bytes)
+            staging = Memory::Buffer(*device_, std::max<vk::DeviceSize>(bytes, staging.size() * 2),
+                vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        std::memcpy(staging.mapped(), instances_.data() + dirtyBegin_, bytes);
+        cmd.copyBuffer(staging.handle(), instanceBuffer_.handle(),
+            vk::BufferCopy{ .srcOffset = 0, .dstOffset = offset, .size = bytes });
+        dirtyBegin_ = dirtyEnd_ = 0;
+    }
+    memoryBarrier(cmd,
+        vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+
+    GpuCullParams params{};
+    std::copy(frustum.planes.begin(), frustum.planes.end(), params.planes);
+    if (occlusionViewProj)
+        std::memcpy(params.viewProj, occlusionViewProj, sizeof(params.viewProj));
+    if (hiZ) {
+        params.hiZSize[0] = static_cast<float>(hiZ->extent().width);
+        params.hiZSize[1] = static_cast<float>(hiZ->extent().height);
+        params.hiZMips = hiZ->mipLevels();
+    }
+    params.instanceCount = static_cast<uint32_t>(instances_.size());
+    const auto paramsAlloc = frameAllocator.push(params);
+    if (!paramsAlloc)
+        throw std::runtime_error("GpuCuller: frame allocator is full");
+
+    // the set was last used by this slot's previous frame, which has retired
+    auto const& pipeline = hiZ ? hiZPipeline_ : frustumPipeline_;
+    const vk::DescriptorSet set = hiZ ? hiZSets_[slot] : frustumSets_[slot];
+    const vk::DescriptorBufferInfo paramsInfo{ paramsAlloc.buffer, paramsAlloc.dynamicOffset,
+        sizeof(GpuCullParams) };
+    const std::array<vk::DescriptorBufferInfo, 3> storageInfos{ {
+        { instanceBuffer_.handle(), 0, vk::WholeSize },
+        { draws_.handle(), 0, vk::WholeSize },
+        { count_.handle(), 0, vk::WholeSize } } };
+    std::vector<vk::WriteDescriptorSet> writes{
+        { .dstSet = set, .dstBinding = 0, .descriptorCount = 1,
+          .descriptorType = vk::DescriptorType::eUniformBuffer, .pBufferInfo = &paramsInfo },
+        { .dstSet = set, .dstBinding = 1, .descriptorCount = 3,
+          .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = storageInfos.data() } };
+    vk::DescriptorImageInfo hiZInfo{};
+    if (hiZ) {
+        hiZInfo = { hiZ->sampler(), hiZ->view(), vk::ImageLayout::eGeneral };
+        writes.push_back({ .dstSet = set, .dstBinding = 4, .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler, .pImageInfo = &hiZInfo });
+    }
+    device_->vkDevice().updateDescriptorSets(writes, nullptr);
+
+    if (!instances_.empty()) {
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.handle());
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline.layout(), 0, set, nullptr);
+        cmd.dispatch(pipeline.groupsFor(params.instanceCount), 1, 1);
+    }
+
+    memoryBarrier(cmd,
+        vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead);
+    ++records_;
+}
+
+void Core::Culling::GpuCuller::draw(vk::raii::CommandBuffer& cmd) const {
+    if (instances_.empty())
+        return;
+    cmd.drawIndexedIndirectCount(draws_.handle(), 0, count_.handle(), 0,
+        static_cast<uint32_t>(instances_.size()), kDrawStride);
+}
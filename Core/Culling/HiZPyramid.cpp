@@ -0,0 +1,133 @@
+#include <Core/Culling/HiZPyramid.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <array>
+
+namespace {
+
+    Core::Shaders::ShaderHandle loadReduceShader(Core::Shaders::ShaderLoader& shaders,
+        std::filesystem::path const& shaderDir) {
+        return shaders.get(Core::Shaders::ShaderKey(
+            std::filesystem::weakly_canonical(shaderDir / "hiz_reduce.comp").string(),
+            Core::Shaders::Stage::Compute, "main", uint64_t{ 0 }));
+    }
+
+    struct ReducePush {
+        uint32_t srcSize[2];
+        uint32_t dstSize[2];
+    };
+
+} // namespace
+
+Core::Culling::HiZPyramid::HiZPyramid(Device& device, Shaders::ShaderLoader& shaders,
+    vk::ImageView depth, vk::ImageLayout depthLayout, vk::Extent2D extent,
+    std::filesystem::path const& shaderDir)
+    : image_(device, vk::Format::eR32Sfloat, extent, Memory::Image::fullMipCount(extent),
+          vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled),
+      pipeline_(device, loadReduceShader(shaders, shaderDir)) {
+    auto& dev = device.vkDevice();
+    const auto* callbacks = Memory::hostCallbacks(Memory::HostTag::Pipeline);
+    const uint32_t mips = image_.mipLevels();
+
+    // texelFetch ignores filtering; the sampler only completes the descriptor
+    sampler_ = vk::raii::Sampler(dev, vk::SamplerCreateInfo{
+        .magFilter = vk::Filter::eNearest,
+        .minFilter = vk::Filter::eNearest,
+        .mipmapMode = vk::SamplerMipmapMode::eNearest,
+        .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+        .maxLod = vk::LodClampNone }, callbacks);
+
+    for (uint32_t mip = 0; mip < mips; ++mip)
+        mipViews_.emplace_back(dev, vk::ImageViewCreateInfo{
+            .image = image_.handle(),
+            .viewType = vk::ImageViewType::e2D,
+            .format = image_.format(),
+            .subresourceRange = image_.range(mip, 1) },
+            Memory::hostCallbacks(Memory::HostTag::Memory));
+
+    const std::array poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, mips },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageImage, mips } };
+    pool_ = vk::raii::DescriptorPool(dev, vk::DescriptorPoolCreateInfo{
+        .maxSets = mips,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data() }, callbacks);
+
+    const std::vector<vk::DescriptorSetLayout> layouts(mips, *pipeline_.setLayouts().at(0));
+    for (auto& set : dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+             .descriptorPool = *pool_,
+             .descriptorSetCount = mips,
+             .pSetLayouts = layouts.data() }))
+        sets_.push_back(set.release());
+
+    // each mip reads the one above it; mip 0 reads the depth buffer
+    std::vector<vk::DescriptorImageInfo> infos;
+    infos.reserve(mips * 2);
+    std::vector<vk::WriteDescriptorSet> writes;
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        infos.push_back({ *sampler_, mip == 0 ? depth : *mipViews_[mip - 1],
+            mip == 0 ? depthLayout : vk::ImageLayout::eGeneral });
+        writes.push_back(vk::WriteDescriptorSet{
+            .dstSet = sets_[mip],
+            .dstBinding = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .pImageInfo = &infos.back() });
+        infos.push_back({ nullptr, *mipViews_[mip], vk::ImageLayout::eGeneral });
+        writes.push_back(vk::WriteDescriptorSet{
+            .dstSet = sets_[mip],
+            .dstBinding = 1,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageImage,
+            .pImageInfo = &infos.back() });
+    }
+    dev.updateDescriptorSets(writes, nullptr);
+}
+
+void Core::Culling::HiZPyramid::build(vk::raii::CommandBuffer& cmd) {
+    CORE_PROFILE_ZONE("HiZPyramid::build");
+
+    // first use: discard; afterwards: last frame's culling reads come first
+    const vk::ImageMemoryBarrier2 toGeneral{
+        .srcStageMask = initialized_ ? vk::PipelineStageFlagBits2::eComputeShader
+                                     : vk::PipelineStageFlagBits2::eNone,
+        .srcAccessMask = {},
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .oldLayout = initialized_ ? vk::ImageLayout::eGeneral : vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .image = image_.handle(),
+        .subresourceRange = image_.range() };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toGeneral });
+    initialized_ = true;
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_.handle());
+    for (uint32_t mip = 0; mip < image_.mipLevels(); ++mip) {
+        const vk::Extent2D src = mip == 0 ? image_.extent() : image_.mipExtent(mip - 1);
+        const vk::Extent2D dst = image_.mipExtent(mip);
+        const ReducePush push{ { src.width, src.height }, { dst.width, dst.height } };
+
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_.layout(), 0,
+            sets_[mip], nullptr);
+        cmd.pushConstants<ReducePush>(pipeline_.layout(), vk::ShaderStageFlagBits::eCompute,
+            0, push);
+        cmd.dispatch((dst.width + 7) / 8, (dst.height + 7) / 8, 1);
+
+        // the next mip (or the culling pass) samples this one
+        const vk::ImageMemoryBarrier2 written{
+            .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+            .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+            .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .image = image_.handle(),
+            .subresourceRange = image_.range(mip, 1) };
+        cmd.pipelineBarrier2(vk::DependencyInfo{
+            .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &written });
+    }
+}
@@ -0,0 +1,221 @@
+#include <Core/Debug/DebugMessageSink.h>
+#include <Core/Utils/Hash/Hash.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+    int64_t steadyNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void copyTruncated(char* dst, size_t capacity, const char* src) {
+        if (!src) { dst[0] = '\0'; return; }
+        const size_t n = std::min(std::strlen(src), capacity - 1);
+        std::memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+
+} // namespace
+
+Core::Debug::DebugMessageSink::DebugMessageSink(DebugMessageConfig config, std::ostream* out)
+    : config_(config), out_(out ? out : &std::cerr),
+      counters_(std::make_unique<Counter[]>(kCounters)),
+      ring_(std::make_unique<Cell[]>(kRing)) {
+    for (size_t i = 0; i < kRing; ++i)
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    worker_ = std::thread([this] { run(); });
+}
+
+Core::Debug::DebugMessageSink::~DebugMessageSink() {
+    stop_.store(true, std::memory_order_release);
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_one();
+    worker_.join();
+}
+
+vk::DebugUtilsMessengerCreateInfoEXT Core::Debug::DebugMessageSink::createInfo() {
+    return vk::DebugUtilsMessengerCreateInfoEXT{
+        .messageSeverity = config_.severities,
+        .messageType = config_.types,
+        .pfnUserCallback = &callback,
+        .pUserData = this };
+}
+
+VKAPI_ATTR vk::Bool32 VKAPI_CALL Core::Debug::DebugMessageSink::callback(
+    vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
+    vk::DebugUtilsMessageTypeFlagsEXT type,
+    const vk::DebugUtilsMessengerCallbackDataEXT* data, void* user) {
+    auto* self = static_cast<DebugMessageSink*>(user);
+    self->total_.fetch_add(1, std::memory_order_relaxed);
+
+    // some layers report everything as id 0; tell those apart by name
+    int32_t id = data->messageIdNumber;
+    if (id == 0 && data->pMessageIdName)
+        id = static_cast<int32_t>(Hash::fnv1a(data->pMessageIdName,
+            std::strlen(data->pMessageIdName)));
+
+    Counter* c = self->counter(id);
+    uint64_t occurrence = 1;
+    uint64_t suppressed = 0;
+    if (c) {
+        occurrence = c->count.fetch_add(1, std::memory_order_relaxed) + 1;
+        c->severity.fetch_or(static_cast<uint32_t>(severity), std::memory_order_relaxed);
+        if (!self->admit(*c, occurrence, suppressed))
+            return vk::False;
+    }
+
+    Message m;
+    m.id = id;
+    m.severity = static_cast<uint32_t>(severity);
+    m.type = static_cast<uint32_t>(type);
+    m.occurrence = occurrence;
+    m.suppressedBefore = suppressed;
+    copyTruncated(m.name, sizeof(m.name), data->pMessageIdName);
+    copyTruncated(m.text, sizeof(m.text), data->pMessage);
+    if (!self->push(m))
+        self->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return vk::False;
+}
+
+Core::Debug::DebugMessageSink::Counter* Core::Debug::DebugMessageSink::counter(int32_t id) {
+    const uint64_t key = static_cast<uint32_t>(id) | kUsed;
+    size_t index = static_cast<size_t>(Hash::combine64(0, key)) & (kCounters - 1);
+    for (size_t probe = 0; probe < kCounters; ++probe, index = (index + 1) & (kCounters - 1)) {
+        Counter& c = counters_[index];
+        uint64_t current = c.key.load(std::memory_order_acquire);
+        if (current == key)
+            return &c;
+        if (current == 0 && c.key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+            return &c;
+        if (current == key) // lost the race to the same id
+            return &c;
+    }
+    return nullptr; // table full: no dedup for this id
+}
+
+bool Core::Debug::DebugMessageSink::admit(Counter& c, uint64_t occurrence, uint64_t& suppressed) {
+    const int64_t now = steadyNs();
+    if (occurrence > config_.burst) {
+        const int64_t interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            config_.interval).count();
+        int64_t last = c.lastPrintNs.load(std::memory_order_relaxed);
+        if (now - last < interval ||
+            !c.lastPrintNs.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            return false;
+    } else {
+        c.lastPrintNs.store(now, std::memory_order_relaxed);
+    }
+    const uint64_t previous = c.lastPrinted.exchange(occurrence, std::memory_order_relaxed);
+    suppressed = occurrence > previous + 1 ? occurrence - previous - 1 : 0;
+    c.printed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Bounded MPMC queue (Vyukov): each cell's sequence says whose turn it is.
+bool Core::Debug::DebugMessageSink::push(Message const& m) {
+    uint64_t pos = enqueue_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = ring_[pos & (kRing - 1)];
+        const uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.message = m;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                queued_.fetch_add(1, std::memory_order_relaxed);
+                wake_.fetch_add(1, std::memory_order_release);
+                wake_.notify_one();
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Core::Debug::DebugMessageSink::pop(Message& m) {
+    // single consumer: the worker thread
+    const uint64_t pos = dequeue_.load(std::memory_order_relaxed);
+    Cell& cell = ring_[pos & (kRing - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+    m = cell.message;
+    cell.sequence.store(pos + kRing, std::memory_order_release);
+    dequeue_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void Core::Debug::DebugMessageSink::run() {
+    Message m;
+    for (;;) {
+        // read before draining: a push after this changes it, so the wait
+        // below can't miss it
+        const uint32_t wake = wake_.load(std::memory_order_acquire);
+        bool any = false;
+        while (pop(m)) {
+            write(m);
+            any = true;
+            written_.fetch_add(1, std::memory_order_release);
+        }
+        if (any) {
+            out_->flush(); // once per batch, not per message
+            written_.notify_all();
+        } else if (stop_.load(std::memory_order_acquire)) {
+            return;
+        } else {
+            wake_.wait(wake, std::memory_order_acquire); // no timer: idle means asleep
+        }
+    }
+}
+
+void Core::Debug::DebugMessageSink::write(Message const& m) {
+    {
+        std::lock_guard lock(namesMutex_);
+        names_.try_emplace(m.id, m.name);
+    }
+    const auto severity = static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(m.severity);
+    std::ostream& os = *out_;
+    os << "validation layer: " << vk::to_string(severity) << ' '
+       << vk::to_string(static_cast<vk::DebugUtilsMessageTypeFlagsEXT>(m.type))
+       << " [" << m.name << "] #" << m.occurrence;
+    if (m.suppressedBefore)
+        os << " (" << m.suppressedBefore << " repeats suppressed)";
+    os << ": " << m.text << '\n';
+}
+
+void Core::Debug::DebugMessageSink::flush() {
+    const uint64_t target = queued_.load(std::memory_order_acquire);
+    for (uint64_t written; (written = written_.load(std::memory_order_acquire)) < target;)
+        written_.wait(written, std::memory_order_acquire);
+}
+
+std::vector<Core::Debug::DebugMessageStats> Core::Debug::DebugMessageSink::stats() const {
+    std::vector<DebugMessageStats> result;
+    std::lock_guard lock(namesMutex_);
+    for (size_t i = 0; i < kCounters; ++i) {
+        const Counter& c = counters_[i];
+        const uint64_t key = c.key.load(std::memory_order_acquire);
+        if (key == 0)
+            continue;
+        DebugMessageStats s;
+        s.id = static_cast<int32_t>(static_cast<uint32_t>(key));
+        if (auto it = names_.find(s.id); it != names_.end())
+            s.name = it->second;
+        s.count = c.count.load(std::memory_order_relaxed);
+        s.printed = c.printed.load(std::memory_order_relaxed);
+        // highest severity bit seen
+        const uint32_t bits = c.severity.load(std::memory_order_relaxed);
+        for (uint32_t bit = 1u << 31; bit; bit >>= 1)
+            if (bits & bit) { s.severity = static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(bit); break; }
+        result.push_back(std::move(s));
+    }
+    std::sort(result.begin(), result.end(),
+        [] (auto const& a, auto const& b) { return a.count > b.count; });
+    return result;
+}
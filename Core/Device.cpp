@@ -1,11 +1,35 @@
 #include <Core/Device.h>
+#include <Core/Memory/HostAllocator.h>
 
+#include <algorithm>
 #include <cstring>
+#include <future>
 #include <ranges>
 #include <stdexcept>
 #include <vulkan/vulkan_core.h>
 #include <vulkan/vulkan_raii.hpp>
 
+namespace {
+
+// one queue per distinct family; `priority` must outlive device creation
+std::vector<vk::DeviceQueueCreateInfo>
+queueCreateInfos(std::vector<uint32_t> families, float const &priority) {
+  std::ranges::sort(families);
+  const auto [first, last] = std::ranges::unique(families);
+  families.erase(first, last);
+  std::vector<vk::DeviceQueueCreateInfo> infos;
+  for (uint32_t family : families) {
+    if (family == UINT32_MAX)
+      continue;
+    infos.push_back({.queueFamilyIndex = family,
+                     .queueCount = 1,
+                     .pQueuePriorities = &priority});
+  }
+  return infos;
+}
+
+} // namespace
+
 Core::Device::Device(vk::raii::Instance &instance, vk::raii::SurfaceKHR &surface,
                uint32_t apiVersion)
     : instance_(&instance), surface_(&surface), apiVersion_(apiVersion) {
@@ -13,22 +37,87 @@ Core::Device::Device(vk::raii::Instance &instance, vk::raii::SurfaceKHR &surface
   createLogical();
 }
 
+Core::Device::Device(vk::raii::Instance &instance,
+                     vk::raii::SurfaceKHR &surface,
+                     vk::raii::PhysicalDevice physical, uint32_t apiVersion)
+    : instance_(&instance), surface_(&surface),
+      physicalDevice(std::move(physical)), apiVersion_(apiVersion) {
+  properties_ = physicalDevice.getProperties();
+  memoryProperties_ = physicalDevice.getMemoryProperties();
+  createLogical();
+}
+
+Core::Device::Device(vk::raii::Instance &instance, uint32_t apiVersion)
+    : instance_(&instance), apiVersion_(apiVersion) {
+  pickPhysical();
+  createHeadless();
+}
+
+Core::Device::Device(vk::raii::Instance &instance,
+                     vk::raii::PhysicalDevice physical, uint32_t apiVersion)
+    : instance_(&instance), physicalDevice(std::move(physical)),
+      apiVersion_(apiVersion) {
+  properties_ = physicalDevice.getProperties();
+  memoryProperties_ = physicalDevice.getMemoryProperties();
+  createHeadless();
+}
+
 void Core::Device::pickPhysical() {
-  std::vector<vk::raii::PhysicalDevice> devices =
-      instance_->enumeratePhysicalDevices();
-  const auto devIter = std::ranges::find_if(
-      devices, [&](auto const &device) { return isSuitable(device); });
-  if (devIter != devices.end()) {
-    physicalDevice = *devIter;
-  } else {
+  physicalDevice = selectPhysical(*instance_, headless());
+  properties_ = physicalDevice.getProperties();
+  memoryProperties_ = physicalDevice.getMemoryProperties();
+}
+
+vk::raii::PhysicalDevice
+Core::Device::selectPhysical(vk::raii::Instance &instance, bool headless) {
+  auto suitable = selectAllPhysical(instance, headless);
+  if (suitable.empty())
     throw std::runtime_error("failed to find a suitable GPU!");
+  return std::move(suitable.front());
+}
+
+std::vector<vk::raii::PhysicalDevice>
+Core::Device::selectAllPhysical(vk::raii::Instance &instance, bool headless) {
+  std::vector<vk::raii::PhysicalDevice> devices =
+      instance.enumeratePhysicalDevices();
+
+  // isSuitable enumerates every extension and feature chain; on multi-GPU
+  // machines (and with software implementations installed) that adds up
+  std::vector<std::future<bool>> suitable;
+  suitable.reserve(devices.size());
+  for (auto const &dev : devices) {
+    suitable.push_back(std::async(devices.size() > 1 ? std::launch::async
+                                                     : std::launch::deferred,
+                                  [&dev, headless] {
+                                    return isSuitable(dev, headless);
+                                  }));
+  }
+  std::vector<vk::raii::PhysicalDevice> out;
+  for (size_t i = 0; i < devices.size(); ++i) {
+    if (suitable[i].get())
+      out.push_back(std::move(devices[i]));
   }
+  return out;
 }
 
-bool Core::Device::isSuitable(vk::raii::PhysicalDevice const &dev) const {
+bool Core::Device::isSuitable(vk::raii::PhysicalDevice const &dev,
+                              bool headless) {
   // Check if the device supports the Vulkan 1.3 API version
   bool supportsVulkan1_3 = dev.getProperties().apiVersion >= VK_API_VERSION_1_3;
 
+  if (headless) {
+    // compute only: no swapchain, no dynamic rendering
+    auto features = dev.template getFeatures2<
+        vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features,
+        vk::PhysicalDeviceVulkan13Features>();
+    return supportsVulkan1_3 &&
+           findComputeFamily(dev.getQueueFamilyProperties()) != UINT32_MAX &&
+           features.template get<vk::PhysicalDeviceVulkan12Features>()
+               .timelineSemaphore &&
+           features.template get<vk::PhysicalDeviceVulkan13Features>()
+               .synchronization2;
+  }
+
   // Check if any of the queue families support graphics operations
   auto queueFamilies = dev.getQueueFamilyProperties();
   bool supportsGraphics =
@@ -41,18 +130,20 @@ bool Core::Device::isSuitable(vk::raii::PhysicalDevice const &dev) const {
   bool supportsAllRequiredExtensions = std::ranges::all_of(
       requiredDeviceExtension,
       [&availableDeviceExtensions](auto const &requiredDeviceExtension) {
-        return std::ranges::any_of(
-            availableDeviceExtensions,
-            [requiredDeviceExtension](auto const &availableDeviceExtension) {
-              return strcmp(availableDeviceExtension.extensionName,
-                            requiredDeviceExtension) == 0;
-            });
+        return hasExtension(availableDeviceExtensions, requiredDeviceExtension);
       });
 
   auto features = dev.template getFeatures2<
-      vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features,
+      vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features,
+      vk::PhysicalDeviceVulkan13Features,
       vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+  auto const &vulkan12Features =
+      features.template get<vk::PhysicalDeviceVulkan12Features>();
   bool supportsRequiredFeatures =
+      vulkan12Features.timelineSemaphore &&
+      vulkan12Features.bufferDeviceAddress &&
+      features.template get<vk::PhysicalDeviceVulkan13Features>()
+          .synchronization2 &&
       features.template get<vk::PhysicalDeviceVulkan13Features>()
           .dynamicRendering &&
       features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>()
@@ -117,35 +208,167 @@ void Core::Device::createLogical() {
         "Could not find a queue for graphics or present -> terminating");
   }
 
+  // optional: present id / present wait for frame pacing
+  std::vector<const char *> enabledExtensions = requiredDeviceExtension;
+  auto availableExtensions = physicalDevice.enumerateDeviceExtensionProperties();
+  vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures;
+  vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures;
+  if (hasExtension(availableExtensions, vk::KHRPresentIdExtensionName) &&
+      hasExtension(availableExtensions, vk::KHRPresentWaitExtensionName)) {
+    auto presentFeatures = physicalDevice.template getFeatures2<
+        vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR,
+        vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    presentWait_ =
+        presentFeatures.template get<vk::PhysicalDevicePresentIdFeaturesKHR>()
+            .presentId &&
+        presentFeatures.template get<vk::PhysicalDevicePresentWaitFeaturesKHR>()
+            .presentWait;
+  }
+  if (presentWait_) {
+    enabledExtensions.push_back(vk::KHRPresentIdExtensionName);
+    enabledExtensions.push_back(vk::KHRPresentWaitExtensionName);
+    presentIdFeatures.presentId = vk::True;
+    presentWaitFeatures.presentWait = vk::True;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+  }
+
   // query for Vulkan 1.3 features
   auto features = physicalDevice.getFeatures2();
+  auto supported12 = physicalDevice.template getFeatures2<
+      vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+  vk::PhysicalDeviceVulkan12Features vulkan12Features;
   vk::PhysicalDeviceVulkan13Features vulkan13Features;
   vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT
       extendedDynamicStateFeatures;
+  // timeline semaphores drive per-frame resource retirement, device addresses
+  // are handed out by the frame allocator
+  vulkan12Features.timelineSemaphore = vk::True;
+  vulkan12Features.bufferDeviceAddress = vk::True;
+  // GPU-driven draws take their count from a buffer when available
+  drawIndirectCount_ =
+      supported12.template get<vk::PhysicalDeviceVulkan12Features>()
+          .drawIndirectCount;
+  vulkan12Features.drawIndirectCount = drawIndirectCount_;
   vulkan13Features.dynamicRendering = vk::True;
+  vulkan13Features.synchronization2 = vk::True;
   extendedDynamicStateFeatures.extendedDynamicState = vk::True;
+  extendedDynamicStateFeatures.pNext =
+      presentWait_ ? &presentIdFeatures : nullptr;
   vulkan13Features.pNext = &extendedDynamicStateFeatures;
-  features.pNext = &vulkan13Features;
+  vulkan12Features.pNext = &vulkan13Features;
+  features.pNext = &vulkan12Features;
 
   // create a Device
   float queuePriority = 0.0f;
-
-  vk::DeviceQueueCreateInfo deviceQueueCreateInfo{
-      .queueFamilyIndex = graphicsIndex,
-      .queueCount = 1,
-      .pQueuePriorities = &queuePriority};
+  const uint32_t computeIndex = findComputeFamily(queueFamilyProperties);
+  auto deviceQueueCreateInfos = queueCreateInfos(
+      {graphicsIndex, presentIndex, computeIndex}, queuePriority);
 
   vk::DeviceCreateInfo deviceCreateInfo{
       .pNext = &features,
-      .queueCreateInfoCount = 1,
-      .pQueueCreateInfos = &deviceQueueCreateInfo,
+      .queueCreateInfoCount =
+          static_cast<uint32_t>(deviceQueueCreateInfos.size()),
+      .pQueueCreateInfos = deviceQueueCreateInfos.data(),
       .enabledExtensionCount =
-          static_cast<uint32_t>(requiredDeviceExtension.size()),
-      .ppEnabledExtensionNames = requiredDeviceExtension.data()};
-  deviceCreateInfo.enabledExtensionCount = requiredDeviceExtension.size();
-  deviceCreateInfo.ppEnabledExtensionNames = requiredDeviceExtension.data();
-
-  device = vk::raii::Device(physicalDevice, deviceCreateInfo);
-  q.graphics = vk::raii::Queue(device, graphicsIndex, 0);
-  q.present = vk::raii::Queue(device, presentIndex, 0);
+          static_cast<uint32_t>(enabledExtensions.size()),
+      .ppEnabledExtensionNames = enabledExtensions.data()};
+
+  device = vk::raii::Device(physicalDevice, deviceCreateInfo,
+                            Memory::hostCallbacks(Memory::HostTag::Device));
+  graphicsQueue_ = vk::raii::Queue(device, graphicsIndex, 0);
+  presentQueue_ = vk::raii::Queue(device, presentIndex, 0);
+  computeQueue_ = vk::raii::Queue(device, computeIndex, 0);
+  q.graphicsFamily = graphicsIndex;
+  q.presentFamily = presentIndex;
+  q.computeFamily = computeIndex;
+  q.graphics = *graphicsQueue_;
+  q.present = *presentQueue_;
+  q.compute = *computeQueue_;
+}
+
+void Core::Device::createHeadless() {
+  std::vector<vk::QueueFamilyProperties> queueFamilyProperties =
+      physicalDevice.getQueueFamilyProperties();
+
+  const uint32_t computeIndex = findComputeFamily(queueFamilyProperties);
+  uint32_t graphicsIndex = UINT32_MAX;
+  for (size_t i = 0; i < queueFamilyProperties.size(); i++) {
+    if (queueFamilyProperties[i].queueFlags & vk::QueueFlagBits::eGraphics) {
+      graphicsIndex = static_cast<uint32_t>(i);
+      break;
+    }
+  }
+
+  // timeline semaphores track dispatch completion; device addresses only
+  // when the implementation has them
+  auto supported = physicalDevice.template getFeatures2<
+      vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+  vk::PhysicalDeviceFeatures2 features;
+  vk::PhysicalDeviceVulkan12Features vulkan12Features;
+  vk::PhysicalDeviceVulkan13Features vulkan13Features;
+  vulkan12Features.timelineSemaphore = vk::True;
+  vulkan12Features.bufferDeviceAddress =
+      supported.template get<vk::PhysicalDeviceVulkan12Features>()
+          .bufferDeviceAddress;
+  drawIndirectCount_ =
+      supported.template get<vk::PhysicalDeviceVulkan12Features>()
+          .drawIndirectCount;
+  vulkan12Features.drawIndirectCount = drawIndirectCount_;
+  vulkan13Features.synchronization2 = vk::True;
+  vulkan12Features.pNext = &vulkan13Features;
+  features.pNext = &vulkan12Features;
+
+  float queuePriority = 0.0f;
+  auto deviceQueueCreateInfos =
+      queueCreateInfos({graphicsIndex, computeIndex}, queuePriority);
+
+  vk::DeviceCreateInfo deviceCreateInfo{
+      .pNext = &features,
+      .queueCreateInfoCount =
+          static_cast<uint32_t>(deviceQueueCreateInfos.size()),
+      .pQueueCreateInfos = deviceQueueCreateInfos.data()};
+
+  device = vk::raii::Device(physicalDevice, deviceCreateInfo,
+                            Memory::hostCallbacks(Memory::HostTag::Device));
+  computeQueue_ = vk::raii::Queue(device, computeIndex, 0);
+  q.computeFamily = computeIndex;
+  q.compute = *computeQueue_;
+  if (graphicsIndex != UINT32_MAX) {
+    graphicsQueue_ = vk::raii::Queue(device, graphicsIndex, 0);
+    q.graphicsFamily = graphicsIndex;
+    q.graphics = *graphicsQueue_;
+  }
+}
+
+uint32_t Core::Device::findComputeFamily(
+    std::vector<vk::QueueFamilyProperties> const &families) {
+  // a compute-only family runs alongside graphics work
+  for (size_t i = 0; i < families.size(); i++) {
+    if ((families[i].queueFlags & vk::QueueFlagBits::eCompute) &&
+        !(families[i].queueFlags & vk::QueueFlagBits::eGraphics))
+      return static_cast<uint32_t>(i);
+  }
+  for (size_t i = 0; i < families.size(); i++) {
+    if (families[i].queueFlags & vk::QueueFlagBits::eCompute)
+      return static_cast<uint32_t>(i);
+  }
+  return UINT32_MAX;
+}
+
+bool Core::Device::hasExtension(
+    std::vector<vk::ExtensionProperties> const &available, const char *name) {
+  return std::ranges::any_of(available, [name](auto const &extension) {
+    return strcmp(extension.extensionName, name) == 0;
+  });
+}
+
+uint32_t Core::Device::findMemoryType(uint32_t typeBits,
+                                      vk::MemoryPropertyFlags props) const {
+  for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; ++i) {
+    if ((typeBits & (1u << i)) &&
+        (memoryProperties_.memoryTypes[i].propertyFlags & props) == props) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
 }
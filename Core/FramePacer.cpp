@@ -0,0 +1,206 @@
+#include <Core/FramePacer.h>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <ctime>
+#endif
+
+namespace {
+
+    constexpr uint32_t kFramesAfterInput = 3; // enough to drain a triple-buffered queue
+
+    double processCpuSeconds() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            return 0.0;
+        const auto toSeconds = [] (FILETIME const& ft) {
+            const uint64_t ticks = (uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+            return static_cast<double>(ticks) * 1e-7; // 100 ns units
+        };
+        return toSeconds(kernel) + toSeconds(user);
+#else
+        timespec ts{};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#endif
+    }
+
+    // Coarse sleep; may overshoot by the OS timer granularity.
+    void coarseSleep(std::chrono::steady_clock::duration d) {
+#ifdef _WIN32
+        // default Sleep() granularity is ~15.6 ms, the high resolution
+        // waitable timer (Windows 10 1803+) gets close to 0.5 ms
+        static thread_local HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr,
+            CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (timer) {
+            LARGE_INTEGER due;
+            due.QuadPart = -static_cast<LONGLONG>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / 100);
+            if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+                WaitForSingleObject(timer, INFINITE);
+                return;
+            }
+        }
+#endif
+        std::this_thread::sleep_for(d);
+    }
+
+} // namespace
+
+const char* Core::toString(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::Unlimited: return "unlimited";
+        case PacingMode::Capped:    return "capped";
+        case PacingMode::OnDemand:  return "on-demand";
+    }
+    return "?";
+}
+
+Core::FramePacer::FramePacer(PacingMode mode, double targetFps) : mode_(mode) {
+    setTargetFps(targetFps);
+    lastTick_ = Clock::now();
+    lastCpu_ = processCpuSeconds();
+}
+
+void Core::FramePacer::setMode(PacingMode mode) {
+    if (mode == mode_)
+        return;
+    account(); // close the books on the old mode
+    mode_ = mode;
+    lastFrameValid_ = false;
+    nextFrame_ = Clock::now();
+    requestRedraw();
+}
+
+void Core::FramePacer::setTargetFps(double fps) {
+    targetFps_ = fps;
+    period_ = fps > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : Clock::duration::zero();
+    nextFrame_ = Clock::now();
+}
+
+void Core::FramePacer::requestRedraw() {
+    redrawRequested_.store(true, std::memory_order_release);
+    glfwPostEmptyEvent();
+}
+
+void Core::FramePacer::notifyInput() {
+    activeFrames_ = kFramesAfterInput;
+}
+
+bool Core::FramePacer::waitForNextFrame() {
+    if (mode_ == PacingMode::OnDemand && activeFrames_ == 0 &&
+        !redrawRequested_.load(std::memory_order_acquire)) {
+        // idle: sleep in the OS until an event, a redraw request or the timeout
+        glfwWaitEventsTimeout(std::chrono::duration<double>(idleTimeout_).count());
+        account();
+        lastFrameValid_ = false;
+        if (activeFrames_ == 0 && !redrawRequested_.load(std::memory_order_acquire))
+            return false;
+        nextFrame_ = Clock::now(); // input wakes us: draw right away
+    }
+
+    if (mode_ != PacingMode::Unlimited && period_ != Clock::duration::zero()) {
+        const auto now = Clock::now();
+        // after a long stall don't try to catch up with a burst of frames
+        if (now - nextFrame_ > period_)
+            nextFrame_ = now;
+        sleepUntil(nextFrame_);
+        nextFrame_ += period_;
+    }
+
+    // poll after sleeping so the frame sees the freshest input
+    glfwPollEvents();
+    // cleared before drawing: a request made while the frame is being drawn
+    // stays set and gets a frame of its own
+    redrawRequested_.exchange(false, std::memory_order_acq_rel);
+    return true;
+}
+
+void Core::FramePacer::frameRendered() {
+    if (activeFrames_ > 0)
+        --activeFrames_;
+
+    const auto now = Clock::now();
+    auto& a = acc_[static_cast<size_t>(mode_)];
+    ++a.frames;
+    if (lastFrameValid_) {
+        const double ms = std::chrono::duration<double, std::milli>(now - lastFrame_).count();
+        ++a.intervals;
+        const double delta = ms - a.mean;
+        a.mean += delta / static_cast<double>(a.intervals);
+        a.m2 += delta * (ms - a.mean);
+    }
+    lastFrame_ = now;
+    lastFrameValid_ = true;
+    account();
+}
+
+void Core::FramePacer::sleepUntil(Clock::time_point deadline) {
+    const auto now = Clock::now();
+    if (deadline > now + spinMargin_) {
+        const auto target = deadline - spinMargin_;
+        coarseSleep(target - now);
+        // learn the timer's overshoot: grow quickly, shrink slowly
+        const auto overshoot = Clock::now() - target;
+        if (overshoot * 2 > spinMargin_)
+            spinMargin_ = std::min<Clock::duration>(overshoot * 2, std::chrono::milliseconds(20));
+        else
+            spinMargin_ = std::max<Clock::duration>(spinMargin_ - spinMargin_ / 16,
+                std::chrono::microseconds(250));
+    }
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void Core::FramePacer::account() {
+    const auto now = Clock::now();
+    const double cpu = processCpuSeconds();
+    auto& a = acc_[static_cast<size_t>(mode_)];
+    a.wallSeconds += std::chrono::duration<double>(now - lastTick_).count();
+    a.cpuSeconds += cpu - lastCpu_;
+    lastTick_ = now;
+    lastCpu_ = cpu;
+}
+
+Core::FramePacer::ModeStats Core::FramePacer::stats(PacingMode mode) const {
+    const auto& a = acc_[static_cast<size_t>(mode)];
+    ModeStats s;
+    s.frames = a.frames;
+    s.wallSeconds = a.wallSeconds;
+    s.cpuSeconds = a.cpuSeconds;
+    s.meanFrameMs = a.mean;
+    s.jitterMs = a.intervals > 1 ? std::sqrt(a.m2 / static_cast<double>(a.intervals - 1)) : 0.0;
+    return s;
+}
+
+std::string Core::FramePacer::report() const {
+    std::ostringstream oss;
+    for (auto mode : { PacingMode::Unlimited, PacingMode::Capped, PacingMode::OnDemand }) {
+        const ModeStats s = stats(mode);
+        if (s.wallSeconds <= 0.0)
+            continue;
+        oss << "pacing " << toString(mode) << ": " << s.frames << " frames in "
+            << s.wallSeconds << " s, cpu " << s.cpuUtilization() * 100.0
+            << "% of a core, frame " << s.meanFrameMs << " ms +/- " << s.jitterMs
+            << " ms\n";
+    }
+    return oss.str();
+}
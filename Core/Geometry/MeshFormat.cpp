@@ -0,0 +1,255 @@
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Geometry/Meshlets.h>
+#include <Core/Geometry/VertexQuantization.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool inside(uint64_t offset, uint64_t bytes, uint64_t size) {
+        return offset <= size && bytes <= size - offset;
+    }
+
+    template <class Visit>
+    Core::Geometry::Bounds boundsOf(Visit&& forEach) {
+        Core::Geometry::Bounds b{};
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        std::fill(std::begin(b.min), std::end(b.min), inf);
+        std::fill(std::begin(b.max), std::end(b.max), -inf);
+        bool any = false;
+        forEach([&] (const float* p) {
+            any = true;
+            for (int i = 0; i < 3; ++i) {
+                b.min[i] = std::min(b.min[i], p[i]);
+                b.max[i] = std::max(b.max[i], p[i]);
+            }
+        });
+        if (!any)
+            return Core::Geometry::Bounds{};
+        for (int i = 0; i < 3; ++i)
+            b.center[i] = 0.5f * (b.min[i] + b.max[i]);
+        // sphere around the box center; tighter than half the diagonal
+        float radius2 = 0.0f;
+        forEach([&] (const float* p) {
+            const float dx = p[0] - b.center[0], dy = p[1] - b.center[1], dz = p[2] - b.center[2];
+            radius2 = std::max(radius2, dx * dx + dy * dy + dz * dz);
+        });
+        b.radius = std::sqrt(radius2);
+        return b;
+    }
+
+    void pad(std::ofstream& out, uint64_t& written, uint64_t target) {
+        static const char zeros[Core::Geometry::kStreamAlignment] = {};
+        while (written < target) {
+            const uint64_t n = std::min<uint64_t>(target - written, sizeof(zeros));
+            out.write(zeros, static_cast<std::streamsize>(n));
+            written += n;
+        }
+    }
+
+} // namespace
+
+Core::Geometry::MeshView Core::Geometry::parseMesh(std::span<const std::byte> bytes, bool checkIndices) {
+    if (bytes.size() < sizeof(MeshHeader))
+        throw std::runtime_error("mesh: file too small for a header");
+    if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(MeshHeader) != 0)
+        throw std::runtime_error("mesh: buffer is not 8-byte aligned");
+
+    MeshView view;
+    view.header = reinterpret_cast<const MeshHeader*>(bytes.data());
+    const MeshHeader& h = *view.header;
+    if (h.magic != kMeshMagic)
+        throw std::runtime_error("mesh: bad magic");
+    if (h.version == 0 || h.version > kMeshVersion)
+        throw std::runtime_error("mesh: unsupported version " + std::to_string(h.version));
+    if (h.headerSize < sizeof(MeshHeader))
+        throw std::runtime_error("mesh: header too small");
+
+    const uint64_t indexSize = (h.flags & MeshIndex32) ? 4 : 2;
+    const uint64_t vertexStride = (h.flags & MeshQuantized) ? sizeof(QuantizedVertex) : sizeof(Vertex);
+    if (h.vertexStride != vertexStride || h.vertexBytes != uint64_t(h.vertexCount) * h.vertexStride ||
+        h.indexBytes != uint64_t(h.indexCount) * indexSize)
+        throw std::runtime_error("mesh: stream sizes don't match their counts");
+
+    const uint64_t submeshBytes = uint64_t(h.submeshCount) * sizeof(Submesh);
+    if (!inside(h.vertexOffset, h.vertexBytes, bytes.size()) ||
+        !inside(h.indexOffset, h.indexBytes, bytes.size()) ||
+        !inside(h.submeshOffset, submeshBytes, bytes.size()) ||
+        h.submeshOffset % alignof(Submesh) != 0)
+        throw std::runtime_error("mesh: stream outside the file (truncated?)");
+
+    view.submeshes = { reinterpret_cast<const Submesh*>(bytes.data() + h.submeshOffset),
+        h.submeshCount };
+    view.vertices = bytes.subspan(h.vertexOffset, h.vertexBytes);
+    view.indices = bytes.subspan(h.indexOffset, h.indexBytes);
+
+    if (h.flags & MeshMeshlets) {
+        if (!inside(h.meshletOffset, sizeof(MeshletStreams), bytes.size()) ||
+            h.meshletOffset % alignof(MeshletStreams) != 0)
+            throw std::runtime_error("mesh: meshlet block outside the file (truncated?)");
+        const auto& m = *reinterpret_cast<const MeshletStreams*>(bytes.data() + h.meshletOffset);
+        const uint64_t meshletBytes = uint64_t(m.meshletCount) * sizeof(Meshlet);
+        const uint64_t refBytes = uint64_t(m.vertexCount) * sizeof(uint32_t);
+        if (!inside(m.meshletsOffset, meshletBytes, bytes.size()) ||
+            !inside(m.verticesOffset, refBytes, bytes.size()) ||
+            !inside(m.trianglesOffset, m.triangleBytes, bytes.size()) ||
+            m.meshletsOffset % alignof(Meshlet) != 0 || m.verticesOffset % alignof(uint32_t) != 0)
+            throw std::runtime_error("mesh: meshlet stream outside the file (truncated?)");
+        view.meshlets = { reinterpret_cast<const Meshlet*>(bytes.data() + m.meshletsOffset),
+            m.meshletCount };
+        view.meshletVertices = { reinterpret_cast<const uint32_t*>(bytes.data() + m.verticesOffset),
+            m.vertexCount };
+        view.meshletTriangles = { reinterpret_cast<const uint8_t*>(bytes.data() + m.trianglesOffset),
+            m.triangleBytes };
+        for (auto const& meshlet : view.meshlets) {
+            if (uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > m.vertexCount ||
+                uint64_t(meshlet.triangleOffset) + uint64_t(meshlet.triangleCount) * 3 > m.triangleBytes)
+                throw std::runtime_error("mesh: meshlet outside its streams");
+        }
+    }
+
+    for (auto const& sub : view.submeshes) {
+        if (uint64_t(sub.firstIndex) + sub.indexCount > h.indexCount)
+            throw std::runtime_error("mesh: submesh indices outside the index stream");
+        if (uint64_t(sub.firstMeshlet) + sub.meshletCount > view.meshlets.size())
+            throw std::runtime_error("mesh: submesh meshlets outside the meshlet stream");
+    }
+
+    if (checkIndices) {
+        for (uint64_t i = 0; i < h.indexCount; ++i) {
+            uint32_t index = 0;
+            std::memcpy(&index, view.indices.data() + i * indexSize, indexSize); // little-endian
+            if (index >= h.vertexCount)
+                throw std::runtime_error("mesh: index " + std::to_string(index) + " out of range");
+        }
+        for (uint32_t ref : view.meshletVertices)
+            if (ref >= h.vertexCount)
+                throw std::runtime_error("mesh: meshlet vertex " + std::to_string(ref) + " out of range");
+    }
+    return view;
+}
+
+Core::Geometry::Bounds Core::Geometry::computeBounds(std::span<const Vertex> vertices) {
+    return boundsOf([&] (auto&& visit) {
+        for (auto const& v : vertices) visit(v.position);
+    });
+}
+
+Core::Geometry::Bounds Core::Geometry::computeBounds(std::span<const Vertex> vertices,
+    std::span<const uint32_t> indices) {
+    return boundsOf([&] (auto&& visit) {
+        for (uint32_t i : indices) visit(vertices[i].position);
+    });
+}
+
+void Core::Geometry::writeMesh(const std::string& path, MeshData const& mesh,
+    MeshWriteOptions const& options) {
+    std::vector<Submesh> submeshes = mesh.submeshes;
+    if (submeshes.empty()) {
+        Submesh all{};
+        all.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        all.bounds = computeBounds(mesh.vertices);
+        submeshes.push_back(all);
+    }
+
+    // meshlets per submesh; the index stream is re-emitted in their order
+    MeshletData meshlets;
+    std::vector<uint32_t> reordered;
+    if (options.meshlets) {
+        reordered.reserve(mesh.indices.size());
+        for (auto& s : submeshes) {
+            s.firstMeshlet = static_cast<uint32_t>(meshlets.meshlets.size());
+            appendMeshlets(meshlets, mesh.vertices,
+                std::span(mesh.indices).subspan(s.firstIndex, s.indexCount), options.limits);
+            s.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size()) - s.firstMeshlet;
+            s.firstIndex = static_cast<uint32_t>(reordered.size());
+            const auto part = meshletIndices(meshlets, s.firstMeshlet, s.meshletCount);
+            reordered.insert(reordered.end(), part.begin(), part.end());
+        }
+    }
+    std::span<const uint32_t> indices = options.meshlets ? reordered : mesh.indices;
+
+    const bool index32 = mesh.vertices.size() > 0x10000;
+    MeshHeader h{};
+    h.magic = kMeshMagic;
+    h.version = kMeshVersion;
+    h.headerSize = sizeof(MeshHeader);
+    h.flags = (index32 ? uint32_t(MeshIndex32) : 0u) |
+        (options.quantize ? uint32_t(MeshQuantized) : 0u) |
+        (options.meshlets ? uint32_t(MeshMeshlets) : 0u);
+    h.attributes = mesh.attributes;
+    h.vertexStride = options.quantize ? sizeof(QuantizedVertex) : sizeof(Vertex);
+    h.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    h.indexCount = static_cast<uint32_t>(indices.size());
+    h.submeshCount = static_cast<uint32_t>(submeshes.size());
+    h.submeshOffset = sizeof(MeshHeader);
+    h.vertexOffset = alignUp(h.submeshOffset + submeshes.size() * sizeof(Submesh), kStreamAlignment);
+    h.vertexBytes = uint64_t(h.vertexCount) * h.vertexStride;
+    h.indexOffset = alignUp(h.vertexOffset + h.vertexBytes, kStreamAlignment);
+    h.indexBytes = indices.size() * (index32 ? 4 : 2);
+    h.bounds = computeBounds(mesh.vertices);
+
+    MeshletStreams ms{};
+    if (options.meshlets) {
+        h.meshletOffset = alignUp(h.indexOffset + h.indexBytes, kStreamAlignment);
+        ms.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+        ms.vertexCount = static_cast<uint32_t>(meshlets.vertices.size());
+        ms.triangleBytes = static_cast<uint32_t>(meshlets.triangles.size());
+        ms.maxVertices = options.limits.maxVertices;
+        ms.maxTriangles = options.limits.maxTriangles;
+        ms.meshletsOffset = alignUp(h.meshletOffset + sizeof(MeshletStreams), kStreamAlignment);
+        ms.verticesOffset = alignUp(ms.meshletsOffset + meshlets.meshlets.size() * sizeof(Meshlet),
+            kStreamAlignment);
+        ms.trianglesOffset = alignUp(ms.verticesOffset + meshlets.vertices.size() * sizeof(uint32_t),
+            kStreamAlignment);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Failed to open file for writing: " + path);
+
+    uint64_t written = 0;
+    const auto write = [&] (const void* data, uint64_t size) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    write(&h, sizeof(h));
+    write(submeshes.data(), submeshes.size() * sizeof(Submesh));
+    pad(out, written, h.vertexOffset);
+    if (options.quantize) {
+        std::vector<QuantizedVertex> quantized(mesh.vertices.size());
+        quantizeVertices(mesh.vertices, quantized, quantizationTransform(h.bounds));
+        write(quantized.data(), h.vertexBytes);
+    } else {
+        write(mesh.vertices.data(), h.vertexBytes);
+    }
+    pad(out, written, h.indexOffset);
+    if (index32) {
+        write(indices.data(), h.indexBytes);
+    } else {
+        std::vector<uint16_t> narrow(indices.begin(), indices.end());
+        write(narrow.data(), h.indexBytes);
+    }
+    if (options.meshlets) {
+        pad(out, written, h.meshletOffset);
+        write(&ms, sizeof(ms));
+        pad(out, written, ms.meshletsOffset);
+        write(meshlets.meshlets.data(), meshlets.meshlets.size() * sizeof(Meshlet));
+        pad(out, written, ms.verticesOffset);
+        write(meshlets.vertices.data(), meshlets.vertices.size() * sizeof(uint32_t));
+        pad(out, written, ms.trianglesOffset);
+        write(meshlets.triangles.data(), meshlets.triangles.size());
+    }
+    if (!out)
+        throw std::runtime_error("Failed to write mesh: " + path);
+}
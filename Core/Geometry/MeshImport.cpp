@@ -0,0 +1,414 @@
+#include <Core/Geometry/MeshImport.h>
+#include <Core/Utils/MappedFile.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using Core::Geometry::MeshData;
+    using Core::Geometry::Submesh;
+    using Core::Geometry::Vertex;
+
+    // ---------- Shared ----------
+
+    void generateNormals(MeshData& mesh) {
+        for (auto& v : mesh.vertices)
+            std::fill(std::begin(v.normal), std::end(v.normal), 0.0f);
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            Vertex& a = mesh.vertices[mesh.indices[i]];
+            Vertex& b = mesh.vertices[mesh.indices[i + 1]];
+            Vertex& c = mesh.vertices[mesh.indices[i + 2]];
+            const float e1[3] = { b.position[0] - a.position[0], b.position[1] - a.position[1],
+                b.position[2] - a.position[2] };
+            const float e2[3] = { c.position[0] - a.position[0], c.position[1] - a.position[1],
+                c.position[2] - a.position[2] };
+            // unnormalized cross product: larger faces weigh more
+            const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0] };
+            for (Vertex* v : { &a, &b, &c })
+                for (int k = 0; k < 3; ++k) v->normal[k] += n[k];
+        }
+        for (auto& v : mesh.vertices) {
+            const float len = std::sqrt(v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] +
+                v.normal[2] * v.normal[2]);
+            if (len > 0.0f) {
+                for (float& c : v.normal) c /= len;
+            } else {
+                v.normal[0] = v.normal[1] = 0.0f;
+                v.normal[2] = 1.0f;
+            }
+        }
+        mesh.attributes |= Core::Geometry::AttributeNormal;
+    }
+
+    void finishSubmeshBounds(MeshData& mesh) {
+        for (auto& s : mesh.submeshes)
+            s.bounds = Core::Geometry::computeBounds(mesh.vertices,
+                std::span(mesh.indices).subspan(s.firstIndex, s.indexCount));
+    }
+
+    // Welds corners by an arbitrary fixed-size key.
+    template <size_t N>
+    struct KeyHash {
+        size_t operator()(std::array<uint32_t, N> const& k) const noexcept {
+            uint64_t h = 1469598103934665603ull;
+            for (uint32_t v : k) { h ^= v; h *= 1099511628211ull; }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    // ---------- Text scanning ----------
+
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    std::string_view nextToken(std::string_view& line) {
+        size_t b = 0;
+        while (b < line.size() && isSpace(line[b])) ++b;
+        size_t e = b;
+        while (e < line.size() && !isSpace(line[e])) ++e;
+        const std::string_view token = line.substr(b, e - b);
+        line.remove_prefix(e);
+        return token;
+    }
+
+    template <class T>
+    T parseNumber(std::string_view token, const char* what) {
+        T value{};
+        // from_chars rejects a leading '+'
+        if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+        const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (ec != std::errc{} || token.empty())
+            throw std::runtime_error(std::string(what) + ": bad number '" + std::string(token) + "'");
+        return value;
+    }
+
+    // ---------- OBJ ----------
+
+    int32_t resolveObjIndex(std::string_view token, size_t count) {
+        if (token.empty())
+            return -1;
+        const long long index = parseNumber<long long>(token, "obj");
+        const long long resolved = index < 0 ? static_cast<long long>(count) + index : index - 1;
+        if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(count))
+            throw std::runtime_error("obj: index " + std::string(token) + " out of range");
+        return static_cast<int32_t>(resolved);
+    }
+
+    // ---------- PLY ----------
+
+    enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+    PlyType plyType(std::string_view name) {
+        if (name == "char" || name == "int8") return PlyType::Int8;
+        if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+        if (name == "short" || name == "int16") return PlyType::Int16;
+        if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+        if (name == "int" || name == "int32") return PlyType::Int32;
+        if (name == "uint" || name == "uint32") return PlyType::UInt32;
+        if (name == "float" || name == "float32") return PlyType::Float32;
+        if (name == "double" || name == "float64") return PlyType::Float64;
+        throw std::runtime_error("ply: unknown property type " + std::string(name));
+    }
+
+    struct PlyProperty {
+        std::string name;
+        PlyType type{};
+        bool list = false;
+        PlyType countType{};
+    };
+
+    struct PlyElement {
+        std::string name;
+        size_t count = 0;
+        std::vector<PlyProperty> properties;
+    };
+
+    class PlyReader {
+    public:
+        PlyReader(const std::byte* begin, const std::byte* end, bool ascii)
+            : p_(begin), end_(end), ascii_(ascii) {}
+
+        double read(PlyType type) {
+            if (ascii_) {
+                std::string_view rest(reinterpret_cast<const char*>(p_), end_ - p_);
+                size_t b = 0;
+                while (b < rest.size() && (isSpace(rest[b]) || rest[b] == '\n')) ++b;
+                size_t e = b;
+                while (e < rest.size() && !isSpace(rest[e]) && rest[e] != '\n') ++e;
+                p_ += e;
+                return parseNumber<double>(rest.substr(b, e - b), "ply");
+            }
+            switch (type) {
+                case PlyType::Int8:    return take<int8_t>();
+                case PlyType::UInt8:   return take<uint8_t>();
+                case PlyType::Int16:   return take<int16_t>();
+                case PlyType::UInt16:  return take<uint16_t>();
+                case PlyType::Int32:   return take<int32_t>();
+                case PlyType::UInt32:  return take<uint32_t>();
+                case PlyType::Float32: return take<float>();
+                case PlyType::Float64: return take<double>();
+            }
+            return 0.0;
+        }
+
+    private:
+        template <class T>
+        T take() {
+            if (static_cast<size_t>(end_ - p_) < sizeof(T))
+                throw std::runtime_error("ply: truncated body");
+            T value;
+            std::memcpy(&value, p_, sizeof(T));
+            p_ += sizeof(T);
+            return value;
+        }
+
+        const std::byte* p_;
+        const std::byte* end_;
+        bool ascii_;
+    };
+
+} // namespace
+
+Core::Geometry::MeshData Core::Geometry::importObj(std::string_view text) {
+    std::vector<float> positions, normals, uvs;
+    std::unordered_map<std::array<uint32_t, 3>, uint32_t, KeyHash<3>> welded;
+    std::unordered_map<std::string, uint32_t> materials;
+    MeshData mesh;
+    bool missingNormals = false, anyUv = false;
+    Submesh current{};
+
+    const auto closeSubmesh = [&] {
+        const auto end = static_cast<uint32_t>(mesh.indices.size());
+        if (end > current.firstIndex) {
+            current.indexCount = end - current.firstIndex;
+            mesh.submeshes.push_back(current);
+        }
+        current.firstIndex = end;
+    };
+
+    std::vector<uint32_t> corners;
+    while (!text.empty()) {
+        const size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        const std::string_view tag = nextToken(line);
+        if (tag == "v") {
+            for (int i = 0; i < 3; ++i) positions.push_back(parseNumber<float>(nextToken(line), "obj"));
+        } else if (tag == "vn") {
+            for (int i = 0; i < 3; ++i) normals.push_back(parseNumber<float>(nextToken(line), "obj"));
+        } else if (tag == "vt") {
+            for (int i = 0; i < 2; ++i) uvs.push_back(parseNumber<float>(nextToken(line), "obj"));
+        } else if (tag == "usemtl") {
+            closeSubmesh();
+            const std::string name(nextToken(line));
+            current.material = materials.try_emplace(name, static_cast<uint32_t>(materials.size()))
+                .first->second;
+        } else if (tag == "f") {
+            corners.clear();
+            for (std::string_view token = nextToken(line); !token.empty(); token = nextToken(line)) {
+                // v, v/t, v//n, v/t/n
+                const size_t s1 = token.find('/');
+                const size_t s2 = s1 == std::string_view::npos ? s1 : token.find('/', s1 + 1);
+                const int32_t v = resolveObjIndex(token.substr(0, s1), positions.size() / 3);
+                const int32_t t = s1 == std::string_view::npos ? -1
+                    : resolveObjIndex(token.substr(s1 + 1, s2 - s1 - 1), uvs.size() / 2);
+                const int32_t n = s2 == std::string_view::npos ? -1
+                    : resolveObjIndex(token.substr(s2 + 1), normals.size() / 3);
+                if (v < 0)
+                    throw std::runtime_error("obj: face corner without a position");
+                missingNormals |= n < 0;
+                anyUv |= t >= 0;
+
+                const std::array<uint32_t, 3> key{ uint32_t(v), uint32_t(t), uint32_t(n) };
+                auto [it, inserted] = welded.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    Vertex vertex{};
+                    std::copy_n(&positions[size_t(v) * 3], 3, vertex.position);
+                    if (n >= 0) std::copy_n(&normals[size_t(n) * 3], 3, vertex.normal);
+                    if (t >= 0) std::copy_n(&uvs[size_t(t) * 2], 2, vertex.uv);
+                    mesh.vertices.push_back(vertex);
+                }
+                corners.push_back(it->second);
+            }
+            for (size_t i = 2; i < corners.size(); ++i)
+                mesh.indices.insert(mesh.indices.end(), { corners[0], corners[i - 1], corners[i] });
+        }
+        // o, g, s, mtllib, comments: not needed for geometry
+    }
+    closeSubmesh();
+
+    mesh.attributes = AttributePosition | (anyUv ? AttributeTexCoord : 0u);
+    if (missingNormals || normals.empty())
+        generateNormals(mesh);
+    else
+        mesh.attributes |= AttributeNormal;
+    finishSubmeshBounds(mesh);
+    return mesh;
+}
+
+Core::Geometry::MeshData Core::Geometry::importStl(std::span<const std::byte> bytes) {
+    MeshData mesh;
+    std::unordered_map<std::array<uint32_t, 3>, uint32_t, KeyHash<3>> welded;
+    const auto corner = [&] (const float p[3]) {
+        const std::array<uint32_t, 3> key{ std::bit_cast<uint32_t>(p[0]),
+            std::bit_cast<uint32_t>(p[1]), std::bit_cast<uint32_t>(p[2]) };
+        auto [it, inserted] = welded.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+        if (inserted) {
+            Vertex v{};
+            std::copy_n(p, 3, v.position);
+            mesh.vertices.push_back(v);
+        }
+        mesh.indices.push_back(it->second);
+    };
+
+    uint32_t triangles = 0;
+    if (bytes.size() >= 84)
+        std::memcpy(&triangles, bytes.data() + 80, sizeof(triangles));
+    const bool binary = bytes.size() >= 84 && bytes.size() == 84 + uint64_t(triangles) * 50;
+
+    if (binary) {
+        // 12 B normal, 3 x 12 B corners, 2 B attribute count
+        for (uint32_t t = 0; t < triangles; ++t) {
+            const std::byte* tri = bytes.data() + 84 + size_t(t) * 50;
+            for (int c = 0; c < 3; ++c) {
+                float p[3];
+                std::memcpy(p, tri + 12 + c * 12, sizeof(p));
+                corner(p);
+            }
+        }
+    } else {
+        std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        while (!text.empty()) {
+            const size_t eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+            if (nextToken(line) != "vertex")
+                continue;
+            float p[3];
+            for (float& c : p) c = parseNumber<float>(nextToken(line), "stl");
+            corner(p);
+        }
+        if (mesh.indices.size() % 3 != 0)
+            throw std::runtime_error("stl: vertex count is not a multiple of three");
+    }
+
+    generateNormals(mesh);
+    return mesh;
+}
+
+Core::Geometry::MeshData Core::Geometry::importPly(std::span<const std::byte> bytes) {
+    const std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    const size_t headerEnd = text.find("end_header");
+    if (text.substr(0, 3) != "ply" || headerEnd == std::string_view::npos)
+        throw std::runtime_error("ply: missing header");
+    const size_t bodyStart = text.find('\n', headerEnd);
+    if (bodyStart == std::string_view::npos)
+        throw std::runtime_error("ply: missing body");
+
+    bool ascii = false;
+    std::vector<PlyElement> elements;
+    std::string_view header = text.substr(0, headerEnd);
+    while (!header.empty()) {
+        const size_t eol = header.find('\n');
+        std::string_view line = header.substr(0, eol);
+        header.remove_prefix(eol == std::string_view::npos ? header.size() : eol + 1);
+        const std::string_view tag = nextToken(line);
+        if (tag == "format") {
+            const std::string_view format = nextToken(line);
+            if (format == "ascii") ascii = true;
+            else if (format != "binary_little_endian")
+                throw std::runtime_error("ply: unsupported format " + std::string(format));
+        } else if (tag == "element") {
+            PlyElement e;
+            e.name = nextToken(line);
+            e.count = parseNumber<size_t>(nextToken(line), "ply");
+            elements.push_back(std::move(e));
+        } else if (tag == "property") {
+            if (elements.empty())
+                throw std::runtime_error("ply: property before element");
+            PlyProperty p;
+            std::string_view type = nextToken(line);
+            if (type == "list") {
+                p.list = true;
+                p.countType = plyType(nextToken(line));
+                type = nextToken(line);
+            }
+            p.type = plyType(type);
+            p.name = nextToken(line);
+            elements.back().properties.push_back(std::move(p));
+        }
+    }
+
+    MeshData mesh;
+    bool hasNormals = false, hasUv = false;
+    PlyReader reader(bytes.data() + bodyStart + 1, bytes.data() + bytes.size(), ascii);
+    std::vector<uint32_t> polygon;
+    for (auto const& element : elements) {
+        const bool vertices = element.name == "vertex";
+        const bool faces = element.name == "face";
+        for (size_t i = 0; i < element.count; ++i) {
+            Vertex v{};
+            for (auto const& p : element.properties) {
+                if (p.list) {
+                    const auto n = static_cast<size_t>(reader.read(p.countType));
+                    polygon.clear();
+                    for (size_t k = 0; k < n; ++k)
+                        polygon.push_back(static_cast<uint32_t>(reader.read(p.type)));
+                    if (faces && (p.name == "vertex_indices" || p.name == "vertex_index"))
+                        for (size_t k = 2; k < polygon.size(); ++k)
+                            mesh.indices.insert(mesh.indices.end(),
+                                { polygon[0], polygon[k - 1], polygon[k] });
+                    continue;
+                }
+                const auto value = static_cast<float>(reader.read(p.type));
+                if (!vertices) continue;
+                if (p.name == "x") v.position[0] = value;
+                else if (p.name == "y") v.position[1] = value;
+                else if (p.name == "z") v.position[2] = value;
+                else if (p.name == "nx") { v.normal[0] = value; hasNormals = true; }
+                else if (p.name == "ny") v.normal[1] = value;
+                else if (p.name == "nz") v.normal[2] = value;
+                else if (p.name == "u" || p.name == "s" || p.name == "texture_u") { v.uv[0] = value; hasUv = true; }
+                else if (p.name == "v" || p.name == "t" || p.name == "texture_v") v.uv[1] = value;
+            }
+            if (vertices)
+                mesh.vertices.push_back(v);
+        }
+    }
+
+    for (uint32_t index : mesh.indices)
+        if (index >= mesh.vertices.size())
+            throw std::runtime_error("ply: face index out of range");
+
+    mesh.attributes = AttributePosition | (hasUv ? AttributeTexCoord : 0u);
+    if (hasNormals)
+        mesh.attributes |= AttributeNormal;
+    else
+        generateNormals(mesh);
+    return mesh;
+}
+
+Core::Geometry::MeshData Core::Geometry::importMesh(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::ranges::transform(ext, ext.begin(), [] (unsigned char c) { return std::tolower(c); });
+
+    const MappedFile file(path);
+    if (ext == ".obj")
+        return importObj({ reinterpret_cast<const char*>(file.data()), file.size() });
+    if (ext == ".stl")
+        return importStl(file.bytes());
+    if (ext == ".ply")
+        return importPly(file.bytes());
+    throw std::runtime_error("unsupported mesh format: " + path);
+}
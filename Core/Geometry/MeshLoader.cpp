@@ -0,0 +1,129 @@
+#include <Core/Geometry/MeshLoader.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Profiling/Profiler.h>
+#include <Core/Utils/MappedFile.h>
+
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    constexpr vk::BufferUsageFlags kVertexUsage = vk::BufferUsageFlagBits::eVertexBuffer |
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst;
+    constexpr vk::BufferUsageFlags kIndexUsage = vk::BufferUsageFlagBits::eIndexBuffer |
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst;
+    constexpr vk::BufferUsageFlags kStorageUsage = vk::BufferUsageFlagBits::eStorageBuffer |
+        vk::BufferUsageFlagBits::eTransferDst;
+
+} // namespace
+
+Core::Geometry::MeshLoader::MeshLoader(Device& device) : device_(&device) {
+    // headless devices may have no graphics family; any queue can copy
+    const bool graphics = device.queues().graphicsFamily != UINT32_MAX;
+    queue_ = graphics ? &device.graphicsQueue() : &device.computeQueue();
+    pool_ = vk::raii::CommandPool(device.vkDevice(), vk::CommandPoolCreateInfo{
+        .flags = vk::CommandPoolCreateFlagBits::eTransient |
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = graphics ? device.queues().graphicsFamily
+                                     : device.queues().computeFamily },
+        Memory::hostCallbacks(Memory::HostTag::Commands));
+    fence_ = vk::raii::Fence(device.vkDevice(), vk::FenceCreateInfo{},
+        Memory::hostCallbacks(Memory::HostTag::Sync));
+}
+
+Core::Geometry::GpuMesh Core::Geometry::MeshLoader::load(const std::string& path) {
+    CORE_PROFILE_ZONE("MeshLoader::load");
+    const auto t0 = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    file.adviseSequential();
+    GpuMesh mesh = upload(parseMesh(file.bytes()));
+    stats_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return mesh;
+}
+
+Core::Geometry::GpuMesh Core::Geometry::MeshLoader::upload(MeshView const& view) {
+    auto& device = *device_;
+    MeshHeader const& header = *view.header;
+
+    GpuMesh mesh;
+    mesh.indexType = view.index32() ? vk::IndexType::eUint32 : vk::IndexType::eUint16;
+    mesh.vertexCount = header.vertexCount;
+    mesh.indexCount = header.indexCount;
+    mesh.vertexStride = header.vertexStride;
+    mesh.attributes = header.attributes;
+    mesh.bounds = header.bounds;
+    mesh.submeshes.assign(view.submeshes.begin(), view.submeshes.end());
+    mesh.quantized = view.quantized();
+    mesh.transform = quantizationTransform(header.bounds);
+    mesh.meshletCount = static_cast<uint32_t>(view.meshlets.size());
+
+    if (view.vertices.empty() || view.indices.empty())
+        throw std::runtime_error("MeshLoader: empty mesh");
+
+    struct Stream {
+        std::span<const std::byte> source;
+        Memory::Buffer* target;
+        vk::BufferUsageFlags usage;
+        vk::DeviceSize stagingOffset = 0;
+    };
+    std::vector<Stream> streams = {
+        { view.vertices, &mesh.vertices, kVertexUsage },
+        { view.indices, &mesh.indices, kIndexUsage },
+    };
+    if (!view.meshlets.empty()) {
+        streams.push_back({ std::as_bytes(view.meshlets), &mesh.meshlets, kStorageUsage });
+        streams.push_back({ std::as_bytes(view.meshletVertices), &mesh.meshletVertices, kStorageUsage });
+        streams.push_back({ std::as_bytes(view.meshletTriangles), &mesh.meshletTriangles, kStorageUsage });
+    }
+
+    // host-visible is only preferred: on UMA / ReBAR the streams skip staging
+    vk::DeviceSize stagingBytes = 0;
+    for (auto& s : streams) {
+        *s.target = Memory::Buffer(device, s.source.size(), s.usage,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent);
+        stats_.bytes += s.source.size();
+        const bool direct = s.target->mapped() &&
+            (s.target->memoryFlags() & vk::MemoryPropertyFlagBits::eHostCoherent);
+        if (direct) {
+            std::memcpy(s.target->mapped(), s.source.data(), s.source.size());
+            stats_.directWrites++;
+            s.source = {};
+            continue;
+        }
+        s.stagingOffset = stagingBytes;
+        stagingBytes = (stagingBytes + s.source.size() + kStreamAlignment - 1) & ~(kStreamAlignment - 1);
+    }
+    stats_.meshes++;
+    if (stagingBytes == 0)
+        return mesh;
+
+    // one staging buffer for every stream that needs it
+    Memory::Buffer staging(device, stagingBytes, vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    auto* dst = static_cast<std::byte*>(staging.mapped());
+
+    auto cmd = std::move(device.vkDevice().allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        .commandPool = *pool_,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1 }).front());
+    cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    for (auto const& s : streams) {
+        if (s.source.empty())
+            continue;
+        std::memcpy(dst + s.stagingOffset, s.source.data(), s.source.size());
+        cmd.copyBuffer(staging.handle(), s.target->handle(),
+            vk::BufferCopy{ .srcOffset = s.stagingOffset, .dstOffset = 0, .size = s.source.size() });
+    }
+    cmd.end();
+
+    const vk::CommandBuffer handle = *cmd;
+    queue_->submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &handle }, *fence_);
+    if (device.vkDevice().waitForFences(*fence_, vk::True, UINT64_MAX) != vk::Result::eSuccess)
+        throw std::runtime_error("MeshLoader: upload fence wait failed");
+    device.vkDevice().resetFences(*fence_);
+    return mesh;
+}
@@ -0,0 +1,211 @@
+#include <Core/Geometry/Meshlets.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+    using Core::Geometry::Meshlet;
+    using Core::Geometry::Vertex;
+
+    struct Vec3 {
+        float x, y, z;
+        Vec3 operator-(Vec3 o) const { return { x - o.x, y - o.y, z - o.z }; }
+        Vec3 operator+(Vec3 o) const { return { x + o.x, y + o.y, z + o.z }; }
+        Vec3 operator*(float s) const { return { x * s, y * s, z * s }; }
+    };
+
+    Vec3 load(const float* p) { return { p[0], p[1], p[2] }; }
+    float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Vec3 cross(Vec3 a, Vec3 b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+    float length(Vec3 a) { return std::sqrt(dot(a, a)); }
+
+    void computeMeshletBounds(Meshlet& m, std::span<const Vertex> vertices,
+        const uint32_t* refs, const uint8_t* triangles) {
+        // sphere around the box center
+        Vec3 lo{ INFINITY, INFINITY, INFINITY }, hi{ -INFINITY, -INFINITY, -INFINITY };
+        for (uint32_t i = 0; i < m.vertexCount; ++i) {
+            const Vec3 p = load(vertices[refs[i]].position);
+            lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+            hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+        }
+        const Vec3 center = (lo + hi) * 0.5f;
+        float radius = 0.0f;
+        for (uint32_t i = 0; i < m.vertexCount; ++i)
+            radius = std::max(radius, length(load(vertices[refs[i]].position) - center));
+        m.center[0] = center.x; m.center[1] = center.y; m.center[2] = center.z;
+        m.radius = radius;
+
+        // normal cone from the face normals (not the vertex normals: the
+        // cone has to bound what the rasterizer culls)
+        Vec3 axis{ 0, 0, 0 };
+        std::vector<Vec3> normals;
+        normals.reserve(m.triangleCount);
+        for (uint32_t t = 0; t < m.triangleCount; ++t) {
+            const uint8_t* tri = triangles + t * 3;
+            const Vec3 a = load(vertices[refs[tri[0]]].position);
+            const Vec3 b = load(vertices[refs[tri[1]]].position);
+            const Vec3 c = load(vertices[refs[tri[2]]].position);
+            const Vec3 n = cross(b - a, c - a);
+            const float len = length(n);
+            if (len == 0.0f)
+                continue; // degenerate: no facing
+            normals.push_back(n * (1.0f / len));
+            axis = axis + normals.back();
+        }
+        const float axisLength = length(axis);
+        float minDot = 1.0f;
+        if (axisLength > 0.0f) {
+            axis = axis * (1.0f / axisLength);
+            for (Vec3 n : normals)
+                minDot = std::min(minDot, dot(axis, n));
+        }
+        m.coneAxis[0] = axis.x; m.coneAxis[1] = axis.y; m.coneAxis[2] = axis.z;
+        // a cone of half-angle >= ~84 degrees never culls usefully
+        m.coneCutoff = (axisLength == 0.0f || minDot <= 0.1f) ? 1.0f
+            : std::sqrt(1.0f - minDot * minDot);
+    }
+
+} // namespace
+
+void Core::Geometry::appendMeshlets(MeshletData& out, std::span<const Vertex> vertices,
+    std::span<const uint32_t> indices, MeshletLimits limits) {
+    if (limits.maxVertices < 3 || limits.maxVertices > 256 || limits.maxTriangles == 0)
+        throw std::runtime_error("meshlets: maxVertices must be in [3, 256]");
+    if (indices.size() % 3 != 0)
+        throw std::runtime_error("meshlets: index count is not a multiple of three");
+
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size();
+
+    // vertex -> triangles adjacency (CSR), plus how many are still unused
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (uint32_t v : indices) {
+        if (v >= vertexCount)
+            throw std::runtime_error("meshlets: index out of range");
+        ++adjacencyOffset[v + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffset[v + 1] += adjacencyOffset[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> live(vertexCount, 0);
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            ++live[indices[i]];
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<int16_t> local(vertexCount, -1); // mesh vertex -> slot in the open meshlet
+    std::vector<uint32_t> refs;                   // open meshlet's vertices
+    std::vector<uint8_t> tris;                    // open meshlet's local triples
+    size_t cursor = 0;                            // first possibly unused triangle
+
+    const auto newVertices = [&] (size_t t) {
+        return uint32_t(local[indices[t * 3]] < 0) + uint32_t(local[indices[t * 3 + 1]] < 0) +
+            uint32_t(local[indices[t * 3 + 2]] < 0);
+    };
+
+    const auto flush = [&] {
+        if (tris.empty())
+            return;
+        Meshlet m{};
+        m.vertexOffset = static_cast<uint32_t>(out.vertices.size());
+        m.triangleOffset = static_cast<uint32_t>(out.triangles.size());
+        m.vertexCount = static_cast<uint32_t>(refs.size());
+        m.triangleCount = static_cast<uint32_t>(tris.size() / 3);
+        computeMeshletBounds(m, vertices, refs.data(), tris.data());
+        out.meshlets.push_back(m);
+        out.vertices.insert(out.vertices.end(), refs.begin(), refs.end());
+        out.triangles.insert(out.triangles.end(), tris.begin(), tris.end());
+        out.triangles.resize((out.triangles.size() + 3) & ~size_t(3), 0);
+        for (uint32_t v : refs) local[v] = -1;
+        refs.clear();
+        tris.clear();
+    };
+
+    for (size_t done = 0; done < triangleCount; ++done) {
+        // best unused neighbour of the open meshlet: fewest new vertices,
+        // then fewest remaining neighbours (finish off corners first)
+        size_t best = SIZE_MAX;
+        uint32_t bestNew = 4, bestLive = UINT32_MAX;
+        for (uint32_t v : refs) {
+            if (live[v] == 0) continue; // every triangle around it is placed
+            for (uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v + 1]; ++a) {
+                const uint32_t t = adjacency[a];
+                if (emitted[t]) continue;
+                const uint32_t added = newVertices(t);
+                const uint32_t liveSum = live[indices[t * 3]] + live[indices[t * 3 + 1]] +
+                    live[indices[t * 3 + 2]];
+                if (added < bestNew || (added == bestNew && liveSum < bestLive)) {
+                    best = t;
+                    bestNew = added;
+                    bestLive = liveSum;
+                }
+            }
+        }
+        const bool fits = best != SIZE_MAX && refs.size() + bestNew <= limits.maxVertices &&
+            tris.size() / 3 < limits.maxTriangles;
+        if (!fits) {
+            flush();
+            while (emitted[cursor]) ++cursor;
+            best = cursor;
+        }
+
+        emitted[best] = true;
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t v = indices[best * 3 + k];
+            --live[v];
+            if (local[v] < 0) {
+                local[v] = static_cast<int16_t>(refs.size());
+                refs.push_back(v);
+            }
+            tris.push_back(static_cast<uint8_t>(local[v]));
+        }
+    }
+    flush();
+}
+
+std::vector<uint32_t> Core::Geometry::meshletIndices(MeshletData const& data,
+    size_t firstMeshlet, size_t meshletCount) {
+    const size_t first = std::min(firstMeshlet, data.meshlets.size());
+    const size_t last = first + std::min(meshletCount, data.meshlets.size() - first);
+    std::vector<uint32_t> indices;
+    for (size_t i = first; i < last; ++i) {
+        Meshlet const& m = data.meshlets[i];
+        for (uint32_t k = 0; k < m.triangleCount * 3; ++k)
+            indices.push_back(data.vertices[m.vertexOffset + data.triangles[m.triangleOffset + k]]);
+    }
+    return indices;
+}
+
+Core::Geometry::VertexCacheStats Core::Geometry::analyzeVertexCache(
+    std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    // FIFO by timestamp: a vertex is cached if fewer than cacheSize misses
+    // happened since it was loaded
+    std::vector<uint64_t> loadedAt(vertexCount, 0);
+    std::vector<bool> seen(vertexCount, false);
+    uint64_t misses = 0, unique = 0;
+    for (uint32_t v : indices) {
+        if (v >= vertexCount)
+            throw std::runtime_error("vertex cache: index out of range");
+        if (!seen[v]) { seen[v] = true; ++unique; }
+        if (loadedAt[v] == 0 || misses + 1 - loadedAt[v] > cacheSize) {
+            ++misses;
+            loadedAt[v] = misses; // 1-based so 0 means never loaded
+        }
+    }
+    VertexCacheStats stats;
+    if (!indices.empty()) {
+        stats.acmr = double(misses) / double(indices.size() / 3);
+        stats.atvr = double(misses) / double(unique);
+        stats.hitRate = 1.0 - double(misses) / double(indices.size());
+    }
+    return stats;
+}
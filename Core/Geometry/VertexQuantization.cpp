@@ -0,0 +1,258 @@
+#include <Core/Geometry/VertexQuantization.h>
+#include <Core/Utils/Simd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+    using Core::Geometry::QuantizationTransform;
+    using Core::Geometry::QuantizedVertex;
+    using Core::Geometry::Vertex;
+
+    // 65535 / scale per axis; 0 for flat axes so they quantize to 0
+    void inverseScale(QuantizationTransform const& t, float out[3]) {
+        for (int i = 0; i < 3; ++i)
+            out[i] = t.scale[i] > 0.0f ? 65535.0f / t.scale[i] : 0.0f;
+    }
+
+    // nearbyint (round half to even) matches the SIMD conversions
+    int32_t roundToInt(float v) { return static_cast<int32_t>(std::nearbyint(v)); }
+
+    void quantizeOne(Vertex const& v, QuantizedVertex& q, QuantizationTransform const& t,
+        const float inv[3]) {
+        for (int i = 0; i < 3; ++i) {
+            const float u = std::clamp((v.position[i] - t.offset[i]) * inv[i], 0.0f, 65535.0f);
+            q.position[i] = static_cast<uint16_t>(roundToInt(u));
+        }
+        q.position[3] = 0;
+
+        // octahedral: project onto |x|+|y|+|z| = 1, fold the lower hemisphere
+        const float l1 = std::abs(v.normal[0]) + std::abs(v.normal[1]) + std::abs(v.normal[2]);
+        float ox = l1 > 0.0f ? v.normal[0] / l1 : 0.0f;
+        float oy = l1 > 0.0f ? v.normal[1] / l1 : 0.0f;
+        if (v.normal[2] < 0.0f) {
+            const float fx = (1.0f - std::abs(oy)) * (ox >= 0.0f ? 1.0f : -1.0f);
+            const float fy = (1.0f - std::abs(ox)) * (oy >= 0.0f ? 1.0f : -1.0f);
+            ox = fx;
+            oy = fy;
+        }
+        q.normal[0] = static_cast<int16_t>(roundToInt(std::clamp(ox, -1.0f, 1.0f) * 32767.0f));
+        q.normal[1] = static_cast<int16_t>(roundToInt(std::clamp(oy, -1.0f, 1.0f) * 32767.0f));
+
+        q.uv[0] = Core::Geometry::floatToHalf(v.uv[0]);
+        q.uv[1] = Core::Geometry::floatToHalf(v.uv[1]);
+    }
+
+#if CORE_SIMD_SSE2
+    // Four vertices per iteration. Two 4x4 transposes turn the interleaved
+    // rows (px py pz nx | ny nz u v) into columns; positions and normals are
+    // then encoded lane-parallel. Halves stay scalar (F16C isn't baseline).
+    void quantize4(const Vertex* v, QuantizedVertex* q, QuantizationTransform const& t,
+        const float inv[3]) {
+        __m128 px = _mm_loadu_ps(v[0].position), py = _mm_loadu_ps(v[1].position);
+        __m128 pz = _mm_loadu_ps(v[2].position), nx = _mm_loadu_ps(v[3].position);
+        _MM_TRANSPOSE4_PS(px, py, pz, nx);
+        __m128 ny = _mm_loadu_ps(&v[0].normal[1]), nz = _mm_loadu_ps(&v[1].normal[1]);
+        __m128 uu = _mm_loadu_ps(&v[2].normal[1]), vv = _mm_loadu_ps(&v[3].normal[1]);
+        _MM_TRANSPOSE4_PS(ny, nz, uu, vv);
+
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        const __m128 maxU = _mm_set1_ps(65535.0f);
+        const auto unorm = [&] (__m128 p, int axis) {
+            __m128 u = _mm_mul_ps(_mm_sub_ps(p, _mm_set1_ps(t.offset[axis])), _mm_set1_ps(inv[axis]));
+            return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(u, zero), maxU));
+        };
+        alignas(16) int32_t qx[4], qy[4], qz[4], ox[4], oy[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(qx), unorm(px, 0));
+        _mm_store_si128(reinterpret_cast<__m128i*>(qy), unorm(py, 1));
+        _mm_store_si128(reinterpret_cast<__m128i*>(qz), unorm(pz, 2));
+
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const auto abs = [&] (__m128 a) { return _mm_andnot_ps(signBit, a); };
+        // +1 for x >= 0 (including -0 like the scalar path), -1 otherwise
+        const auto signOf = [&] (__m128 a) {
+            return _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(a, zero), signBit), one);
+        };
+        const __m128 l1 = _mm_add_ps(_mm_add_ps(abs(nx), abs(ny)), abs(nz));
+        const __m128 valid = _mm_cmpgt_ps(l1, zero);
+        // divide rather than multiply by a reciprocal: bit-identical to scalar
+        const __m128 divisor = _mm_or_ps(_mm_and_ps(valid, l1), _mm_andnot_ps(valid, one));
+        __m128 ex = _mm_and_ps(valid, _mm_div_ps(nx, divisor));
+        __m128 ey = _mm_and_ps(valid, _mm_div_ps(ny, divisor));
+        const __m128 fx = _mm_mul_ps(_mm_sub_ps(one, abs(ey)), signOf(ex));
+        const __m128 fy = _mm_mul_ps(_mm_sub_ps(one, abs(ex)), signOf(ey));
+        const __m128 lower = _mm_cmplt_ps(nz, zero);
+        ex = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, ex));
+        ey = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, ey));
+        const __m128 snorm = _mm_set1_ps(32767.0f), minusOne = _mm_set1_ps(-1.0f);
+        const auto toSnorm = [&] (__m128 a) {
+            return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(a, minusOne), one), snorm));
+        };
+        _mm_store_si128(reinterpret_cast<__m128i*>(ox), toSnorm(ex));
+        _mm_store_si128(reinterpret_cast<__m128i*>(oy), toSnorm(ey));
+
+        alignas(16) float us[4], vs[4];
+        _mm_store_ps(us, uu);
+        _mm_store_ps(vs, vv);
+        for (int i = 0; i < 4; ++i) {
+            q[i].position[0] = static_cast<uint16_t>(qx[i]);
+            q[i].position[1] = static_cast<uint16_t>(qy[i]);
+            q[i].position[2] = static_cast<uint16_t>(qz[i]);
+            q[i].position[3] = 0;
+            q[i].normal[0] = static_cast<int16_t>(ox[i]);
+            q[i].normal[1] = static_cast<int16_t>(oy[i]);
+            q[i].uv[0] = Core::Geometry::floatToHalf(us[i]);
+            q[i].uv[1] = Core::Geometry::floatToHalf(vs[i]);
+        }
+    }
+#elif CORE_SIMD_NEON
+    void transpose(float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3) {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1), t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    void quantize4(const Vertex* v, QuantizedVertex* q, QuantizationTransform const& t,
+        const float inv[3]) {
+        float32x4_t px = vld1q_f32(v[0].position), py = vld1q_f32(v[1].position);
+        float32x4_t pz = vld1q_f32(v[2].position), nx = vld1q_f32(v[3].position);
+        transpose(px, py, pz, nx);
+        float32x4_t ny = vld1q_f32(&v[0].normal[1]), nz = vld1q_f32(&v[1].normal[1]);
+        float32x4_t uu = vld1q_f32(&v[2].normal[1]), vv = vld1q_f32(&v[3].normal[1]);
+        transpose(ny, nz, uu, vv);
+
+        const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f);
+        const auto unorm = [&] (float32x4_t p, int axis) {
+            const float32x4_t u = vmulq_n_f32(vsubq_f32(p, vdupq_n_f32(t.offset[axis])), inv[axis]);
+            return vcvtnq_s32_f32(vminq_f32(vmaxq_f32(u, zero), vdupq_n_f32(65535.0f)));
+        };
+        int32_t qx[4], qy[4], qz[4], ox[4], oy[4];
+        vst1q_s32(qx, unorm(px, 0));
+        vst1q_s32(qy, unorm(py, 1));
+        vst1q_s32(qz, unorm(pz, 2));
+
+        const auto signOf = [&] (float32x4_t a) {
+            return vbslq_f32(vcltq_f32(a, zero), vdupq_n_f32(-1.0f), one);
+        };
+        const float32x4_t l1 = vaddq_f32(vaddq_f32(vabsq_f32(nx), vabsq_f32(ny)), vabsq_f32(nz));
+        const uint32x4_t valid = vcgtq_f32(l1, zero);
+        const float32x4_t divisor = vbslq_f32(valid, l1, one);
+        float32x4_t ex = vbslq_f32(valid, vdivq_f32(nx, divisor), zero);
+        float32x4_t ey = vbslq_f32(valid, vdivq_f32(ny, divisor), zero);
+        const float32x4_t fx = vmulq_f32(vsubq_f32(one, vabsq_f32(ey)), signOf(ex));
+        const float32x4_t fy = vmulq_f32(vsubq_f32(one, vabsq_f32(ex)), signOf(ey));
+        const uint32x4_t lower = vcltq_f32(nz, zero);
+        ex = vbslq_f32(lower, fx, ex);
+        ey = vbslq_f32(lower, fy, ey);
+        const auto toSnorm = [&] (float32x4_t a) {
+            return vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(a, vdupq_n_f32(-1.0f)), one), 32767.0f));
+        };
+        vst1q_s32(ox, toSnorm(ex));
+        vst1q_s32(oy, toSnorm(ey));
+
+        float us[4], vs[4];
+        vst1q_f32(us, uu);
+        vst1q_f32(vs, vv);
+        for (int i = 0; i < 4; ++i) {
+            q[i].position[0] = static_cast<uint16_t>(qx[i]);
+            q[i].position[1] = static_cast<uint16_t>(qy[i]);
+            q[i].position[2] = static_cast<uint16_t>(qz[i]);
+            q[i].position[3] = 0;
+            q[i].normal[0] = static_cast<int16_t>(ox[i]);
+            q[i].normal[1] = static_cast<int16_t>(oy[i]);
+            q[i].uv[0] = Core::Geometry::floatToHalf(us[i]);
+            q[i].uv[1] = Core::Geometry::floatToHalf(vs[i]);
+        }
+    }
+#endif
+
+} // namespace
+
+Core::Geometry::QuantizationTransform Core::Geometry::quantizationTransform(Bounds const& bounds) {
+    QuantizationTransform t{};
+    for (int i = 0; i < 3; ++i) {
+        t.offset[i] = bounds.min[i];
+        t.scale[i] = std::max(bounds.max[i] - bounds.min[i], 0.0f);
+    }
+    return t;
+}
+
+void Core::Geometry::quantizeVerticesScalar(std::span<const Vertex> vertices,
+    std::span<QuantizedVertex> out, QuantizationTransform const& transform) {
+    if (out.size() < vertices.size())
+        throw std::runtime_error("quantizeVertices: output too small");
+    float inv[3];
+    inverseScale(transform, inv);
+    for (size_t i = 0; i < vertices.size(); ++i)
+        quantizeOne(vertices[i], out[i], transform, inv);
+}
+
+void Core::Geometry::quantizeVertices(std::span<const Vertex> vertices,
+    std::span<QuantizedVertex> out, QuantizationTransform const& transform) {
+#if CORE_SIMD_SSE2 || CORE_SIMD_NEON
+    if (out.size() < vertices.size())
+        throw std::runtime_error("quantizeVertices: output too small");
+    float inv[3];
+    inverseScale(transform, inv);
+    size_t i = 0;
+    for (; i + 4 <= vertices.size(); i += 4)
+        quantize4(&vertices[i], &out[i], transform, inv);
+    for (; i < vertices.size(); ++i)
+        quantizeOne(vertices[i], out[i], transform, inv);
+#else
+    quantizeVerticesScalar(vertices, out, transform);
+#endif
+}
+
+Core::Geometry::Vertex Core::Geometry::dequantize(QuantizedVertex const& q,
+    QuantizationTransform const& transform) {
+    Vertex v{};
+    for (int i = 0; i < 3; ++i)
+        v.position[i] = transform.offset[i] + float(q.position[i]) / 65535.0f * transform.scale[i];
+
+    // snorm decode clamps -32768 to -1, as the R16G16_SNORM fetch does
+    const float ex = std::max(float(q.normal[0]) / 32767.0f, -1.0f);
+    const float ey = std::max(float(q.normal[1]) / 32767.0f, -1.0f);
+    float n[3] = { ex, ey, 1.0f - std::abs(ex) - std::abs(ey) };
+    const float fold = std::max(-n[2], 0.0f);
+    n[0] += n[0] >= 0.0f ? -fold : fold;
+    n[1] += n[1] >= 0.0f ? -fold : fold;
+    const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (int i = 0; i < 3; ++i)
+        v.normal[i] = n[i] / len;
+
+    v.uv[0] = halfToFloat(q.uv[0]);
+    v.uv[1] = halfToFloat(q.uv[1]);
+    return v;
+}
+
+uint16_t Core::Geometry::floatToHalf(float value) {
+    uint32_t x = std::bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    x &= 0x7fffffff;
+    if (x > 0x7f800000)
+        return sign | 0x7e00;                     // NaN
+    if (x >= 0x477ff000)
+        return sign | 0x7c00;                     // rounds past 65504: infinity
+    if (x < 0x38800000) {
+        // subnormal half: value / 2^-24, exact scaling then round to even
+        return sign | static_cast<uint16_t>(std::nearbyint(std::bit_cast<float>(x) * 16777216.0f));
+    }
+    // rebias the exponent (127 -> 15) and round the mantissa to even
+    x += 0xfff + ((x >> 13) & 1);
+    return sign | static_cast<uint16_t>((x - 0x38000000) >> 13);
+}
+
+float Core::Geometry::halfToFloat(uint16_t h) {
+    const uint32_t sign = uint32_t(h & 0x8000) << 16, exponent = (h >> 10) & 0x1f, mantissa = h & 0x3ff;
+    if (exponent == 0)
+        return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(float(mantissa) / 16777216.0f));
+    if (exponent == 31)
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
@@ -0,0 +1,46 @@
+#include <Core/Memory/Buffer.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <stdexcept>
+
+Core::Memory::Buffer::Buffer(Device& device, vk::DeviceSize size,
+    vk::BufferUsageFlags usage, vk::MemoryPropertyFlags required,
+    vk::MemoryPropertyFlags preferred)
+    : size_(size) {
+    vk::BufferCreateInfo bufferInfo{
+        .size = size,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive };
+    buffer_ = vk::raii::Buffer(device.vkDevice(), bufferInfo,
+        hostCallbacks(HostTag::Memory));
+
+    const auto requirements = buffer_.getMemoryRequirements();
+
+    // try required|preferred first (e.g. ReBAR: device-local + host-visible)
+    uint32_t typeIndex = device.findMemoryType(requirements.memoryTypeBits,
+        required | preferred);
+    if (typeIndex == UINT32_MAX)
+        typeIndex = device.findMemoryType(requirements.memoryTypeBits, required);
+    if (typeIndex == UINT32_MAX)
+        throw std::runtime_error("failed to find a suitable memory type for buffer!");
+
+    const bool wantsAddress =
+        !!(usage & vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    vk::MemoryAllocateFlagsInfo flagsInfo{
+        .flags = vk::MemoryAllocateFlagBits::eDeviceAddress };
+    vk::MemoryAllocateInfo allocInfo{
+        .pNext = wantsAddress ? &flagsInfo : nullptr,
+        .allocationSize = requirements.size,
+        .memoryTypeIndex = typeIndex };
+    memory_ = vk::raii::DeviceMemory(device.vkDevice(), allocInfo,
+        hostCallbacks(HostTag::Memory));
+    buffer_.bindMemory(*memory_, 0);
+
+    memoryFlags_ = device.memoryProperties().memoryTypes[typeIndex].propertyFlags;
+    if (memoryFlags_ & vk::MemoryPropertyFlagBits::eHostVisible)
+        mapped_ = memory_.mapMemory(0, vk::WholeSize);
+
+    if (wantsAddress)
+        address_ = device.vkDevice().getBufferAddress(
+            vk::BufferDeviceAddressInfo{ .buffer = *buffer_ });
+}
@@ -0,0 +1,79 @@
+#include <Core/Memory/FrameAllocator.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+Core::Memory::FrameAllocator::FrameAllocator(Device& device,
+    vk::DeviceSize bytesPerFrame, uint32_t framesInFlight)
+    : device_(&device), framesInFlight_(framesInFlight) {
+    if (framesInFlight == 0)
+        throw std::runtime_error("FrameAllocator needs at least one frame in flight");
+
+    // one granularity for everything, so a block can be bound as either a
+    // dynamic uniform or a dynamic storage buffer
+    const auto& limits = device.limits();
+    alignment_ = std::max<vk::DeviceSize>({ limits.minUniformBufferOffsetAlignment,
+        limits.minStorageBufferOffsetAlignment, 16 });
+    slotSize_ = alignUp(bytesPerFrame, alignment_);
+
+    const vk::DeviceSize total = slotSize_ * framesInFlight;
+    if (total > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("FrameAllocator too large for 32-bit dynamic offsets");
+
+    buffer_ = Buffer(device, total,
+        vk::BufferUsageFlagBits::eUniformBuffer |
+        vk::BufferUsageFlagBits::eStorageBuffer |
+        vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+        vk::MemoryPropertyFlagBits::eHostCoherent,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    slots_.reserve(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+        slots_.push_back(std::make_unique<LinearAllocator>(slotSize_, alignment_));
+    slotFrame_.assign(framesInFlight, 0);
+}
+
+void Core::Memory::FrameAllocator::beginFrame(uint64_t frameNumber,
+    vk::raii::Semaphore const& timeline) {
+    if (frameNumber == 0)
+        throw std::runtime_error("FrameAllocator: frame numbers start at 1");
+    const uint32_t slot = static_cast<uint32_t>(frameNumber % framesInFlight_);
+    const uint64_t retireValue = slotFrame_[slot];
+
+    // retireValue == frameNumber: beginFrame() retried for a frame that was
+    // never submitted (e.g. the swapchain went out of date)
+    if (retireValue != 0 && retireValue < frameNumber &&
+        timeline.getCounterValue() < retireValue) {
+        vk::SemaphoreWaitInfo waitInfo{
+            .semaphoreCount = 1,
+            .pSemaphores = &*timeline,
+            .pValues = &retireValue };
+        if (device_->vkDevice().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+            throw std::runtime_error("FrameAllocator: waiting for frame retirement failed");
+    }
+
+    slotFrame_[slot] = frameNumber;
+    current_ = slot;
+    slots_[slot]->reset();
+}
+
+Core::Memory::FrameAllocation
+Core::Memory::FrameAllocator::allocate(vk::DeviceSize size) {
+    const uint64_t offset = slots_[current_]->allocate(size);
+    if (offset == LinearAllocator::kInvalid)
+        return {};
+
+    const vk::DeviceSize absolute = current_ * slotSize_ + offset;
+    return FrameAllocation{
+        .cpu = static_cast<std::byte*>(buffer_.mapped()) + absolute,
+        .buffer = buffer_.handle(),
+        .dynamicOffset = static_cast<uint32_t>(absolute),
+        .size = size,
+        .address = buffer_.address() + absolute };
+}
+
+vk::DeviceSize Core::Memory::FrameAllocator::bytesUsed() const noexcept {
+    return std::min<vk::DeviceSize>(slots_[current_]->used(), slotSize_);
+}
@@ -0,0 +1,266 @@
+#include <Core/Memory/HostAllocator.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+    // Sits right before every pointer handed to Vulkan.
+    struct alignas(16) Header {
+        uint64_t size;      // requested size
+        uint32_t offset;    // user pointer - block start
+        uint8_t sizeClass;  // kLarge for malloc'd blocks
+        uint8_t tag;
+        uint8_t scope;
+        uint8_t pad;
+    };
+    static_assert(sizeof(Header) == 16);
+
+    constexpr uint8_t kLarge = 0xff;
+    constexpr size_t kMinClassShift = 4;      // 16 B
+    constexpr size_t kChunkBytes = 64 * 1024;
+
+    size_t blockBytes(size_t size, size_t alignment) {
+        // worst case padding to reach `alignment` past the header
+        return sizeof(Header) + size + (alignment > alignof(Header) ? alignment : 0);
+    }
+
+    size_t classFor(size_t bytes) {
+        const size_t shift = std::bit_width(std::max<size_t>(bytes, 16) - 1);
+        return shift - kMinClassShift;
+    }
+
+    char* alignUp(char* p, size_t alignment) {
+        const auto v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((v + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    }
+
+} // namespace
+
+// Fixed-size blocks carved out of 64 KiB chunks, one mutex per class.
+struct Core::Memory::HostAllocator::Pool {
+    explicit Pool(size_t blockSize) : blockSize(blockSize) {}
+
+    void* take() {
+        std::lock_guard lock(mutex);
+        if (!freeList) grow();
+        if (!freeList) return nullptr;
+        void* block = freeList;
+        freeList = *static_cast<void**>(freeList);
+        return block;
+    }
+
+    void give(void* block) {
+        std::lock_guard lock(mutex);
+        *static_cast<void**>(block) = freeList;
+        freeList = block;
+    }
+
+    void grow() {
+        const size_t bytes = std::max(kChunkBytes, blockSize);
+        char* chunk = static_cast<char*>(std::malloc(bytes));
+        if (!chunk) return;
+        for (size_t offset = 0; offset + blockSize <= bytes; offset += blockSize)
+            give_unlocked(chunk + offset);
+    }
+
+    void give_unlocked(void* block) {
+        *static_cast<void**>(block) = freeList;
+        freeList = block;
+    }
+
+    const size_t blockSize;
+    std::mutex mutex;
+    void* freeList = nullptr;
+};
+
+const char* Core::Memory::toString(HostTag tag) {
+    switch (tag) {
+        case HostTag::Instance:  return "instance";
+        case HostTag::Device:    return "device";
+        case HostTag::Swapchain: return "swapchain";
+        case HostTag::Shader:    return "shader";
+        case HostTag::Pipeline:  return "pipeline";
+        case HostTag::Memory:    return "memory";
+        case HostTag::Commands:  return "commands";
+        case HostTag::Sync:      return "sync";
+        case HostTag::Query:     return "query";
+        case HostTag::Other:     return "other";
+        case HostTag::Count:     break;
+    }
+    return "?";
+}
+
+Core::Memory::HostAllocator& Core::Memory::HostAllocator::instance() {
+    // intentionally leaked: objects destroyed during static destruction may
+    // still call back into it
+    static HostAllocator* allocator = new HostAllocator();
+    return *allocator;
+}
+
+Core::Memory::HostAllocator::HostAllocator() {
+    for (size_t i = 0; i < kSizeClasses; ++i)
+        pools_[i] = new Pool(size_t(1) << (i + kMinClassShift));
+
+    for (size_t i = 0; i < tagStates_.size(); ++i) {
+        tagStates_[i] = { this, static_cast<HostTag>(i) };
+        callbacks_[i] = VkAllocationCallbacks{
+            .pUserData = &tagStates_[i],
+            .pfnAllocation = &vkAllocate,
+            .pfnReallocation = &vkReallocate,
+            .pfnFree = &vkFree,
+            .pfnInternalAllocation = &vkInternalAllocate,
+            .pfnInternalFree = &vkInternalFree };
+    }
+}
+
+const vk::AllocationCallbacks* Core::Memory::HostAllocator::callbacks(HostTag tag) const noexcept {
+    if (!enabled_.load(std::memory_order_relaxed))
+        return nullptr;
+    return reinterpret_cast<const vk::AllocationCallbacks*>(&callbacks_[static_cast<size_t>(tag)]);
+}
+
+void* Core::Memory::HostAllocator::allocate(size_t size, size_t alignment, HostTag tag,
+    vk::SystemAllocationScope scope) {
+    if (size == 0)
+        return nullptr;
+    alignment = std::max(alignment, alignof(Header));
+
+    const size_t bytes = blockBytes(size, alignment);
+    char* block;
+    uint8_t sizeClass;
+    if (bytes <= kMaxPooled) {
+        sizeClass = static_cast<uint8_t>(classFor(bytes));
+        block = static_cast<char*>(pools_[sizeClass]->take());
+    } else {
+        sizeClass = kLarge;
+        block = static_cast<char*>(std::malloc(bytes));
+    }
+    if (!block)
+        return nullptr; // Vulkan turns this into VK_ERROR_OUT_OF_HOST_MEMORY
+
+    char* user = alignUp(block + sizeof(Header), alignment);
+    auto* header = reinterpret_cast<Header*>(user) - 1;
+    *header = Header{ size, static_cast<uint32_t>(user - block), sizeClass,
+        static_cast<uint8_t>(tag), static_cast<uint8_t>(scope), 0 };
+
+    tagCounters_[static_cast<size_t>(tag)].add(size);
+    scopeCounters_[static_cast<size_t>(scope)].add(size);
+    return user;
+}
+
+void* Core::Memory::HostAllocator::reallocate(void* original, size_t size, size_t alignment,
+    HostTag tag, vk::SystemAllocationScope scope) {
+    if (!original)
+        return allocate(size, alignment, tag, scope);
+    if (size == 0) {
+        free(original);
+        return nullptr;
+    }
+    const auto* header = static_cast<Header*>(original) - 1;
+    void* fresh = allocate(size, alignment, tag, scope);
+    if (!fresh)
+        return nullptr; // original stays valid, as the spec requires
+    std::memcpy(fresh, original, std::min<size_t>(size, header->size));
+    free(original);
+    return fresh;
+}
+
+void Core::Memory::HostAllocator::free(void* memory) noexcept {
+    if (!memory)
+        return;
+    const Header header = *(static_cast<Header*>(memory) - 1);
+    tagCounters_[header.tag].remove(header.size);
+    scopeCounters_[header.scope].remove(header.size);
+
+    char* block = static_cast<char*>(memory) - header.offset;
+    if (header.sizeClass == kLarge)
+        std::free(block);
+    else
+        pools_[header.sizeClass]->give(block);
+}
+
+void Core::Memory::HostAllocator::Counters::add(uint64_t size) noexcept {
+    const uint64_t now = bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (now > peak && !peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+void Core::Memory::HostAllocator::Counters::remove(uint64_t size) noexcept {
+    bytes.fetch_sub(size, std::memory_order_relaxed);
+    count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Core::Memory::HostAllocationStats Core::Memory::HostAllocator::Counters::load() const noexcept {
+    return { bytes.load(std::memory_order_relaxed), count.load(std::memory_order_relaxed),
+        peakBytes.load(std::memory_order_relaxed), total.load(std::memory_order_relaxed) };
+}
+
+Core::Memory::HostAllocationStats Core::Memory::HostAllocator::stats(HostTag tag) const noexcept {
+    return tagCounters_[static_cast<size_t>(tag)].load();
+}
+
+Core::Memory::HostAllocationStats
+Core::Memory::HostAllocator::stats(vk::SystemAllocationScope scope) const noexcept {
+    return scopeCounters_[static_cast<size_t>(scope)].load();
+}
+
+Core::Memory::HostAllocationStats Core::Memory::HostAllocator::internalStats() const noexcept {
+    return internal_.load();
+}
+
+std::string Core::Memory::HostAllocator::report() const {
+    std::ostringstream oss;
+    const auto row = [&] (const char* name, HostAllocationStats const& s) {
+        if (s.totalAllocations == 0) return;
+        oss << "  " << std::left << std::setw(12) << name << std::right
+            << std::setw(12) << s.bytes << std::setw(8) << s.count
+            << std::setw(12) << s.peakBytes << std::setw(10) << s.totalAllocations << '\n';
+    };
+    oss << "vulkan host allocations\n  " << std::left << std::setw(12) << "tag" << std::right
+        << std::setw(12) << "live B" << std::setw(8) << "live" << std::setw(12) << "peak B"
+        << std::setw(10) << "total" << '\n';
+    for (size_t i = 0; i < tagCounters_.size(); ++i)
+        row(toString(static_cast<HostTag>(i)), tagCounters_[i].load());
+    for (size_t i = 0; i < scopeCounters_.size(); ++i) {
+        const auto scope = static_cast<vk::SystemAllocationScope>(i);
+        row(("scope:" + vk::to_string(scope)).c_str(), scopeCounters_[i].load());
+    }
+    row("internal", internal_.load());
+    return oss.str();
+}
+
+VKAPI_ATTR void* VKAPI_CALL Core::Memory::HostAllocator::vkAllocate(void* user, size_t size,
+    size_t alignment, VkSystemAllocationScope scope) {
+    auto* state = static_cast<TagState*>(user);
+    return state->owner->allocate(size, alignment, state->tag,
+        static_cast<vk::SystemAllocationScope>(scope));
+}
+
+VKAPI_ATTR void* VKAPI_CALL Core::Memory::HostAllocator::vkReallocate(void* user, void* original,
+    size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    auto* state = static_cast<TagState*>(user);
+    return state->owner->reallocate(original, size, alignment, state->tag,
+        static_cast<vk::SystemAllocationScope>(scope));
+}
+
+VKAPI_ATTR void VKAPI_CALL Core::Memory::HostAllocator::vkFree(void* user, void* memory) {
+    static_cast<TagState*>(user)->owner->free(memory);
+}
+
+VKAPI_ATTR void VKAPI_CALL Core::Memory::HostAllocator::vkInternalAllocate(void* user, size_t size,
+    VkInternalAllocationType, VkSystemAllocationScope) {
+    static_cast<TagState*>(user)->owner->internal_.add(size);
+}
+
+VKAPI_ATTR void VKAPI_CALL Core::Memory::HostAllocator::vkInternalFree(void* user, size_t size,
+    VkInternalAllocationType, VkSystemAllocationScope) {
+    static_cast<TagState*>(user)->owner->internal_.remove(size);
+}
@@ -0,0 +1,49 @@
+#include <Core/Memory/Image.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <bit>
+#include <stdexcept>
+
+Core::Memory::Image::Image(Device& device, vk::Format format, vk::Extent2D extent,
+    uint32_t mipLevels, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect)
+    : format_(format), extent_(extent), mipLevels_(mipLevels), aspect_(aspect) {
+    if (extent.width == 0 || extent.height == 0 || mipLevels == 0)
+        throw std::runtime_error("Image: empty extent or mip chain");
+
+    image_ = vk::raii::Image(device.vkDevice(), vk::ImageCreateInfo{
+        .imageType = vk::ImageType::e2D,
+        .format = format,
+        .extent = { extent.width, extent.height, 1 },
+        .mipLevels = mipLevels,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined },
+        hostCallbacks(HostTag::Memory));
+
+    const auto requirements = image_.getMemoryRequirements();
+    const uint32_t typeIndex = device.findMemoryType(requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (typeIndex == UINT32_MAX)
+        throw std::runtime_error("failed to find a suitable memory type for image!");
+
+    memory_ = vk::raii::DeviceMemory(device.vkDevice(), vk::MemoryAllocateInfo{
+        .allocationSize = requirements.size,
+        .memoryTypeIndex = typeIndex },
+        hostCallbacks(HostTag::Memory));
+    image_.bindMemory(*memory_, 0);
+    memorySize_ = requirements.size;
+
+    view_ = vk::raii::ImageView(device.vkDevice(), vk::ImageViewCreateInfo{
+        .image = *image_,
+        .viewType = vk::ImageViewType::e2D,
+        .format = format,
+        .subresourceRange = range() },
+        hostCallbacks(HostTag::Memory));
+}
+
+uint32_t Core::Memory::Image::fullMipCount(vk::Extent2D extent) noexcept {
+    return static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)));
+}
@@ -0,0 +1,338 @@
+#include <Core/Memory/ReadbackManager.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    constexpr vk::DeviceSize kMinStagingBytes = 64 * 1024;
+
+    float halfToFloat(uint16_t h) {
+        const uint32_t sign = (h >> 15) & 1, exponent = (h >> 10) & 0x1f, mantissa = h & 0x3ff;
+        float value;
+        if (exponent == 0)
+            value = std::ldexp(static_cast<float>(mantissa), -24);           // subnormal
+        else if (exponent == 31)
+            value = mantissa ? NAN : INFINITY;
+        else
+            value = std::ldexp(static_cast<float>(mantissa | 0x400), static_cast<int>(exponent) - 25);
+        return sign ? -value : value;
+    }
+
+    std::byte unorm8(float v) {
+        if (!(v > 0.0f)) return std::byte{ 0 }; // also NaN
+        return static_cast<std::byte>(static_cast<uint8_t>(std::min(v, 1.0f) * 255.0f + 0.5f));
+    }
+
+} // namespace
+
+Core::Memory::ReadbackManager::ReadbackManager(Device& device, uint32_t workers,
+    vk::DeviceSize maxPooledBytes)
+    : device_(&device), maxPooledBytes_(maxPooledBytes) {
+    for (uint32_t i = 0; i < std::max(1u, workers); ++i)
+        workers_.emplace_back([this] { work(); });
+}
+
+Core::Memory::ReadbackManager::~ReadbackManager() {
+    std::deque<Request> pending;
+    {
+        std::lock_guard lock(mutex_);
+        pending.swap(pending_);
+    }
+    // shutdown is the one place that blocks on the GPU: every future resolves
+    for (auto& request : pending) {
+        try {
+            const vk::Semaphore timeline = **request.timeline;
+            const auto result = device_->vkDevice().waitSemaphores(vk::SemaphoreWaitInfo{
+                .semaphoreCount = 1,
+                .pSemaphores = &timeline,
+                .pValues = &request.value }, UINT64_MAX);
+            if (result != vk::Result::eSuccess)
+                throw std::runtime_error("ReadbackManager: timeline wait failed");
+            enqueue(std::move(request));
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+    }
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+Core::Memory::Buffer Core::Memory::ReadbackManager::acquire(vk::DeviceSize size) {
+    const vk::DeviceSize capacity = std::bit_ceil(std::max(size, kMinStagingBytes));
+    {
+        std::lock_guard lock(mutex_);
+        ++stats_.requests;
+        stats_.bytes += size;
+        if (auto it = pool_.find(capacity); it != pool_.end()) {
+            Buffer buffer = std::move(it->second);
+            pool_.erase(it);
+            stats_.pooledBytes -= capacity;
+            ++stats_.poolHits;
+            return buffer;
+        }
+        ++stats_.poolMisses;
+    }
+    // cached: the CPU reads every byte; coherent: no invalidate needed
+    return Buffer(*device_, capacity, vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        vk::MemoryPropertyFlagBits::eHostCached);
+}
+
+void Core::Memory::ReadbackManager::release(Buffer buffer) {
+    std::lock_guard lock(mutex_);
+    if (stats_.pooledBytes + buffer.size() > maxPooledBytes_)
+        return; // over budget: destroyed here
+    stats_.pooledBytes += buffer.size();
+    pool_.emplace(buffer.size(), std::move(buffer));
+}
+
+std::future<Core::Memory::ReadbackData>
+Core::Memory::ReadbackManager::readBuffer(vk::raii::CommandBuffer& cmd, vk::Buffer buffer,
+    vk::DeviceSize offset, vk::DeviceSize size,
+    vk::raii::Semaphore const& timeline, uint64_t value) {
+    Buffer staging = acquire(size);
+
+    const vk::MemoryBarrier2 before{
+        .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .srcAccessMask = vk::AccessFlagBits2::eMemoryWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferRead };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &before });
+    cmd.copyBuffer(buffer, staging.handle(),
+        vk::BufferCopy{ .srcOffset = offset, .dstOffset = 0, .size = size });
+    const vk::MemoryBarrier2 toHost{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &toHost });
+
+    Request request{ &timeline, value, std::move(staging), size, ReadbackFormat::Raw,
+        vk::Format::eUndefined, {}, {} };
+    auto future = request.promise.get_future();
+    std::lock_guard lock(mutex_);
+    pending_.push_back(std::move(request));
+    return future;
+}
+
+std::future<Core::Memory::ReadbackData>
+Core::Memory::ReadbackManager::readImage(vk::raii::CommandBuffer& cmd, vk::Image image,
+    vk::ImageLayout layout, vk::Format format, vk::Extent2D extent,
+    vk::raii::Semaphore const& timeline, uint64_t value, ReadbackFormat convertTo) {
+    std::promise<ReadbackData> promise;
+    auto future = promise.get_future();
+    readImage(cmd, image, layout, format, extent, timeline, value, convertTo, std::move(promise));
+    return future;
+}
+
+void Core::Memory::ReadbackManager::readImage(vk::raii::CommandBuffer& cmd, vk::Image image,
+    vk::ImageLayout layout, vk::Format format, vk::Extent2D extent,
+    vk::raii::Semaphore const& timeline, uint64_t value,
+    ReadbackFormat convertTo, std::promise<ReadbackData> promise) {
+    const vk::DeviceSize size =
+        vk::DeviceSize(extent.width) * extent.height * vk::blockSize(format);
+    Buffer staging = acquire(size);
+
+    const vk::ImageSubresourceRange range{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+    const vk::ImageMemoryBarrier2 toTransfer{
+        .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .srcAccessMask = vk::AccessFlagBits2::eMemoryWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+        .oldLayout = layout,
+        .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .image = image,
+        .subresourceRange = range };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toTransfer });
+
+    cmd.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, staging.handle(),
+        vk::BufferImageCopy{
+            .bufferOffset = 0,
+            .bufferRowLength = 0,   // tightly packed
+            .bufferImageHeight = 0,
+            .imageSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = { extent.width, extent.height, 1 } });
+
+    const vk::ImageMemoryBarrier2 restore{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+        .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .newLayout = layout,
+        .image = image,
+        .subresourceRange = range };
+    const vk::MemoryBarrier2 toHost{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .memoryBarrierCount = 1, .pMemoryBarriers = &toHost,
+        .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &restore });
+
+    Request request{ &timeline, value, std::move(staging), size, convertTo, format, extent,
+        std::move(promise) };
+    std::lock_guard lock(mutex_);
+    pending_.push_back(std::move(request));
+}
+
+void Core::Memory::ReadbackManager::poll() {
+    std::lock_guard lock(mutex_);
+    if (pending_.empty())
+        return;
+    // requests may come from several timelines (frames, compute batches)
+    std::unordered_map<const vk::raii::Semaphore*, uint64_t> reached;
+    bool any = false;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        auto [counter, inserted] = reached.try_emplace(it->timeline, 0);
+        if (inserted)
+            counter->second = it->timeline->getCounterValue();
+        if (it->value <= counter->second) {
+            ready_.push_back(std::move(*it));
+            it = pending_.erase(it);
+            any = true;
+        } else {
+            ++it;
+        }
+    }
+    if (any)
+        cv_.notify_all();
+}
+
+void Core::Memory::ReadbackManager::enqueue(Request request) {
+    {
+        std::lock_guard lock(mutex_);
+        ready_.push_back(std::move(request));
+    }
+    cv_.notify_one();
+}
+
+void Core::Memory::ReadbackManager::work() {
+    CORE_PROFILE_THREAD("readback");
+    for (;;) {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+        if (ready_.empty())
+            return;
+        Request request = std::move(ready_.front());
+        ready_.pop_front();
+        lock.unlock();
+
+        try {
+            CORE_PROFILE_ZONE("readback convert");
+            ReadbackData data;
+            data.format = request.convertTo;
+            data.sourceFormat = request.format;
+            data.width = request.extent.width;
+            data.height = request.extent.height;
+            const auto* mapped = static_cast<const std::byte*>(request.staging.mapped());
+            const std::span<const std::byte> bytes(mapped, request.size);
+            switch (request.convertTo) {
+                case ReadbackFormat::Raw:
+                    data.bytes.assign(bytes.begin(), bytes.end());
+                    break;
+                case ReadbackFormat::RGBA8:
+                    data.bytes = toRgba8(bytes, request.format, data.width, data.height);
+                    break;
+                case ReadbackFormat::PPM:
+                    data.bytes = encodePpm(toRgba8(bytes, request.format, data.width, data.height),
+                        data.width, data.height);
+                    break;
+            }
+            request.promise.set_value(std::move(data));
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+        release(std::move(request.staging));
+    }
+}
+
+Core::Memory::ReadbackStats Core::Memory::ReadbackManager::stats() const {
+    std::lock_guard lock(mutex_);
+    ReadbackStats s = stats_;
+    s.pending = pending_.size() + ready_.size();
+    return s;
+}
+
+std::vector<std::byte> Core::Memory::toRgba8(std::span<const std::byte> texels, vk::Format format,
+    uint32_t width, uint32_t height) {
+    const size_t count = size_t(width) * height;
+    std::vector<std::byte> out(count * 4);
+    const auto need = [&] (size_t texelBytes) {
+        if (texels.size() < count * texelBytes)
+            throw std::runtime_error("toRgba8: not enough texel data");
+    };
+
+    switch (format) {
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eR8G8B8A8Uint:
+        case vk::Format::eA8B8G8R8UnormPack32: // little-endian: R, G, B, A in memory
+        case vk::Format::eA8B8G8R8SrgbPack32:
+            need(4);
+            std::memcpy(out.data(), texels.data(), out.size());
+            break;
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+            need(4);
+            for (size_t i = 0; i < count; ++i) {
+                out[i * 4 + 0] = texels[i * 4 + 2];
+                out[i * 4 + 1] = texels[i * 4 + 1];
+                out[i * 4 + 2] = texels[i * 4 + 0];
+                out[i * 4 + 3] = texels[i * 4 + 3];
+            }
+            break;
+        case vk::Format::eR16G16B16A16Sfloat:
+            need(8);
+            for (size_t i = 0; i < count * 4; ++i) {
+                uint16_t h;
+                std::memcpy(&h, texels.data() + i * 2, sizeof(h));
+                out[i] = unorm8(halfToFloat(h));
+            }
+            break;
+        case vk::Format::eR32G32B32A32Sfloat:
+            need(16);
+            for (size_t i = 0; i < count * 4; ++i) {
+                float f;
+                std::memcpy(&f, texels.data() + i * 4, sizeof(f));
+                out[i] = unorm8(f);
+            }
+            break;
+        default:
+            throw std::runtime_error("toRgba8: unsupported format " + vk::to_string(format));
+    }
+    return out;
+}
+
+std::vector<std::byte> Core::Memory::encodePpm(std::span<const std::byte> rgba8,
+    uint32_t width, uint32_t height) {
+    const std::string header =
+        "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    const size_t count = size_t(width) * height;
+    if (rgba8.size() < count * 4)
+        throw std::runtime_error("encodePpm: not enough pixel data");
+
+    std::vector<std::byte> out(header.size() + count * 3);
+    std::memcpy(out.data(), header.data(), header.size());
+    std::byte* rgb = out.data() + header.size();
+    for (size_t i = 0; i < count; ++i) {
+        rgb[i * 3 + 0] = rgba8[i * 4 + 0];
+        rgb[i * 3 + 1] = rgba8[i * 4 + 1];
+        rgb[i * 3 + 2] = rgba8[i * 4 + 2];
+    }
+    return out;
+}
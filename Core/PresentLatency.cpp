@@ -0,0 +1,67 @@
+#include <Core/PresentLatency.h>
+#include <Core/Swapchain.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+void Core::PresentLatency::presented(uint64_t presentId,
+    Clock::time_point inputSampled, bool presentWait) {
+    onScreen_ = presentWait;
+    if (presentWait)
+        pending_.push_back({ presentId, inputSampled });
+    else
+        addSample(inputSampled, Clock::now());
+}
+
+void Core::PresentLatency::poll(Swapchain const& swapchain) {
+    // presents complete in order, so stop at the first one still queued
+    while (!pending_.empty() &&
+        swapchain.waitForPresent(pending_.front().presentId, 0)) {
+        addSample(pending_.front().inputSampled, Clock::now());
+        pending_.pop_front();
+    }
+}
+
+void Core::PresentLatency::completed(uint64_t presentId) {
+    const auto now = Clock::now();
+    while (!pending_.empty() && pending_.front().presentId <= presentId) {
+        addSample(pending_.front().inputSampled, now);
+        pending_.pop_front();
+    }
+}
+
+void Core::PresentLatency::addSample(Clock::time_point inputSampled,
+    Clock::time_point shown) {
+    samplesMs_[count_ % kWindow] =
+        std::chrono::duration<float, std::milli>(shown - inputSampled).count();
+    ++count_;
+}
+
+Core::PresentLatency::Summary Core::PresentLatency::summary() const {
+    Summary s;
+    s.samples = std::min(count_, kWindow);
+    s.onScreen = onScreen_;
+    if (s.samples == 0)
+        return s;
+
+    std::vector<float> sorted(samplesMs_.begin(), samplesMs_.begin() + s.samples);
+    std::sort(sorted.begin(), sorted.end());
+    const auto at = [&] (double q) {
+        return static_cast<double>(sorted[static_cast<size_t>(q * (sorted.size() - 1))]);
+    };
+    s.p50Ms = at(0.50);
+    s.p95Ms = at(0.95);
+    s.p99Ms = at(0.99);
+    s.maxMs = sorted.back();
+    return s;
+}
+
+std::string Core::PresentLatency::report() const {
+    const Summary s = summary();
+    std::ostringstream oss;
+    oss << "input-to-" << (s.onScreen ? "present" : "queue") << " latency over "
+        << s.samples << " frames: p50 " << s.p50Ms << " ms, p95 " << s.p95Ms
+        << " ms, p99 " << s.p99Ms << " ms, max " << s.maxMs << " ms";
+    return oss.str();
+}
@@ -0,0 +1,101 @@
+#include <Core/Profiling/GpuProfiler.h>
+#include <Core/Memory/HostAllocator.h>
+
+#include <algorithm>
+
+Core::Profiling::GpuProfiler::GpuProfiler(Device& device, uint32_t framesInFlight,
+    bool debugLabels, uint32_t maxZonesPerFrame)
+    : track_(createTrack("GPU")), capacity_(maxZonesPerFrame * 2), debugLabels_(debugLabels) {
+    const auto families = device.vkPhysicalDevice().getQueueFamilyProperties();
+    validBits_ = families[device.queues().graphicsFamily].timestampValidBits;
+    periodNs_ = device.limits().timestampPeriod;
+
+    frames_.resize(framesInFlight);
+    if (!timestampsSupported())
+        return;
+    for (auto& frame : frames_) {
+        frame.pool = vk::raii::QueryPool(device.vkDevice(), vk::QueryPoolCreateInfo{
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = capacity_ },
+            Memory::hostCallbacks(Memory::HostTag::Query));
+        frame.zones.reserve(maxZonesPerFrame);
+    }
+}
+
+Core::Profiling::GpuProfiler::~GpuProfiler() {
+    releaseTrack(track_);
+}
+
+void Core::Profiling::GpuProfiler::beginFrame(vk::raii::CommandBuffer& cmd, uint32_t slot) {
+    current_ = slot;
+    open_.clear();
+    if (!timestampsSupported())
+        return;
+    resolve(slot);
+
+    auto& frame = frames_[slot];
+    frame.zones.clear();
+    frame.used = 0;
+    cmd.resetQueryPool(*frame.pool, 0, capacity_);
+}
+
+void Core::Profiling::GpuProfiler::begin(vk::raii::CommandBuffer& cmd, const char* name) {
+    if (debugLabels_)
+        cmd.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{ .pLabelName = name });
+
+    auto& frame = frames_[current_];
+    if (!timestampsSupported() || frame.used + 2 > capacity_) {
+        open_.push_back(UINT32_MAX); // over budget: label only
+        return;
+    }
+    const uint32_t query = frame.used;
+    frame.used += 2;
+    frame.zones.push_back({ name, query, query + 1 });
+    open_.push_back(static_cast<uint32_t>(frame.zones.size() - 1));
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *frame.pool, query);
+}
+
+void Core::Profiling::GpuProfiler::end(vk::raii::CommandBuffer& cmd) {
+    if (open_.empty())
+        return;
+    const uint32_t zone = open_.back();
+    open_.pop_back();
+
+    if (zone != UINT32_MAX) {
+        auto& frame = frames_[current_];
+        cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *frame.pool,
+            frame.zones[zone].endQuery);
+    }
+    if (debugLabels_)
+        cmd.endDebugUtilsLabelEXT();
+}
+
+void Core::Profiling::GpuProfiler::resolve(uint32_t slot) {
+    auto& frame = frames_[slot];
+    if (frame.used == 0)
+        return;
+
+    auto [result, ticks] = frame.pool.getResults<uint64_t>(0, frame.used,
+        frame.used * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess)
+        return; // not ready (shouldn't happen for a retired frame): drop it
+
+    const uint64_t mask = validBits_ >= 64 ? ~0ull : (1ull << validBits_) - 1;
+    const auto toNs = [&] (uint32_t query) {
+        return static_cast<int64_t>(static_cast<double>(ticks[query] & mask) * periodNs_);
+    };
+
+    // No calibrated timestamps: the frame's work finished no later than now,
+    // so now - lastEnd is an upper bound of the clock offset. Keep the
+    // tightest bound seen; it converges within a few frames.
+    int64_t lastEnd = 0;
+    for (auto const& z : frame.zones) lastEnd = std::max(lastEnd, toNs(z.endQuery));
+    offsetNs_ = std::min(offsetNs_, static_cast<int64_t>(now()) - lastEnd);
+
+    for (auto const& z : frame.zones) {
+        const int64_t start = toNs(z.beginQuery) + offsetNs_;
+        const int64_t end = toNs(z.endQuery) + offsetNs_;
+        if (start >= 0 && end >= start)
+            recordGpu(track_, z.name, static_cast<uint64_t>(start), static_cast<uint64_t>(end));
+    }
+}
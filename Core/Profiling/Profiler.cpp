@@ -0,0 +1,241 @@
+#include <Core/Profiling/Profiler.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    struct ZoneEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Single producer (the owning thread), single consumer (the exporter).
+    class ThreadBuffer {
+    public:
+        static constexpr uint64_t kCapacity = 1u << 14;
+
+        ThreadBuffer(uint32_t tid, std::string name) : tid(tid), name(std::move(name)) {}
+
+        void push(ZoneEvent const& e) noexcept {
+            const uint64_t t = tail_.load(std::memory_order_relaxed);
+            if (t - head_.load(std::memory_order_acquire) >= kCapacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            events_[t & (kCapacity - 1)] = e;
+            tail_.store(t + 1, std::memory_order_release);
+        }
+
+        template <class F>
+        void drain(F&& f) {
+            uint64_t h = head_.load(std::memory_order_relaxed);
+            const uint64_t t = tail_.load(std::memory_order_acquire);
+            for (; h != t; ++h) f(events_[h & (kCapacity - 1)]);
+            head_.store(t, std::memory_order_release);
+        }
+
+        uint32_t tid;               // tid and name are guarded by Registry::mutex;
+        std::string name;           // both change when the buffer is recycled
+        bool active = true;
+        std::atomic<uint64_t> dropped{ 0 };
+
+    private:
+        std::array<ZoneEvent, kCapacity> events_{};
+        alignas(64) std::atomic<uint64_t> head_{ 0 };
+        alignas(64) std::atomic<uint64_t> tail_{ 0 };
+    };
+
+    struct Drained {
+        uint32_t tid;
+        ZoneEvent event;
+    };
+
+    // ~32 MB; a long session keeps its last stretch
+    constexpr size_t kMaxDrained = size_t(1) << 20;
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::vector<ThreadBuffer*> free;   // released by exited threads and tracks
+        std::deque<Drained> drained;       // the most recent kMaxDrained collected
+        uint64_t discarded = 0;            // pushed out of `drained`
+        std::vector<std::pair<uint32_t, std::string>> exitedNames;
+        uint32_t nextTid = 1;
+
+        ThreadBuffer* acquire(std::string name = {}) {
+            std::lock_guard lock(mutex);
+            const uint32_t tid = nextTid++;
+            if (name.empty()) name = "thread " + std::to_string(tid);
+            if (!free.empty()) {
+                ThreadBuffer* b = free.back();
+                free.pop_back();
+                b->tid = tid;
+                b->name = std::move(name);
+                b->active = true;
+                return b;
+            }
+            buffers.push_back(std::make_unique<ThreadBuffer>(tid, std::move(name)));
+            return buffers.back().get();
+        }
+
+        // The owning thread has exited: keep its events and name, reuse the
+        // ring for the next thread.
+        void release(ThreadBuffer* b) {
+            std::lock_guard lock(mutex);
+            drainLocked(*b);
+            exitedNames.emplace_back(b->tid, std::move(b->name));
+            b->active = false;
+            free.push_back(b);
+        }
+
+        void drainLocked(ThreadBuffer& b) {
+            b.drain([&] (ZoneEvent const& e) { drained.push_back({ b.tid, e }); });
+            if (drained.size() > kMaxDrained) {
+                const size_t excess = drained.size() - kMaxDrained;
+                drained.erase(drained.begin(), drained.begin() + static_cast<std::ptrdiff_t>(excess));
+                discarded += excess;
+            }
+        }
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    // Returns the thread's ring to the registry when the thread exits;
+    // TaskGraph and pools start threads freely.
+    struct ThreadSlot {
+        ThreadBuffer* buffer = registry().acquire();
+        ~ThreadSlot();
+    };
+
+    // trivially destructible, so still readable from later thread_local
+    // destructors that record zones
+    thread_local bool tlsExited = false;
+
+    ThreadSlot::~ThreadSlot() {
+        tlsExited = true;
+        registry().release(buffer);
+    }
+
+    ThreadBuffer* threadBuffer() {
+        if (tlsExited)
+            return nullptr;
+        thread_local ThreadSlot slot;
+        return slot.buffer;
+    }
+
+    const auto kEpoch = std::chrono::steady_clock::now();
+
+    void writeEscaped(std::ostream& os, std::string_view s) {
+        for (char c : s) {
+            switch (c) {
+                case '"':  os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                default:
+                    if (static_cast<unsigned char>(c) >= 0x20) os << c;
+            }
+        }
+    }
+
+} // namespace
+
+struct Core::Profiling::Track {
+    ThreadBuffer* buffer;
+};
+
+uint64_t Core::Profiling::now() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kEpoch).count());
+}
+
+void Core::Profiling::recordCpu(const char* name, uint64_t startNs, uint64_t endNs) noexcept {
+    if (ThreadBuffer* buffer = threadBuffer())
+        buffer->push({ name, startNs, endNs });
+}
+
+Core::Profiling::Track* Core::Profiling::createTrack(std::string name) {
+    return new Track{ registry().acquire(std::move(name)) };
+}
+
+void Core::Profiling::releaseTrack(Track* track) noexcept {
+    if (!track)
+        return;
+    registry().release(track->buffer);
+    delete track;
+}
+
+void Core::Profiling::recordGpu(Track* track, const char* name, uint64_t startNs,
+    uint64_t endNs) noexcept {
+    track->buffer->push({ name, startNs, endNs });
+}
+
+void Core::Profiling::setThreadName(std::string name) {
+    ThreadBuffer* buffer = threadBuffer();
+    if (!buffer)
+        return;
+    std::lock_guard lock(registry().mutex);
+    buffer->name = std::move(name);
+}
+
+uint64_t Core::Profiling::droppedEvents() noexcept {
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    uint64_t total = r.discarded;
+    for (auto const& b : r.buffers) total += b->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Core::Profiling::collect() {
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    for (auto const& b : r.buffers)
+        if (b->active) r.drainLocked(*b);
+}
+
+bool Core::Profiling::writeChromeTrace(const std::string& path) {
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    for (auto const& b : r.buffers)
+        if (b->active) r.drainLocked(*b);
+
+    std::ofstream os(path, std::ios::binary);
+    if (!os) return false;
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const auto threadName = [&] (uint32_t tid, std::string const& name) {
+        os << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)"
+           << tid << R"(,"args":{"name":")";
+        writeEscaped(os, name);
+        os << "\"}}";
+        first = false;
+    };
+    for (auto const& b : r.buffers)
+        if (b->active) threadName(b->tid, b->name);
+    for (auto const& [tid, name] : r.exitedNames)
+        threadName(tid, name);
+    os.precision(3);
+    os << std::fixed;
+    for (auto const& [tid, e] : r.drained) {
+        os << ",\n{\"name\":\"";
+        writeEscaped(os, e.name);
+        os << R"(","ph":"X","pid":1,"tid":)" << tid
+           << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+           << ",\"dur\":" << static_cast<double>(e.endNs - e.startNs) / 1000.0 << '}';
+    }
+    os << "\n]}\n";
+    return static_cast<bool>(os);
+}
@@ -0,0 +1,141 @@
+#include <Core/Render/CommandCache.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+
+    // epoch of an entry whose recording has not finished (or threw)
+    constexpr uint64_t kRecording = std::numeric_limits<uint64_t>::max();
+
+    double toMs(std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+} // namespace
+
+Core::Render::CommandCache::CommandCache(Device& device, uint32_t queueFamily)
+    : device_(&device) {
+    pool_ = vk::raii::CommandPool(device.vkDevice(), vk::CommandPoolCreateInfo{
+        .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = queueFamily },
+        Memory::hostCallbacks(Memory::HostTag::Commands));
+}
+
+void Core::Render::CommandCache::collect(uint64_t completedValue) {
+    auto done = std::partition(retired_.begin(), retired_.end(),
+        [completedValue] (Retired const& r) { return r.releaseAt > completedValue; });
+    for (auto it = done; it != retired_.end(); ++it)
+        free_.push_back(std::move(it->cmd));
+    retired_.erase(done, retired_.end());
+}
+
+uint64_t Core::Render::CommandCache::keyFor(CommandKey const& key,
+    RenderingInheritance const* rendering) noexcept {
+    CommandKey full = key;
+    full.add(rendering != nullptr);
+    if (rendering) {
+        full.add(rendering->colorFormats);
+        full.add(rendering->depthFormat).add(rendering->stencilFormat).add(rendering->samples);
+    }
+    return full.value();
+}
+
+vk::CommandBuffer Core::Render::CommandCache::replay(uint32_t id, uint64_t key, uint64_t frame) {
+    const auto it = entries_.find(id);
+    if (it == entries_.end())
+        return {};
+    Entry& e = it->second;
+    if (e.key != key || e.epoch != epoch_)
+        return {};
+    e.lastFrame = std::max(e.lastFrame, frame);
+    ++stats_.replays;
+    stats_.savedMs += toMs(e.recordTime);
+    return *e.cmd;
+}
+
+vk::raii::CommandBuffer Core::Render::CommandCache::acquire() {
+    if (!free_.empty()) {
+        vk::raii::CommandBuffer cmd = std::move(free_.back());
+        free_.pop_back();
+        cmd.reset();
+        return cmd;
+    }
+    auto buffers = device_->vkDevice().allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        .commandPool = *pool_,
+        .level = vk::CommandBufferLevel::eSecondary,
+        .commandBufferCount = 1 });
+    return std::move(buffers.front());
+}
+
+vk::raii::CommandBuffer& Core::Render::CommandCache::beginRecording(uint32_t id, uint64_t key,
+    uint64_t frame, RenderingInheritance const* rendering) {
+    CORE_PROFILE_ZONE("CommandCache::record");
+    Entry& e = entries_[id];
+    if (*e.cmd)
+        retired_.push_back({ std::move(e.cmd), e.lastFrame });
+    e.cmd = acquire();
+    e.key = key;
+    e.epoch = kRecording;
+    e.lastFrame = frame;
+
+    vk::CommandBufferInheritanceRenderingInfo renderingInfo{};
+    vk::CommandBufferUsageFlags flags = vk::CommandBufferUsageFlagBits::eSimultaneousUse;
+    if (rendering) {
+        renderingInfo = vk::CommandBufferInheritanceRenderingInfo{
+            .colorAttachmentCount = static_cast<uint32_t>(rendering->colorFormats.size()),
+            .pColorAttachmentFormats = rendering->colorFormats.data(),
+            .depthAttachmentFormat = rendering->depthFormat,
+            .stencilAttachmentFormat = rendering->stencilFormat,
+            .rasterizationSamples = rendering->samples };
+        flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+    }
+    const vk::CommandBufferInheritanceInfo inheritance{
+        .pNext = rendering ? &renderingInfo : nullptr };
+    e.cmd.begin(vk::CommandBufferBeginInfo{ .flags = flags, .pInheritanceInfo = &inheritance });
+    return e.cmd;
+}
+
+vk::CommandBuffer Core::Render::CommandCache::endRecording(uint32_t id,
+    std::chrono::steady_clock::duration elapsed) {
+    Entry& e = entries_.at(id);
+    e.cmd.end();
+    e.epoch = epoch_;
+    e.recordTime = elapsed;
+    ++stats_.records;
+    stats_.recordMs += toMs(elapsed);
+    return *e.cmd;
+}
+
+void Core::Render::CommandCache::invalidate() noexcept {
+    ++epoch_;
+    ++stats_.invalidations;
+}
+
+void Core::Render::CommandCache::watch(std::function<uint64_t()> generation) {
+    const uint64_t seen = generation();
+    watched_.push_back({ std::move(generation), seen });
+}
+
+void Core::Render::CommandCache::checkWatched() {
+    bool changed = false;
+    for (auto& w : watched_) {
+        const uint64_t now = w.generation();
+        changed = changed || now != w.seen;
+        w.seen = now;
+    }
+    if (changed)
+        invalidate();
+}
+
+void Core::Render::CommandCache::remove(uint32_t id) {
+    const auto it = entries_.find(id);
+    if (it == entries_.end())
+        return;
+    if (*it->second.cmd)
+        retired_.push_back({ std::move(it->second.cmd), it->second.lastFrame });
+    entries_.erase(it);
+}
@@ -0,0 +1,115 @@
+#include <Core/Render/DrawList.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+    uint64_t field(uint32_t value, uint32_t bits) {
+        return value & ((uint64_t{ 1 } << bits) - 1);
+    }
+
+    uint64_t quantizeDepth(float depth) {
+        constexpr float kMax = float((1u << Core::Render::SortKey::kDepthBits) - 1);
+        return static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * kMax + 0.5f);
+    }
+
+    // Counts the binds a recorder makes for `draws` in order, skipping binds
+    // of the state that is already current.
+    template <class Range>
+    Core::Render::DrawCounters countState(Range const& draws) {
+        Core::Render::DrawCounters out;
+        bool first = true;
+        uint32_t pipeline = 0, material = 0, mesh = 0;
+        for (auto const& d : draws) {
+            if (first || d.pipeline != pipeline) ++out.pipelineBinds;
+            if (first || d.material != material) ++out.descriptorBinds;
+            if (first || d.mesh != mesh) ++out.meshBinds;
+            pipeline = d.pipeline;
+            material = d.material;
+            mesh = d.mesh;
+            first = false;
+            ++out.draws;
+        }
+        return out;
+    }
+
+    double msSince(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+} // namespace
+
+uint64_t Core::Render::SortKey::opaque(uint32_t pipeline, uint32_t material, uint32_t mesh,
+    float depth) {
+    return field(pipeline, kPipelineBits) << (kMaterialBits + kMeshBits + kDepthBits) |
+        field(material, kMaterialBits) << (kMeshBits + kDepthBits) |
+        field(mesh, kMeshBits) << kDepthBits |
+        quantizeDepth(depth);
+}
+
+uint64_t Core::Render::SortKey::translucent(uint32_t pipeline, uint32_t material, uint32_t mesh,
+    float depth) {
+    const uint64_t farFirst = field(~static_cast<uint32_t>(quantizeDepth(depth)), kDepthBits);
+    return uint64_t{ 1 } << 63 |
+        farFirst << (kPipelineBits + kMaterialBits + kMeshBits) |
+        field(pipeline, kPipelineBits) << (kMaterialBits + kMeshBits) |
+        field(material, kMaterialBits) << kMeshBits |
+        field(mesh, kMeshBits);
+}
+
+void Core::Render::DrawList::reserve(size_t count) {
+    items_.reserve(count);
+    keys_.reserve(count);
+    order_.reserve(count);
+    instanceObjects_.reserve(count);
+}
+
+void Core::Render::DrawList::clear() {
+    items_.clear();
+    batches_.clear();
+    instanceObjects_.clear();
+    stats_ = {};
+}
+
+uint32_t Core::Render::DrawList::add(DrawItem const& item) {
+    items_.push_back(item);
+    return static_cast<uint32_t>(items_.size() - 1);
+}
+
+void Core::Render::DrawList::build(ThreadPool* pool) {
+    CORE_PROFILE_ZONE("DrawList::build");
+    const auto t0 = std::chrono::steady_clock::now();
+    stats_ = {};
+    stats_.submitted = countState(items_);
+
+    const size_t n = items_.size();
+    keys_.resize(n);
+    order_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        keys_[i] = items_[i].key;
+    std::iota(order_.begin(), order_.end(), 0u);
+    sorter_.sort(keys_, order_, pool);
+    stats_.sortMs = msSince(t0);
+
+    batches_.clear();
+    instanceObjects_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        DrawItem const& item = items_[order_[i]];
+        instanceObjects_[i] = item.object;
+        if (!batches_.empty()) {
+            DrawBatch& last = batches_.back();
+            if (last.pipeline == item.pipeline && last.material == item.material &&
+                last.mesh == item.mesh) {
+                ++last.instanceCount;
+                continue;
+            }
+        }
+        batches_.push_back({ item.pipeline, item.material, item.mesh,
+            static_cast<uint32_t>(i), 1 });
+    }
+    stats_.merged = countState(batches_);
+    stats_.buildMs = msSince(t0);
+}
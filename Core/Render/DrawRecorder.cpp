@@ -0,0 +1,49 @@
+#include <Core/Render/DrawRecorder.h>
+#include <Core/Profiling/Profiler.h>
+
+Core::Render::DrawCounters Core::Render::DrawRecorder::record(vk::raii::CommandBuffer& cmd,
+    DrawTable const& table, DrawList const& list) {
+    CORE_PROFILE_ZONE("DrawRecorder::record");
+    DrawCounters counters;
+
+    const PipelineState* pipeline = nullptr;
+    vk::PipelineLayout layout{};
+    vk::DescriptorSet material{};
+    const MeshBinding* mesh = nullptr;
+
+    for (DrawBatch const& batch : list.batches()) {
+        const PipelineState& nextPipeline = table.pipelines[batch.pipeline];
+        if (!pipeline || nextPipeline.pipeline != pipeline->pipeline) {
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, nextPipeline.pipeline);
+            ++counters.pipelineBinds;
+            pipeline = &nextPipeline;
+        }
+
+        // sets bound through an incompatible layout are disturbed
+        const vk::DescriptorSet nextMaterial = table.materials[batch.material];
+        if (nextMaterial != material || pipeline->layout != layout) {
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->layout,
+                table.materialSet, nextMaterial, nullptr);
+            ++counters.descriptorBinds;
+            material = nextMaterial;
+            layout = pipeline->layout;
+        }
+
+        const MeshBinding& nextMesh = table.meshes[batch.mesh];
+        if (!mesh || nextMesh.vertexBuffer != mesh->vertexBuffer ||
+            nextMesh.vertexBufferOffset != mesh->vertexBufferOffset) {
+            cmd.bindVertexBuffers(0, nextMesh.vertexBuffer, nextMesh.vertexBufferOffset);
+            ++counters.meshBinds;
+        }
+        if (!mesh || nextMesh.indexBuffer != mesh->indexBuffer ||
+            nextMesh.indexBufferOffset != mesh->indexBufferOffset ||
+            nextMesh.indexType != mesh->indexType)
+            cmd.bindIndexBuffer(nextMesh.indexBuffer, nextMesh.indexBufferOffset, nextMesh.indexType);
+        mesh = &nextMesh;
+
+        cmd.drawIndexed(nextMesh.indexCount, batch.instanceCount, nextMesh.firstIndex,
+            nextMesh.vertexOffset, batch.firstInstance);
+        ++counters.draws;
+    }
+    return counters;
+}
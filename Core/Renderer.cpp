@@ -1,8 +1,13 @@
 
 #include <Core/Renderer.h>
+#include <Core/Memory/HostAllocator.h>
+#include <array>
 #include <cstring>
+#include <exception>
+#include <fstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -10,16 +15,63 @@
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
-Core::Renderer::Renderer() {
-    initWindow();
-    createInstance();
+namespace {
+
+    // CommandCache ids
+    constexpr uint32_t kStaticPass = 0;
+
+    // How often drawFrame() checks shader sources for edits.
+    constexpr uint64_t kShaderPollInterval = 30;
+
+} // namespace
+
+Core::Renderer::Renderer(RendererOptions options)
+    : options_(options), pacer_(options.pacing) {
+    CORE_PROFILE_THREAD("main");
+    Memory::HostAllocator::instance().setEnabled(options_.trackHostAllocations);
+    // the loader only needs the device once get() is called; prewarm() runs
+    // while `device` is still being created
+    shaderLoader.emplace(device, options_.shaderBlobs);
+
+    // GLFW wants init and window calls on the main thread; everything else
+    // overlaps with them
+    using Affinity = TaskGraph::Affinity;
+    vk::raii::PhysicalDevice physical = nullptr;
+    TaskGraph startup;
+    const auto glfw = startup.add("glfw init", [] { glfwInit(); }, {}, Affinity::MainThread);
+    const auto win = startup.add("window", [this] { initWindow(); }, { glfw },
+        Affinity::MainThread);
+    const auto inst = startup.add("instance", [this] {
+        createInstance();
 #ifndef NDEBUG
-    setupDebugMessenger();
+        setupDebugMessenger();
 #endif
-    createSurface();
-    device = Device(instance, surface);
-    //shaderLoader.emplace(device);
-    swapchain.emplace(device, surface, *window);
+    }, { glfw });
+    const auto probe = startup.add("device probe", [this, &physical] {
+        physical = Device::selectPhysical(instance);
+    }, { inst });
+    const auto surf = startup.add("surface", [this] { createSurface(); }, { win, inst });
+    const auto dev = startup.add("logical device", [this, &physical] {
+        device = Device(instance, surface, std::move(physical));
+    }, { probe, surf });
+    // may query the framebuffer size through GLFW
+    startup.add("swapchain", [this] {
+        swapchain.emplace(device, surface, *window, options_.presentStrategy);
+    }, { dev }, Affinity::MainThread);
+    startup.add("frame resources", [this] { createFrameResources(); }, { dev });
+    startup.add("shader warmup", [this] {
+        for (auto const& key : options_.warmupShaders)
+            shaderLoader->prewarm(key);
+    });
+    startup.run();
+
+    // recordings reference swapchain formats and shader modules
+    commandCache_->watch([this] { return swapchain->generation(); });
+    commandCache_->watch([this] { return shaderLoader->generation(); });
+
+    startupReport_ = startup.report();
+    if (options_.startupReport)
+        std::cout << startupReport_;
 }
 
 void Core::Renderer::run() {
@@ -32,7 +84,8 @@ void Core::Renderer::initVulkan() {
     setupDebugMessenger();
     createSurface();
     device = Device(instance, surface);
-    swapchain.emplace(device, surface, *window);
+    swapchain.emplace(device, surface, *window, options_.presentStrategy);
+    createFrameResources();
     // I will create the Pipeline here by calling pipeline= Pipeline(...);
 }
 
@@ -40,46 +93,134 @@ void Core::Renderer::setupDebugMessenger() {
     if (!enableValidationLayers)
         return;
 
-    vk::DebugUtilsMessageSeverityFlagsEXT severityFlags(
-        vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose |
-        vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning |
-        vk::DebugUtilsMessageSeverityFlagBitsEXT::eError);
-    vk::DebugUtilsMessageTypeFlagsEXT messageTypeFlags(
-        vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral |
-        vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance |
-        vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation);
-    vk::DebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfoEXT{
-        .messageSeverity = severityFlags,
-        .messageType = messageTypeFlags,
-        .pfnUserCallback = &debugCallback };
-    debugMessenger =
-        instance.createDebugUtilsMessengerEXT(debugUtilsMessengerCreateInfoEXT);
+    // verbose and performance messages are off by default (see
+    // DebugMessageConfig); the sink formats and prints on its own thread
+    debugSink_ = std::make_unique<Debug::DebugMessageSink>(options_.debugMessages);
+    debugMessenger = instance.createDebugUtilsMessengerEXT(debugSink_->createInfo(),
+        Memory::hostCallbacks(Memory::HostTag::Other));
 }
 
 void Core::Renderer::createSurface() {
+    // the raii wrapper destroys the surface, so it has to be given the same
+    // callbacks glfw created it with
+    const auto* callbacks = Memory::hostCallbacks(Memory::HostTag::Instance);
     VkSurfaceKHR       _surface;
-    if (glfwCreateWindowSurface(*instance, window, nullptr, &_surface) != 0) {
+    if (glfwCreateWindowSurface(*instance, window,
+        reinterpret_cast<const VkAllocationCallbacks*>(callbacks), &_surface) != 0) {
         throw std::runtime_error("failed to create window surface!");
     }
-    surface = vk::raii::SurfaceKHR(instance, _surface);
+    surface = vk::raii::SurfaceKHR(instance, _surface, callbacks);
 }
 
 void Core::Renderer::initWindow() {
-    glfwInit();
-
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
     window = glfwCreateWindow(WIDTH, HEIGHT, "Vulkan", nullptr, nullptr);
+    glfwSetWindowUserPointer(window, this);
+    glfwSetFramebufferSizeCallback(window, &framebufferResizeCallback);
+    installInputCallbacks(window);
+
+    double fps = options_.targetFps;
+    if (fps <= 0.0) {
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        fps = mode && mode->refreshRate > 0 ? mode->refreshRate : 60.0;
+    }
+    pacer_.setTargetFps(fps);
+}
+
+void Core::Renderer::framebufferResizeCallback(GLFWwindow* window, int, int) {
+    auto* self = static_cast<Renderer*>(glfwGetWindowUserPointer(window));
+    self->framebufferResized_ = true;
+    self->pacer_.notifyInput();
+}
+
+void Core::Renderer::installInputCallbacks(GLFWwindow* window) {
+    // any input may change what's on screen: wake the pacer
+    static constexpr auto wake = [] (GLFWwindow* w) {
+        static_cast<Renderer*>(glfwGetWindowUserPointer(w))->pacer_.notifyInput();
+    };
+    glfwSetKeyCallback(window, [] (GLFWwindow* w, int key, int, int action, int) {
+        wake(w);
+        if (key == GLFW_KEY_F12 && action == GLFW_PRESS)
+            static_cast<Renderer*>(glfwGetWindowUserPointer(w))->screenshotRequested_ = true;
+    });
+    glfwSetCharCallback(window, [] (GLFWwindow* w, unsigned int) { wake(w); });
+    glfwSetMouseButtonCallback(window, [] (GLFWwindow* w, int, int, int) { wake(w); });
+    glfwSetCursorPosCallback(window, [] (GLFWwindow* w, double, double) { wake(w); });
+    glfwSetScrollCallback(window, [] (GLFWwindow* w, double, double) { wake(w); });
+    glfwSetWindowRefreshCallback(window, [] (GLFWwindow* w) { wake(w); });
 }
 
 void Core::Renderer::mainLoop() {
+    CORE_PROFILE_THREAD("main");
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        if (!pacer_.waitForNextFrame())
+            continue;
+        drawFrame();
+        pacer_.frameRendered();
+        saveScreenshots();
+        CORE_PROFILE_COLLECT();
     }
+    device.vkDevice().waitIdle();
+    // requested after the last recorded frame: no frame will fulfil them
+    for (auto& [format, promise] : captures_)
+        promise.set_exception(std::make_exception_ptr(
+            std::runtime_error("renderer closed before the frame was captured")));
+    captures_.clear();
+    readback_->poll();
+    for (auto& shot : screenshots_)
+        shot.wait();
+    saveScreenshots();
+}
+
+std::future<Core::Memory::ReadbackData> Core::Renderer::captureFrame(Memory::ReadbackFormat format) {
+    if (!swapchain->readable())
+        throw std::runtime_error("swapchain images do not support transfer-src readback");
+    std::promise<Memory::ReadbackData> promise;
+    auto future = promise.get_future();
+    captures_.emplace_back(format, std::move(promise));
+    return future;
+}
+
+void Core::Renderer::saveScreenshots() {
+    std::erase_if(screenshots_, [this] (std::future<Memory::ReadbackData>& shot) {
+        if (shot.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        try {
+            const auto data = shot.get();
+            const std::string path = "screenshot-" + std::to_string(screenshotCount_++) + ".ppm";
+            std::ofstream(path, std::ios::binary).write(
+                reinterpret_cast<const char*>(data.bytes.data()),
+                static_cast<std::streamsize>(data.bytes.size()));
+            std::cout << "screenshot written to " << path << '\n';
+        } catch (std::exception const& e) {
+            std::cerr << "screenshot failed: " << e.what() << '\n';
+        }
+        return true;
+    });
 }
 
 void Core::Renderer::cleanup() {
+    std::cout << latency_.report() << '\n' << pacer_.report();
+    if (debugSink_) {
+        debugSink_->flush();
+        for (auto const& m : debugSink_->stats())
+            std::cout << "validation " << m.name << ": " << m.count << " reported, "
+                      << m.printed << " printed\n";
+    }
+#if CORE_PROFILER_ENABLED
+    if (!options_.traceOutput.empty() &&
+        Profiling::writeChromeTrace(options_.traceOutput))
+        std::cout << "profile trace written to " << options_.traceOutput << '\n';
+#endif
+    if (options_.trackHostAllocations)
+        std::cout << Memory::HostAllocator::instance().report();
+    if (auto const& c = commandCache_->stats(); c.records > 0)
+        std::cout << "command cache: " << c.replays << " replays, " << c.records
+                  << " recordings (" << c.hitRate() * 100.0 << "% hit rate), "
+                  << c.invalidations << " invalidations\n";
+
     glfwDestroyWindow(window);
 
     glfwTerminate();
@@ -135,7 +276,8 @@ void Core::Renderer::createInstance() {
         .ppEnabledLayerNames = requiredLayers.data(),
         .enabledExtensionCount = static_cast<uint32_t>(requiredExtensions.size()),
         .ppEnabledExtensionNames = requiredExtensions.data() };
-    instance = vk::raii::Instance(context, createInfo);
+    instance = vk::raii::Instance(context, createInfo,
+        Memory::hostCallbacks(Memory::HostTag::Instance));
 }
 
 std::vector<const char*> Core::Renderer::getRequiredExtensions() {
@@ -149,3 +291,234 @@ std::vector<const char*> Core::Renderer::getRequiredExtensions() {
 
     return extensions;
 }
+
+void Core::Renderer::createFrameResources() {
+    vk::SemaphoreTypeCreateInfo timelineInfo{
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0 };
+    frameTimeline_ = vk::raii::Semaphore(device.vkDevice(),
+        vk::SemaphoreCreateInfo{ .pNext = &timelineInfo },
+        Memory::hostCallbacks(Memory::HostTag::Sync));
+
+    commandPool_ = vk::raii::CommandPool(device.vkDevice(), vk::CommandPoolCreateInfo{
+        .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = device.queues().graphicsFamily },
+        Memory::hostCallbacks(Memory::HostTag::Commands));
+    commandBuffers_ = device.vkDevice().allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        .commandPool = *commandPool_,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = MAX_FRAMES_IN_FLIGHT });
+
+    imageAvailable_.clear();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        imageAvailable_.emplace_back(device.vkDevice(), vk::SemaphoreCreateInfo{},
+            Memory::hostCallbacks(Memory::HostTag::Sync));
+
+    frameAllocator_.emplace(device, options_.frameAllocatorBytes, MAX_FRAMES_IN_FLIGHT);
+    readback_.emplace(device);
+    commandCache_.emplace(device, device.queues().graphicsFamily);
+
+#if CORE_PROFILER_ENABLED
+    // labels go through VK_EXT_debug_utils, which is only enabled with validation
+    gpuProfiler_.emplace(device, MAX_FRAMES_IN_FLIGHT, enableValidationLayers);
+#endif
+}
+
+void Core::Renderer::setStaticPass(StaticPass record, Render::CommandKey key) {
+    // a new recorder may record something else under the same key
+    commandCache_->remove(kStaticPass);
+    staticPass_ = std::move(record);
+    staticPassKey_ = key;
+    pacer_.requestRedraw();
+}
+
+void Core::Renderer::setPresentStrategy(PresentStrategy strategy) {
+    options_.presentStrategy = strategy;
+    swapchain->setPresentStrategy(strategy, frameNumber_);
+    latency_.dropPending();
+}
+
+void Core::Renderer::recreateSwapchain() {
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(window, &width, &height);
+    if (width == 0 || height == 0)
+        return; // minimized; acquire reports out-of-date once we're back
+
+    swapchain->recreate(frameNumber_);
+    latency_.dropPending();
+}
+
+void Core::Renderer::drawFrame() {
+    CORE_PROFILE_ZONE("frame");
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(window, &width, &height);
+    if (width == 0 || height == 0) {
+        glfwWaitEvents(); // minimized, nothing to present to
+        return;
+    }
+
+    // events were just polled, this is what the frame reacts to
+    const auto inputSampled = PresentLatency::Clock::now();
+
+    // present_wait pacing: keep at most maxQueuedPresents in the display queue
+    // (counting the one this frame will add) instead of letting it fill up
+    const uint64_t lastPresentId = swapchain->lastPresentId();
+    if (swapchain->presentWaitEnabled() && lastPresentId + 1 > options_.maxQueuedPresents) {
+        CORE_PROFILE_ZONE("wait for present");
+        const uint64_t waitId = lastPresentId + 1 - options_.maxQueuedPresents;
+        if (swapchain->waitForPresent(waitId, 1'000'000'000))
+            latency_.completed(waitId);
+    }
+    latency_.poll(*swapchain);
+
+    const uint64_t frame = frameNumber_ + 1;
+    const uint32_t slot = static_cast<uint32_t>(frame % MAX_FRAMES_IN_FLIGHT);
+
+    // the slot's command buffer and semaphore are free once its last frame retired
+    if (frame > MAX_FRAMES_IN_FLIGHT) {
+        CORE_PROFILE_ZONE("wait for frame slot");
+        const uint64_t waitValue = frame - MAX_FRAMES_IN_FLIGHT;
+        vk::SemaphoreWaitInfo waitInfo{
+            .semaphoreCount = 1,
+            .pSemaphores = &*frameTimeline_,
+            .pValues = &waitValue };
+        if (device.vkDevice().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+            throw std::runtime_error("failed to wait for frame timeline!");
+    }
+    const uint64_t completed = frameTimeline_.getCounterValue();
+    swapchain->collectRetired(completed);
+    commandCache_->collect(completed);
+    // edits bump the loader's generation, which the command cache watches;
+    // on-demand pacing still has to be told to draw them
+    if (frame % kShaderPollInterval == 0 && shaderLoader->pollAndReload())
+        pacer_.requestRedraw();
+    readback_->poll();
+    if (std::exchange(screenshotRequested_, false) && swapchain->readable())
+        screenshots_.push_back(captureFrame());
+
+    uint32_t imageIndex = 0;
+    SwapchainStatus acquired;
+    {
+        CORE_PROFILE_ZONE("acquire");
+        acquired = swapchain->acquire(*imageAvailable_[slot], imageIndex);
+    }
+    if (acquired == SwapchainStatus::OutOfDate) {
+        recreateSwapchain();
+        return;
+    }
+
+    frameAllocator_->beginFrame(frame, frameTimeline_);
+
+    auto& cmd = commandBuffers_[slot];
+    {
+        CORE_PROFILE_ZONE("record");
+        cmd.reset();
+        cmd.begin(vk::CommandBufferBeginInfo{
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        if (gpuProfiler_)
+            gpuProfiler_->beginFrame(cmd, slot);
+        recordFrame(cmd, imageIndex, frame);
+        cmd.end();
+    }
+
+    const vk::SemaphoreSubmitInfo waitInfo{
+        .semaphore = *imageAvailable_[slot],
+        .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput };
+    const std::array signalInfos{
+        vk::SemaphoreSubmitInfo{
+            .semaphore = swapchain->presentSemaphore(imageIndex),
+            .stageMask = vk::PipelineStageFlagBits2::eAllCommands },
+        vk::SemaphoreSubmitInfo{
+            .semaphore = *frameTimeline_,
+            .value = frame,
+            .stageMask = vk::PipelineStageFlagBits2::eAllCommands } };
+    const vk::CommandBufferSubmitInfo cmdInfo{ .commandBuffer = *cmd };
+    device.graphicsQueue().submit2(vk::SubmitInfo2{
+        .waitSemaphoreInfoCount = 1,
+        .pWaitSemaphoreInfos = &waitInfo,
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &cmdInfo,
+        .signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size()),
+        .pSignalSemaphoreInfos = signalInfos.data() });
+    frameNumber_ = frame;
+
+    SwapchainStatus presented;
+    {
+        CORE_PROFILE_ZONE("present");
+        presented = swapchain->present(imageIndex, swapchain->presentSemaphore(imageIndex));
+    }
+    if (presented != SwapchainStatus::OutOfDate)
+        latency_.presented(swapchain->lastPresentId(), inputSampled,
+            swapchain->presentWaitEnabled());
+
+    if (presented != SwapchainStatus::Ok || acquired == SwapchainStatus::Suboptimal ||
+        framebufferResized_) {
+        framebufferResized_ = false;
+        recreateSwapchain();
+    }
+}
+
+void Core::Renderer::recordFrame(vk::raii::CommandBuffer& cmd, uint32_t imageIndex,
+    uint64_t frame) {
+    const vk::ImageSubresourceRange colorRange{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+
+    const vk::ImageMemoryBarrier2 toAttachment{
+        .srcStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .dstStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .dstAccessMask = vk::AccessFlagBits2::eColorAttachmentWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eColorAttachmentOptimal,
+        .image = swapchain->images()[imageIndex],
+        .subresourceRange = colorRange };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &toAttachment });
+
+    CORE_PROFILE_GPU_ZONE(gpuProfiler_ ? &*gpuProfiler_ : nullptr, cmd, "main pass");
+
+    vk::ClearValue clearValue{};
+    clearValue.color.float32[3] = 1.0f;
+    const vk::RenderingAttachmentInfo colorAttachment{
+        .imageView = *swapchain->imageViews()[imageIndex],
+        .imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
+        .loadOp = vk::AttachmentLoadOp::eClear,
+        .storeOp = vk::AttachmentStoreOp::eStore,
+        .clearValue = clearValue };
+    const vk::Extent2D extent = swapchain->extent();
+    const bool cached = static_cast<bool>(staticPass_);
+    cmd.beginRendering(vk::RenderingInfo{
+        .flags = cached ? vk::RenderingFlagBits::eContentsSecondaryCommandBuffers
+                        : vk::RenderingFlags{},
+        .renderArea = vk::Rect2D{ .offset = { 0, 0 }, .extent = extent },
+        .layerCount = 1,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorAttachment });
+    if (cached) {
+        const vk::Format colorFormat = swapchain->format();
+        const Render::RenderingInheritance rendering{ .colorFormats = { &colorFormat, 1 } };
+        Render::CommandKey key = staticPassKey_;
+        key.add(extent);
+        cmd.executeCommands(commandCache_->get(kStaticPass, key, frame, &rendering,
+            [this, extent] (vk::raii::CommandBuffer& pass) { staticPass_(pass, extent); }));
+    }
+    cmd.endRendering();
+
+    // frameNumber_ is bumped after submit: this frame signals frameNumber_ + 1
+    for (auto& [format, promise] : captures_)
+        readback_->readImage(cmd, swapchain->images()[imageIndex],
+            vk::ImageLayout::eColorAttachmentOptimal, swapchain->format(), swapchain->extent(),
+            frameTimeline_, frameNumber_ + 1, format, std::move(promise));
+    captures_.clear();
+
+    const vk::ImageMemoryBarrier2 toPresent{
+        .srcStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .srcAccessMask = vk::AccessFlagBits2::eColorAttachmentWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eBottomOfPipe,
+        .oldLayout = vk::ImageLayout::eColorAttachmentOptimal,
+        .newLayout = vk::ImageLayout::ePresentSrcKHR,
+        .image = swapchain->images()[imageIndex],
+        .subresourceRange = colorRange };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &toPresent });
+}
@@ -0,0 +1,51 @@
+#include <Core/Shaders/ShaderBlobCache.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <chrono>
+#include <exception>
+
+std::shared_ptr<Core::Shaders::ShaderBlob>
+Core::Shaders::ShaderBlobCache::findOrCompile(uint64_t contentHash, Compile const& compile,
+    bool& compiled) {
+    std::promise<std::shared_ptr<ShaderBlob>> promise;
+    {
+        std::unique_lock lock(mutex_);
+        if (auto it = blobs_.find(contentHash); it != blobs_.end()) {
+            const auto pending = it->second;
+            lock.unlock();
+            compiled = false;
+            CORE_PROFILE_ZONE("wait for shader blob");
+            return pending.get();
+        }
+        blobs_.emplace(contentHash, promise.get_future().share());
+    }
+
+    try {
+        auto blob = compile();
+        promise.set_value(blob);
+        compiled = true;
+        return blob;
+    } catch (...) {
+        {
+            std::lock_guard lock(mutex_);
+            blobs_.erase(contentHash);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+std::shared_ptr<Core::Shaders::ShaderBlob>
+Core::Shaders::ShaderBlobCache::find(uint64_t contentHash) const {
+    std::lock_guard lock(mutex_);
+    const auto it = blobs_.find(contentHash);
+    if (it == blobs_.end() ||
+        it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return nullptr;
+    return it->second.get();
+}
+
+size_t Core::Shaders::ShaderBlobCache::size() const {
+    std::lock_guard lock(mutex_);
+    return blobs_.size();
+}
@@ -1,6 +1,8 @@
 #include <Core/Shaders/ShaderLoader.h>
+#include <Core/Shaders/ShaderReflection.h>
 //#include <Core/Shaders/ShaderCommon.h>      // Stage, toESh(...)
 #include <Core/Utils/Hash/Hash.h>               // Core::Hash::{fnv1a, combine64, ...}
+#include <Core/Profiling/Profiler.h>
 
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
@@ -8,6 +10,7 @@
 // IMPORTANT: use the C API default limits (since DefaultTBuiltInResource was removed)
 #include <glslang/Public/ResourceLimits.h>
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -23,6 +26,23 @@ namespace {
     };
 
     // ---------- Small utils ----------
+    // Adds its lifetime to one of the ShaderStageTimes counters.
+    class StageTimer {
+    public:
+        explicit StageTimer(uint64_t& totalNs)
+            : totalNs_(totalNs), start_(std::chrono::steady_clock::now()) {}
+        ~StageTimer() {
+            totalNs_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count());
+        }
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        uint64_t& totalNs_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
     inline std::string readWholeFile(const std::string& path) {
         std::ifstream ifs(path, std::ios::binary);
         if (!ifs) throw std::runtime_error("Failed to open file: " + path);
@@ -94,12 +114,6 @@ namespace {
         }
     };
 
-    // If you keep a registry optionsHash -> defines, look up here.
-    // For now, return empty (you can wire it later).
-    inline std::vector<std::string> lookupDefines(uint64_t /*optionsHash*/) {
-        return {};
-    }
-
     // ---------- glslang preprocess ----------
     PreprocessedSource GlslangPreprocess(const std::string& sourceText,
         const std::string& sourcePath,
@@ -213,6 +227,18 @@ namespace {
         return h;
     }
 
+    // Missing files count as unchanged: an editor saving through a rename
+    // shows up on the next poll.
+    std::chrono::file_clock::time_point newestTimestamp(const std::vector<std::string>& paths) {
+        std::chrono::file_clock::time_point newest{};
+        for (const auto& path : paths) {
+            std::error_code ec;
+            const auto t = std::filesystem::last_write_time(path, ec);
+            if (!ec && t > newest) newest = t;
+        }
+        return newest;
+    }
+
     static uint64_t makeModuleKey(uint64_t blobHash, vk::raii::Device& device) {
         // 1) Get non-RAII handle (vk::Device) via operator*()
         vk::Device vkDevWrapper = *device;
@@ -228,44 +254,78 @@ namespace {
 } // anonymous namespace
   //
 
-Core::Shaders::ShaderHandle
-Core::Shaders::ShaderLoader::get(const Core::Shaders::ShaderKey& key) {
-    // Live handle?
-    if (auto it = liveHandles_.find(key); it != liveHandles_.end())
-        return it->second;
-
+std::shared_ptr<Core::Shaders::ShaderBlob>
+Core::Shaders::ShaderLoader::loadBlob(const Core::Shaders::ShaderKey& key) {
     // 1) Read root file + preprocess with glslang
-    const std::string source = readWholeFile(key.canonicalPath);
-    const auto defines = lookupDefines(key.optionsHash); // TODO: wire your real defines
-    PreprocessedSource src = GlslangPreprocess(source, key.canonicalPath, key.stage, key.entry, defines);
+    std::string source;
+    {
+        CORE_PROFILE_ZONE("shader read");
+        StageTimer timer(stats_.times.readNs);
+        source = readWholeFile(key.canonicalPath);
+    }
+    PreprocessedSource src;
+    {
+        CORE_PROFILE_ZONE("shader preprocess");
+        StageTimer timer(stats_.times.preprocessNs);
+        src = GlslangPreprocess(source, key.canonicalPath, key.stage, key.entry, key.defines);
+    }
 
     // 2) Hash & fetch/compile blob
-    const uint64_t contentHash = computeContentHash(src, key);
-
-    std::shared_ptr<ShaderBlob> blob;
-    if (auto bit = blobCache_.find(contentHash); bit != blobCache_.end()) {
-        blob = bit->second;
+    uint64_t contentHash = 0;
+    {
+        StageTimer timer(stats_.times.hashNs);
+        contentHash = computeContentHash(src, key);
     }
-    else {
-        std::vector<uint32_t> spirv = GlslangCompileToSpv(src.text, key.stage, key.entry);
+
+    bool compiled = false;
+    auto blob = blobCache_->findOrCompile(contentHash, [&] {
+        std::vector<uint32_t> spirv;
+        {
+            CORE_PROFILE_ZONE("shader compile");
+            StageTimer timer(stats_.times.compileNs);
+            spirv = GlslangCompileToSpv(src.text, key.stage, key.entry);
+        }
 
         auto newBlob = std::make_shared<ShaderBlob>();
         newBlob->spirv = std::move(spirv);
         newBlob->dependencies = std::move(src.dependencies);
         newBlob->contentHash = contentHash;
-        // newBlob->newestTimestamp = newestTimestamp(newBlob->dependencies); // implement or stub
-         //newBlob->reflect         = reflect(newBlob->spirv);                // implement or stub
+        newBlob->newestTimestamp = newestTimestamp(newBlob->dependencies);
+        {
+            StageTimer timer(stats_.times.reflectNs);
+            newBlob->reflect = reflect(newBlob->spirv);
+        }
+        return newBlob;
+    }, compiled);
+    if (compiled) ++stats_.compiles;
+    else ++stats_.blobHits;
+    return blob;
+}
+
+void Core::Shaders::ShaderLoader::prewarm(const Core::Shaders::ShaderKey& key) {
+    CORE_PROFILE_ZONE("ShaderLoader::prewarm");
+    loadBlob(key);
+}
+
+Core::Shaders::ShaderHandle
+Core::Shaders::ShaderLoader::get(const Core::Shaders::ShaderKey& key) {
+    CORE_PROFILE_ZONE("ShaderLoader::get");
 
-        blobCache_.emplace(contentHash, newBlob);
-        blob = std::move(newBlob);
+    // Live handle?
+    if (auto it = liveHandles_.find(key); it != liveHandles_.end()) {
+        ++stats_.handleHits;
+        return it->second;
     }
 
+    std::shared_ptr<ShaderBlob> blob = loadBlob(key);
+
     // 3) Build/find module (per-device)
     std::shared_ptr<ShaderModule> module;
     const uint64_t moduleKey = makeModuleKey(blob->contentHash, device_.vkDevice());
 
     if (auto mit = moduleCache_.find(moduleKey); mit != moduleCache_.end()) {
         module = mit->second;
+        ++stats_.moduleHits;
     }
     else {
         vk::ShaderModuleCreateInfo ci{};
@@ -273,11 +333,41 @@ Core::Shaders::ShaderLoader::get(const Core::Shaders::ShaderKey& key) {
         ci.pCode = blob->spirv.data();
 
         // If you want to keep it in your own struct:
-        module = std::make_shared<ShaderModule>(device_, ci, blob->contentHash);
+        CORE_PROFILE_ZONE("shader module creation");
+        StageTimer timer(stats_.times.moduleNs);
+        module = std::make_shared<ShaderModule>(device_, ci, blob->contentHash, blob->reflect);
+        moduleCache_.emplace(moduleKey, module);
+        ++stats_.modulesCreated;
     }
 
     // 4) Handle
-    ShaderHandle handle{ std::move(module), key, 1 };
+    ShaderHandle handle{ std::move(module), key, generation_ + 1 };
     auto [it, _] = liveHandles_.emplace(key, handle);
     return it->second;
 } 
+
+bool Core::Shaders::ShaderLoader::pollAndReload() {
+    CORE_PROFILE_ZONE("ShaderLoader::pollAndReload");
+    bool changed = false;
+    for (auto it = liveHandles_.begin(); it != liveHandles_.end();) {
+        const uint64_t hash = it->second.module->blobHash;
+        const auto blob = blobCache_->find(hash);
+        if (!blob) {
+            ++it;
+            continue;
+        }
+        auto [stamp, _] = reloadStamps_.try_emplace(hash, blob->newestTimestamp);
+        const auto newest = newestTimestamp(blob->dependencies);
+        if (newest <= stamp->second) {
+            ++it;
+            continue;
+        }
+        // a touched file that preprocesses the same maps back to this blob;
+        // don't report it again
+        stamp->second = newest;
+        it = liveHandles_.erase(it);
+        changed = true;
+    }
+    if (changed) ++generation_;
+    return changed;
+}
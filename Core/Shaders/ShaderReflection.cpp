@@ -0,0 +1,250 @@
+#include <Core/Shaders/ShaderReflection.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+    // The subset of the SPIR-V grammar the walk needs (spec section 3).
+    enum Op : uint32_t {
+        OpName = 5, OpExecutionMode = 16, OpTypeInt = 21, OpTypeFloat = 22,
+        OpTypeVector = 23, OpTypeMatrix = 24, OpTypeImage = 25, OpTypeSampler = 26,
+        OpTypeSampledImage = 27, OpTypeArray = 28, OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30, OpTypePointer = 32, OpConstant = 43, OpVariable = 59,
+        OpDecorate = 71, OpMemberDecorate = 72,
+    };
+    enum Decoration : uint32_t {
+        Block = 2, BufferBlock = 3, ArrayStride = 6, MatrixStride = 7, NonWritable = 24,
+        Binding = 33, DescriptorSet = 34, Offset = 35,
+    };
+    enum StorageClass : uint32_t {
+        UniformConstant = 0, Uniform = 2, PushConstant = 9, StorageBuffer = 12,
+    };
+    constexpr uint32_t kMagic = 0x07230203;
+    constexpr uint32_t kLocalSize = 17;
+    constexpr uint32_t kDimBuffer = 5;
+
+    struct Type {
+        uint32_t op = 0;
+        std::vector<uint32_t> operands; // words after the result id
+    };
+
+    struct Decorations {
+        uint32_t set = UINT32_MAX, binding = UINT32_MAX;
+        uint32_t arrayStride = 0;
+        bool block = false, bufferBlock = false, nonWritable = false;
+    };
+
+    struct MemberDecorations {
+        uint32_t offset = 0, matrixStride = 0;
+        bool nonWritable = false;
+    };
+
+    struct Module {
+        std::unordered_map<uint32_t, Type> types;
+        std::unordered_map<uint32_t, uint32_t> constants;
+        std::unordered_map<uint32_t, Decorations> decorations;
+        std::unordered_map<uint32_t, std::vector<MemberDecorations>> members;
+        std::unordered_map<uint32_t, std::string> names;
+
+        MemberDecorations& member(uint32_t structId, uint32_t index) {
+            auto& list = members[structId];
+            if (list.size() <= index) list.resize(index + 1);
+            return list[index];
+        }
+
+        const Type& type(uint32_t id) const {
+            auto it = types.find(id);
+            if (it == types.end())
+                throw std::runtime_error("SPIR-V reflection: unknown type id " + std::to_string(id));
+            return it->second;
+        }
+
+        uint32_t arrayLength(const Type& array) const {
+            auto it = constants.find(array.operands.at(1));
+            return it != constants.end() ? it->second : 1;
+        }
+
+        // Byte size under the explicit layout decorations (Offset,
+        // ArrayStride, MatrixStride) that block members must carry.
+        uint32_t sizeOf(uint32_t id, uint32_t matrixStride = 0) const {
+            const Type& t = type(id);
+            switch (t.op) {
+                case OpTypeInt:
+                case OpTypeFloat:
+                    return t.operands.at(0) / 8;
+                case OpTypeVector:
+                    return sizeOf(t.operands.at(0)) * t.operands.at(1);
+                case OpTypeMatrix:
+                    return (matrixStride ? matrixStride : sizeOf(t.operands.at(0))) * t.operands.at(1);
+                case OpTypeArray: {
+                    const auto d = decorations.find(id);
+                    const uint32_t stride = d != decorations.end() && d->second.arrayStride
+                        ? d->second.arrayStride : sizeOf(t.operands.at(0), matrixStride);
+                    return stride * arrayLength(t);
+                }
+                case OpTypeStruct: {
+                    uint32_t size = 0;
+                    const auto m = members.find(id);
+                    for (uint32_t i = 0; i < t.operands.size(); ++i) {
+                        MemberDecorations md{};
+                        if (m != members.end() && i < m->second.size()) md = m->second[i];
+                        size = std::max(size, md.offset + sizeOf(t.operands[i], md.matrixStride));
+                    }
+                    return size;
+                }
+                default:
+                    return 0; // runtime arrays and opaque types have no static size
+            }
+        }
+
+        bool readOnly(uint32_t variable, uint32_t structId) const {
+            if (auto d = decorations.find(variable); d != decorations.end() && d->second.nonWritable)
+                return true;
+            const auto m = members.find(structId);
+            const Type& t = type(structId);
+            if (m == members.end() || m->second.size() < t.operands.size())
+                return false;
+            return std::ranges::all_of(m->second, [] (auto const& md) { return md.nonWritable; });
+        }
+    };
+
+    std::string literalString(const uint32_t* words, size_t count) {
+        const char* chars = reinterpret_cast<const char*>(words);
+        return std::string(chars, strnlen(chars, count * sizeof(uint32_t)));
+    }
+
+} // namespace
+
+Core::Shaders::ReflectionInfo Core::Shaders::reflect(std::span<const uint32_t> spirv) {
+    if (spirv.size() < 5 || spirv[0] != kMagic)
+        throw std::runtime_error("SPIR-V reflection: not a SPIR-V module");
+
+    Module mod;
+    ReflectionInfo info;
+    struct Variable { uint32_t id, pointerType, storage; };
+    std::vector<Variable> variables;
+
+    for (size_t pos = 5; pos < spirv.size();) {
+        const uint32_t wordCount = spirv[pos] >> 16;
+        const uint32_t opcode = spirv[pos] & 0xffff;
+        if (wordCount == 0 || pos + wordCount > spirv.size())
+            throw std::runtime_error("SPIR-V reflection: truncated instruction");
+        const uint32_t* w = &spirv[pos + 1];
+        const uint32_t n = wordCount - 1;
+
+        switch (opcode) {
+            case OpName:
+                mod.names[w[0]] = literalString(w + 1, n - 1);
+                break;
+            case OpExecutionMode:
+                if (n >= 5 && w[1] == kLocalSize)
+                    std::copy_n(w + 2, 3, info.localSize);
+                break;
+            case OpTypeInt: case OpTypeFloat: case OpTypeVector: case OpTypeMatrix:
+            case OpTypeImage: case OpTypeSampler: case OpTypeSampledImage:
+            case OpTypeArray: case OpTypeRuntimeArray: case OpTypeStruct: case OpTypePointer:
+                mod.types[w[0]] = Type{ opcode, std::vector<uint32_t>(w + 1, w + n) };
+                break;
+            case OpConstant:
+                // 32-bit is all array lengths ever use
+                if (n >= 3) mod.constants[w[1]] = w[2];
+                break;
+            case OpVariable:
+                variables.push_back({ w[1], w[0], w[2] });
+                break;
+            case OpDecorate: {
+                auto& d = mod.decorations[w[0]];
+                switch (w[1]) {
+                    case Block:         d.block = true; break;
+                    case BufferBlock:   d.bufferBlock = true; break;
+                    case NonWritable:   d.nonWritable = true; break;
+                    case ArrayStride:   d.arrayStride = w[2]; break;
+                    case Binding:       d.binding = w[2]; break;
+                    case DescriptorSet: d.set = w[2]; break;
+                    default: break;
+                }
+                break;
+            }
+            case OpMemberDecorate: {
+                auto& m = mod.member(w[0], w[1]);
+                switch (w[2]) {
+                    case Offset:       m.offset = w[3]; break;
+                    case MatrixStride: m.matrixStride = w[3]; break;
+                    case NonWritable:  m.nonWritable = true; break;
+                    default: break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        pos += wordCount;
+    }
+
+    for (const Variable& var : variables) {
+        const Type& pointer = mod.type(var.pointerType);
+        uint32_t typeId = pointer.operands.at(1);
+
+        if (var.storage == PushConstant) {
+            info.pushConstantSize = std::max(info.pushConstantSize, mod.sizeOf(typeId));
+            continue;
+        }
+        if (var.storage != UniformConstant && var.storage != Uniform && var.storage != StorageBuffer)
+            continue;
+
+        ReflectionInfo::DescriptorBinding b;
+        if (auto d = mod.decorations.find(var.id); d != mod.decorations.end()) {
+            b.set = d->second.set == UINT32_MAX ? 0 : d->second.set;
+            b.binding = d->second.binding;
+        }
+        if (b.binding == UINT32_MAX)
+            continue;
+        if (auto nm = mod.names.find(var.id); nm != mod.names.end())
+            b.name = nm->second;
+
+        // descriptor arrays
+        const Type* t = &mod.type(typeId);
+        if (t->op == OpTypeArray) {
+            b.count = mod.arrayLength(*t);
+            typeId = t->operands.at(0);
+            t = &mod.type(typeId);
+        } else if (t->op == OpTypeRuntimeArray) {
+            b.count = 0;
+            typeId = t->operands.at(0);
+            t = &mod.type(typeId);
+        }
+
+        switch (t->op) {
+            case OpTypeStruct: {
+                const auto d = mod.decorations.find(typeId);
+                const bool bufferBlock = d != mod.decorations.end() && d->second.bufferBlock;
+                b.kind = var.storage == StorageBuffer || bufferBlock
+                    ? DescriptorKind::StorageBuffer : DescriptorKind::UniformBuffer;
+                if (b.kind == DescriptorKind::StorageBuffer)
+                    b.readOnly = mod.readOnly(var.id, typeId);
+                break;
+            }
+            case OpTypeImage: {
+                // operands: sampled type, Dim, depth, arrayed, MS, sampled, format
+                const bool storage = t->operands.at(5) == 2;
+                if (t->operands.at(1) == kDimBuffer)
+                    b.kind = storage ? DescriptorKind::StorageTexelBuffer : DescriptorKind::UniformTexelBuffer;
+                else
+                    b.kind = storage ? DescriptorKind::StorageImage : DescriptorKind::SampledImage;
+                break;
+            }
+            case OpTypeSampler:      b.kind = DescriptorKind::Sampler; break;
+            case OpTypeSampledImage: b.kind = DescriptorKind::CombinedImageSampler; break;
+            default: continue; // acceleration structures etc. are not reflected
+        }
+        info.bindings.push_back(std::move(b));
+    }
+
+    std::ranges::sort(info.bindings, [] (auto const& a, auto const& b) {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    });
+    return info;
+}
@@ -1,43 +1,132 @@
 #include "../Include/Core/Swapchain.h"
+#include <Core/Memory/HostAllocator.h>
 
 Core::Swapchain::Swapchain(Device &device, vk::raii::SurfaceKHR &surface,
-                     GLFWwindow &window)
-    : window_(window), device_(device), surface_(surface) {
+                     GLFWwindow &window, PresentStrategy strategy)
+    : window_(&window), device_(&device), surface_(&surface), strategy_(strategy) {
   createSwapchain();
   createImageViews();
 }
 
-void Core::Swapchain::createSwapchain() {
-  auto physicalDevice = device_.vkPhysicalDevice();
-  auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(*surface_);
+void Core::Swapchain::createSwapchain(vk::SwapchainKHR oldSwapchain) {
+  auto physicalDevice = device_->vkPhysicalDevice();
+  auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(**surface_);
   swapChainExtent = chooseSwapExtent(surfaceCapabilities);
   swapChainSurfaceFormat =
-      chooseSwapSurfaceFormat(physicalDevice.getSurfaceFormatsKHR(*surface_));
+      chooseSwapSurfaceFormat(physicalDevice.getSurfaceFormatsKHR(**surface_));
+  presentMode_ = chooseSwapPresentMode(
+      physicalDevice.getSurfacePresentModesKHR(**surface_), strategy_);
+  // transfer-src lets the readback manager copy frames out
+  imageUsage_ = vk::ImageUsageFlagBits::eColorAttachment;
+  if (surfaceCapabilities.supportedUsageFlags &
+      vk::ImageUsageFlagBits::eTransferSrc)
+    imageUsage_ |= vk::ImageUsageFlagBits::eTransferSrc;
   vk::SwapchainCreateInfoKHR swapChainCreateInfo{
-      .surface = *surface_,
+      .surface = **surface_,
       .minImageCount = chooseSwapMinImageCount(surfaceCapabilities),
       .imageFormat = swapChainSurfaceFormat.format,
       .imageColorSpace = swapChainSurfaceFormat.colorSpace,
       .imageExtent = swapChainExtent,
       .imageArrayLayers = 1,
-      .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+      .imageUsage = imageUsage_,
       .imageSharingMode = vk::SharingMode::eExclusive,
       .preTransform = surfaceCapabilities.currentTransform,
       .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
-      .presentMode = chooseSwapPresentMode(
-          physicalDevice.getSurfacePresentModesKHR(*surface_)),
-      .clipped = true};
+      .presentMode = presentMode_,
+      .clipped = true,
+      .oldSwapchain = oldSwapchain};
 
-  swapChain = vk::raii::SwapchainKHR(device_.vkDevice(), swapChainCreateInfo);
+  swapChain = vk::raii::SwapchainKHR(
+      device_->vkDevice(), swapChainCreateInfo,
+      Memory::hostCallbacks(Memory::HostTag::Swapchain));
   swapChainImages = swapChain.getImages();
 }
 
+void Core::Swapchain::recreate(uint64_t retireValue) {
+  vk::raii::SwapchainKHR old = std::move(swapChain);
+  std::vector<vk::raii::ImageView> oldViews = std::move(swapChainImageViews);
+  std::vector<vk::raii::Semaphore> oldSemaphores = std::move(presentSemaphores_);
+  swapChainImageViews.clear();
+  presentSemaphores_.clear();
+
+  createSwapchain(*old);
+  createImageViews();
+  firstPresentId_ = presentId_ + 1;
+  ++generation_;
+
+  // images acquired from the old swapchain may still be in flight; it's
+  // destroyed in collectRetired() once the timeline says they're done
+  retired_.push_back(Retired{std::move(old), std::move(oldViews),
+                             std::move(oldSemaphores), retireValue});
+}
+
+void Core::Swapchain::setPresentStrategy(PresentStrategy strategy,
+                                         uint64_t retireValue) {
+  if (strategy == strategy_)
+    return;
+  strategy_ = strategy;
+  recreate(retireValue);
+}
+
+void Core::Swapchain::collectRetired(uint64_t completedValue) {
+  std::erase_if(retired_, [completedValue](Retired const &r) {
+    return r.retireValue <= completedValue;
+  });
+}
+
+Core::SwapchainStatus Core::Swapchain::acquire(vk::Semaphore signal,
+                                               uint32_t &imageIndex) {
+  try {
+    auto [result, index] = swapChain.acquireNextImage(UINT64_MAX, signal, {});
+    imageIndex = index;
+    return result == vk::Result::eSuboptimalKHR ? SwapchainStatus::Suboptimal
+                                                : SwapchainStatus::Ok;
+  } catch (vk::OutOfDateKHRError const &) {
+    return SwapchainStatus::OutOfDate;
+  }
+}
+
+Core::SwapchainStatus Core::Swapchain::present(uint32_t imageIndex,
+                                               vk::Semaphore wait) {
+  // ids only need to increase, so one dropped by an out-of-date present is fine
+  const uint64_t presentId = ++presentId_;
+  vk::PresentIdKHR presentIdInfo{.swapchainCount = 1,
+                                 .pPresentIds = &presentId};
+  vk::PresentInfoKHR presentInfo{
+      .pNext = presentWaitEnabled() ? &presentIdInfo : nullptr,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &wait,
+      .swapchainCount = 1,
+      .pSwapchains = &*swapChain,
+      .pImageIndices = &imageIndex};
+  try {
+    const vk::Result result = device_->presentQueue().presentKHR(presentInfo);
+    return result == vk::Result::eSuboptimalKHR ? SwapchainStatus::Suboptimal
+                                                : SwapchainStatus::Ok;
+  } catch (vk::OutOfDateKHRError const &) {
+    return SwapchainStatus::OutOfDate;
+  }
+}
+
+bool Core::Swapchain::waitForPresent(uint64_t presentId,
+                                     uint64_t timeoutNs) const {
+  if (!presentWaitEnabled() || presentId < firstPresentId_ ||
+      presentId > presentId_)
+    return false;
+  try {
+    return swapChain.waitForPresent(presentId, timeoutNs) ==
+           vk::Result::eSuccess;
+  } catch (vk::OutOfDateKHRError const &) {
+    return false;
+  }
+}
+
 vk::Extent2D Core::Swapchain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR &capabilities) {
   if (capabilities.currentExtent.width != 0xFFFFFFFF) {
     return capabilities.currentExtent;
   }
   int width, height;
-  glfwGetFramebufferSize(&window_, &width, &height);
+  glfwGetFramebufferSize(window_, &width, &height);
 
   return {std::clamp<uint32_t>(width, capabilities.minImageExtent.width,
                                capabilities.maxImageExtent.width),
@@ -52,8 +141,12 @@ void Core::Swapchain::createImageViews() {
       .viewType = vk::ImageViewType::e2D,
       .format = swapChainSurfaceFormat.format,
       .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}};
+  const auto *callbacks = Memory::hostCallbacks(Memory::HostTag::Swapchain);
   for (auto image : swapChainImages) {
     imageViewCreateInfo.image = image;
-    swapChainImageViews.emplace_back(device_.vkDevice(), imageViewCreateInfo);
+    swapChainImageViews.emplace_back(device_->vkDevice(), imageViewCreateInfo,
+                                     callbacks);
+    presentSemaphores_.emplace_back(device_->vkDevice(),
+                                    vk::SemaphoreCreateInfo{}, callbacks);
   }
 }
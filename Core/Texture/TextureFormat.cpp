@@ -0,0 +1,170 @@
+#include <Core/Texture/TextureFormat.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool inside(uint64_t offset, uint64_t bytes, uint64_t size) {
+        return offset <= size && bytes <= size - offset;
+    }
+
+    float srgbToLinear(float c) {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float c) {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    std::array<float, 256> const& srgbTable() {
+        static const auto table = [] {
+            std::array<float, 256> t{};
+            for (int i = 0; i < 256; ++i)
+                t[i] = srgbToLinear(i / 255.0f);
+            return t;
+        }();
+        return table;
+    }
+
+} // namespace
+
+uint32_t Core::Texture::bytesPerTexel(TexelFormat format) {
+    switch (format) {
+        case TexelFormat::RGBA8Unorm:
+        case TexelFormat::RGBA8Srgb: return 4;
+        case TexelFormat::R8Unorm:   return 1;
+    }
+    throw std::runtime_error("texture: unknown texel format");
+}
+
+Core::Texture::TextureView Core::Texture::parseTexture(std::span<const std::byte> bytes) {
+    if (bytes.size() < sizeof(TextureHeader))
+        throw std::runtime_error("texture: file too small for a header");
+    if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(TextureHeader) != 0)
+        throw std::runtime_error("texture: buffer is not 8-byte aligned");
+
+    TextureView view;
+    view.base = bytes;
+    view.header = reinterpret_cast<const TextureHeader*>(bytes.data());
+    const TextureHeader& h = *view.header;
+    if (h.magic != kTextureMagic)
+        throw std::runtime_error("texture: bad magic");
+    if (h.version == 0 || h.version > kTextureVersion)
+        throw std::runtime_error("texture: unsupported version " + std::to_string(h.version));
+    if (h.headerSize < sizeof(TextureHeader))
+        throw std::runtime_error("texture: header too small");
+    if (h.width == 0 || h.height == 0 || h.mipCount == 0 || h.mipCount > 32)
+        throw std::runtime_error("texture: empty extent or bad mip count");
+
+    const uint64_t tableBytes = uint64_t(h.mipCount) * sizeof(TextureMip);
+    if (!inside(h.mipOffset, tableBytes, bytes.size()) || h.mipOffset % alignof(TextureMip) != 0)
+        throw std::runtime_error("texture: mip table outside the file (truncated?)");
+    view.mips = { reinterpret_cast<const TextureMip*>(bytes.data() + h.mipOffset), h.mipCount };
+
+    const uint32_t texel = bytesPerTexel(h.format);
+    for (uint32_t i = 0; i < h.mipCount; ++i) {
+        const TextureMip& m = view.mips[i];
+        if (m.width != std::max(1u, h.width >> i) || m.height != std::max(1u, h.height >> i) ||
+            m.bytes != uint64_t(m.width) * m.height * texel)
+            throw std::runtime_error("texture: level " + std::to_string(i) + " has the wrong size");
+        if (!inside(m.offset, m.bytes, bytes.size()))
+            throw std::runtime_error("texture: level outside the file (truncated?)");
+    }
+    return view;
+}
+
+Core::Texture::TextureData Core::Texture::downsample(TextureData const& level) {
+    const uint32_t channels = bytesPerTexel(level.format);
+    const bool srgb = level.format == TexelFormat::RGBA8Srgb;
+    const auto& toLinear = srgbTable();
+
+    TextureData out;
+    out.format = level.format;
+    out.width = std::max(1u, level.width / 2);
+    out.height = std::max(1u, level.height / 2);
+    out.texels.resize(size_t(out.width) * out.height * channels);
+
+    const auto* src = reinterpret_cast<const uint8_t*>(level.texels.data());
+    auto* dst = reinterpret_cast<uint8_t*>(out.texels.data());
+    for (uint32_t y = 0; y < out.height; ++y) {
+        // an odd last row/column joins the last destination texel
+        const uint32_t y0 = y * 2, y1 = std::min(level.height, y == out.height - 1 ? level.height : y0 + 2);
+        for (uint32_t x = 0; x < out.width; ++x) {
+            const uint32_t x0 = x * 2, x1 = std::min(level.width, x == out.width - 1 ? level.width : x0 + 2);
+            const float weight = 1.0f / float((y1 - y0) * (x1 - x0));
+            for (uint32_t c = 0; c < channels; ++c) {
+                // alpha is linear even in sRGB formats
+                const bool linearize = srgb && c < 3;
+                float sum = 0.0f;
+                for (uint32_t sy = y0; sy < y1; ++sy)
+                    for (uint32_t sx = x0; sx < x1; ++sx) {
+                        const uint8_t v = src[(size_t(sy) * level.width + sx) * channels + c];
+                        sum += linearize ? toLinear[v] : v / 255.0f;
+                    }
+                float value = sum * weight;
+                if (linearize)
+                    value = linearToSrgb(value);
+                dst[(size_t(y) * out.width + x) * channels + c] =
+                    static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    }
+    return out;
+}
+
+void Core::Texture::writeTexture(const std::string& path, TextureData const& level0) {
+    const uint32_t texel = bytesPerTexel(level0.format);
+    if (level0.width == 0 || level0.height == 0 ||
+        level0.texels.size() != size_t(level0.width) * level0.height * texel)
+        throw std::runtime_error("texture: texel count doesn't match the extent");
+
+    std::vector<TextureData> levels;
+    levels.push_back(level0);
+    while (levels.back().width > 1 || levels.back().height > 1)
+        levels.push_back(downsample(levels.back()));
+
+    TextureHeader h{};
+    h.magic = kTextureMagic;
+    h.version = kTextureVersion;
+    h.headerSize = sizeof(TextureHeader);
+    h.format = level0.format;
+    h.width = level0.width;
+    h.height = level0.height;
+    h.mipCount = static_cast<uint32_t>(levels.size());
+    h.mipOffset = sizeof(TextureHeader);
+
+    std::vector<TextureMip> mips(levels.size());
+    uint64_t offset = h.mipOffset + mips.size() * sizeof(TextureMip);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        offset = alignUp(offset, kTexelAlignment);
+        mips[i] = { levels[i].width, levels[i].height, offset, levels[i].texels.size() };
+        offset += levels[i].texels.size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Failed to open file for writing: " + path);
+
+    uint64_t written = 0;
+    const auto write = [&] (const void* data, uint64_t size) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    write(&h, sizeof(h));
+    write(mips.data(), mips.size() * sizeof(TextureMip));
+    static const char zeros[kTexelAlignment] = {};
+    for (size_t i = 0; i < levels.size(); ++i) {
+        write(zeros, mips[i].offset - written);
+        write(levels[i].texels.data(), levels[i].texels.size());
+    }
+    if (!out)
+        throw std::runtime_error("Failed to write texture: " + path);
+}
@@ -0,0 +1,19 @@
+#include <Core/Texture/TextureSource.h>
+
+#include <cstring>
+#include <stdexcept>
+
+Core::Texture::TextureFile::TextureFile(const std::string& path)
+    : file_(path), view_(parseTexture(file_.bytes())) {
+    const TextureHeader& h = *view_.header;
+    info_ = { h.width, h.height, h.mipCount, h.format };
+}
+
+void Core::Texture::TextureFile::decodeMip(uint32_t mip, std::span<std::byte> out) const {
+    if (mip >= info_.mipCount)
+        throw std::runtime_error("texture: no level " + std::to_string(mip));
+    const auto level = view_.level(mip);
+    if (out.size() != level.size())
+        throw std::runtime_error("texture: level " + std::to_string(mip) + " doesn't fit the output");
+    std::memcpy(out.data(), level.data(), level.size());
+}
@@ -0,0 +1,513 @@
+#include <Core/Texture/TextureStreamer.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    constexpr vk::DeviceSize kStagingAlignment = 256;
+    constexpr uint32_t kMaxBias = 4;
+    constexpr uint32_t kCalmFramesToRelax = 60;
+    // a failed decode waits this many frames, doubling per further failure
+    constexpr uint64_t kRetryFrames = 30;
+    constexpr uint32_t kMaxRetryDoublings = 5;
+
+    vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    vk::Format toVk(Core::Texture::TexelFormat format) {
+        using Core::Texture::TexelFormat;
+        switch (format) {
+            case TexelFormat::RGBA8Unorm: return vk::Format::eR8G8B8A8Unorm;
+            case TexelFormat::RGBA8Srgb:  return vk::Format::eR8G8B8A8Srgb;
+            case TexelFormat::R8Unorm:    return vk::Format::eR8Unorm;
+        }
+        return vk::Format::eUndefined;
+    }
+
+    // Texel bytes of levels [firstMip, mipCount); what an image holding them
+    // costs, give or take the driver's padding.
+    vk::DeviceSize levelBytes(Core::Texture::TextureInfo const& info, uint32_t firstMip) {
+        vk::DeviceSize bytes = 0;
+        for (uint32_t mip = firstMip; mip < info.mipCount; ++mip)
+            bytes += info.mipBytes(mip);
+        return bytes;
+    }
+
+    Core::Memory::Buffer hostBuffer(Core::Device& device, vk::DeviceSize size,
+        vk::BufferUsageFlags usage) {
+        return Core::Memory::Buffer(device, size, usage,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+            vk::MemoryPropertyFlagBits::eHostCached);
+    }
+
+} // namespace
+
+Core::Texture::TextureStreamer::TextureStreamer(Device& device, TextureStreamerOptions options,
+    ThreadPool* pool)
+    : device_(&device), options_(options), pool_(pool ? pool : &ThreadPool::shared()),
+      completion_(std::make_shared<Completion>()) {
+    if (options_.framesInFlight == 0)
+        throw std::runtime_error("TextureStreamer: framesInFlight must be at least 1");
+    feedback_.resize(options_.framesInFlight);
+    slotFrame_.assign(options_.framesInFlight, 0);
+    for (uint32_t i = 0; i < options_.framesInFlight; ++i)
+        staging_.push_back(hostBuffer(device, options_.stagingBytesPerFrame,
+            vk::BufferUsageFlagBits::eTransferSrc));
+    growFeedback(64);
+    stats_.budgetBytes = options_.budgetBytes;
+}
+
+Core::Texture::TextureStreamer::~TextureStreamer() {
+    // jobs hold the completion state, not `this`; just don't leave them
+    // decoding into a destroyed source's file
+    std::unique_lock lock(completion_->mutex);
+    completion_->idle.wait(lock, [this] { return completion_->inFlight == 0; });
+}
+
+std::unique_ptr<Core::Texture::TextureStreamer::Decoded>
+Core::Texture::TextureStreamer::decode(TextureSource const& source, TextureInfo const& info,
+    TextureId id, uint32_t serial, uint32_t firstMip, uint32_t endMip) {
+    CORE_PROFILE_ZONE("texture decode");
+    auto d = std::make_unique<Decoded>();
+    d->id = id;
+    d->serial = serial;
+    d->firstMip = firstMip;
+    d->endMip = endMip;
+    uint64_t total = 0;
+    for (uint32_t mip = firstMip; mip < endMip; ++mip) {
+        d->offsets.push_back(total);
+        total += info.mipBytes(mip);
+    }
+    try {
+        d->texels.resize(total);
+        for (uint32_t mip = firstMip; mip < endMip; ++mip)
+            source.decodeMip(mip, std::span(d->texels).subspan(
+                d->offsets[mip - firstMip], info.mipBytes(mip)));
+    } catch (...) {
+        d->failed = true;
+        d->texels.clear();
+    }
+    return d;
+}
+
+Core::Texture::TextureId Core::Texture::TextureStreamer::add(
+    std::shared_ptr<const TextureSource> source) {
+    const TextureInfo info = source->info();
+    if (info.width == 0 || info.height == 0 || info.mipCount == 0)
+        throw std::runtime_error("TextureStreamer: empty texture");
+
+    TextureId id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        id = static_cast<TextureId>(entries_.size());
+        entries_.emplace_back();
+    }
+    if (id >= feedbackCapacity_)
+        growFeedback(id + 1);
+
+    Entry& e = entries_[id];
+    const uint32_t serial = e.serial + 1;
+    e = Entry{};
+    e.serial = serial;
+    e.source = std::move(source);
+    e.info = info;
+    e.tailMip = info.mipCount - 1;
+    while (e.tailMip > 0 && info.mipWidth(e.tailMip - 1) <= options_.tailSize &&
+           info.mipHeight(e.tailMip - 1) <= options_.tailSize)
+        --e.tailMip;
+    e.residentMip = info.mipCount;
+    e.wantedMip = e.tailMip;
+    e.alive = true;
+
+    // the tail is small: decode it here and upload it ahead of streamed levels
+    e.decoding = true;
+    waiting_.insert(waiting_.begin(),
+        decode(*e.source, info, id, serial, e.tailMip, info.mipCount));
+    ++stats_.textures;
+    return id;
+}
+
+void Core::Texture::TextureStreamer::remove(TextureId id) {
+    Entry& e = entries_.at(id);
+    if (!e.alive)
+        return;
+    if (!e.image.empty()) {
+        residentBytes_ -= e.image.memorySize();
+        retire(std::move(e.image));
+    }
+    // in-flight decodes are dropped by their serial
+    const uint32_t serial = e.serial;
+    e = Entry{};
+    e.serial = serial;
+    freeIds_.push_back(id);
+    --stats_.textures;
+    ++generation_;
+}
+
+void Core::Texture::TextureStreamer::request(TextureId id, uint32_t mip) {
+    Entry& e = entries_.at(id);
+    e.frameRequest = std::min(e.frameRequest, mip);
+}
+
+void Core::Texture::TextureStreamer::retire(Memory::Image image, Memory::Buffer buffer) {
+    retired_.push_back({ std::move(image), std::move(buffer), frame_ });
+}
+
+void Core::Texture::TextureStreamer::growFeedback(size_t count) {
+    const size_t capacity = std::max(count, feedbackCapacity_ * 2);
+    for (auto& buffer : feedback_) {
+        if (!buffer.empty())
+            retire({}, std::move(buffer));
+        buffer = hostBuffer(*device_, capacity * sizeof(uint32_t),
+            vk::BufferUsageFlagBits::eStorageBuffer);
+        std::memset(buffer.mapped(), 0xff, capacity * sizeof(uint32_t));
+    }
+    feedbackCapacity_ = capacity;
+    ++generation_; // the buffer to bind changed
+}
+
+void Core::Texture::TextureStreamer::beginFrame(uint64_t frameNumber,
+    vk::raii::Semaphore const& timeline) {
+    CORE_PROFILE_ZONE("TextureStreamer::beginFrame");
+    if (frameNumber == 0)
+        throw std::runtime_error("TextureStreamer: frame numbers start at 1");
+    const uint32_t slot = static_cast<uint32_t>(frameNumber % options_.framesInFlight);
+    const uint64_t retireValue = slotFrame_[slot];
+    if (retireValue != 0 && retireValue < frameNumber &&
+        timeline.getCounterValue() < retireValue) {
+        vk::SemaphoreWaitInfo waitInfo{
+            .semaphoreCount = 1,
+            .pSemaphores = &*timeline,
+            .pValues = &retireValue };
+        if (device_->vkDevice().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+            throw std::runtime_error("TextureStreamer: waiting for frame retirement failed");
+    }
+    slotFrame_[slot] = frameNumber;
+    slot_ = slot;
+    frame_ = frameNumber;
+
+    const uint64_t completed = timeline.getCounterValue();
+    std::erase_if(retired_, [completed] (Retired const& r) { return r.frame <= completed; });
+
+    readFeedback();
+}
+
+void Core::Texture::TextureStreamer::readFeedback() {
+    auto* values = static_cast<uint32_t*>(feedback_[slot_].mapped());
+    const size_t count = std::min(entries_.size(), feedbackCapacity_);
+    for (size_t id = 0; id < count; ++id)
+        if (values[id] != UINT32_MAX && entries_[id].alive)
+            entries_[id].frameRequest = std::min(entries_[id].frameRequest, values[id]);
+    std::memset(values, 0xff, feedbackCapacity_ * sizeof(uint32_t));
+}
+
+void Core::Texture::TextureStreamer::update(vk::raii::CommandBuffer& cmd) {
+    CORE_PROFILE_ZONE("TextureStreamer::update");
+    applyRequests();
+
+    {
+        std::lock_guard lock(completion_->mutex);
+        for (auto& d : completion_->ready)
+            waiting_.push_back(std::move(d));
+        completion_->ready.clear();
+    }
+    upload(cmd);
+    startDecodes();
+
+    // relax the bias once the working set fits comfortably again
+    if (bias_ > 0 && residentBytes_ < options_.budgetBytes / 4 * 3) {
+        if (++calmFrames_ >= kCalmFramesToRelax) {
+            --bias_;
+            calmFrames_ = 0;
+        }
+    } else {
+        calmFrames_ = 0;
+    }
+    stats_.mipBias = bias_;
+}
+
+void Core::Texture::TextureStreamer::finishFrame(vk::raii::CommandBuffer& cmd) {
+    const vk::MemoryBarrier2 toHost{
+        .srcStageMask = options_.consumerStages,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &toHost });
+}
+
+void Core::Texture::TextureStreamer::applyRequests() {
+    stats_.requestedThisFrame = 0;
+    stats_.stalledThisFrame = 0;
+    const auto now = Clock::now();
+    for (Entry& e : entries_) {
+        if (!e.alive || e.frameRequest == UINT32_MAX)
+            continue;
+        const uint32_t target = std::min(std::min(e.frameRequest, e.tailMip) + bias_, e.tailMip);
+        e.frameRequest = UINT32_MAX;
+        e.lastRequested = frame_;
+        e.wantedMip = target;
+        ++stats_.requestedThisFrame;
+        if (e.residentMip > target) {
+            ++stats_.stalledThisFrame;
+            if (e.requestedAt == Clock::time_point{})
+                e.requestedAt = now;
+        } else {
+            e.requestedAt = {};
+        }
+    }
+    stats_.stalledTextureFrames += stats_.stalledThisFrame;
+}
+
+void Core::Texture::TextureStreamer::upload(vk::raii::CommandBuffer& cmd) {
+    Memory::Buffer& staging = staging_[slot_];
+    vk::DeviceSize used = 0;
+    bool budgetMissed = false;
+
+    std::vector<std::unique_ptr<Decoded>> later;
+    for (auto& d : waiting_) {
+        if (!d)
+            continue;
+        Entry& e = entries_[d->id];
+        // stale: the texture was removed, or evicted / grown since the decode started
+        if (!e.alive || e.serial != d->serial)
+            continue;
+        if (d->failed) {
+            // a broken or missing file fails every time; don't reread it each frame
+            e.decoding = false;
+            e.retryFrame = frame_ + (kRetryFrames << std::min(e.failures, kMaxRetryDoublings));
+            ++e.failures;
+            ++stats_.decodeFailures;
+            continue;
+        }
+        if (d->endMip != e.residentMip) {
+            e.decoding = false;
+            continue;
+        }
+
+        const vk::DeviceSize bytes = d->texels.size();
+        const vk::DeviceSize offset = alignUp(used, kStagingAlignment);
+        if (offset + bytes > staging.size()) {
+            if (used != 0) {
+                later.push_back(std::move(d));
+                continue;
+            }
+            // one upload larger than a frame's staging; the slot's previous
+            // frame has retired, so the buffer can be replaced outright
+            staging = hostBuffer(*device_, bytes, vk::BufferUsageFlagBits::eTransferSrc);
+        }
+
+        const vk::DeviceSize current = e.image.empty() ? 0 : e.image.memorySize();
+        const vk::DeviceSize needed = levelBytes(e.info, d->firstMip);
+        if (needed > current && !makeRoom(cmd, needed - current, d->id)) {
+            ++stats_.budgetMisses;
+            budgetMissed = true;
+            e.decoding = false;
+            continue;
+        }
+
+        std::memcpy(static_cast<std::byte*>(staging.mapped()) + offset, d->texels.data(), bytes);
+        resize(cmd, d->id, d->firstMip, d.get(), offset);
+        used = offset + bytes;
+        e.decoding = false;
+        e.failures = 0;
+        ++stats_.uploads;
+        stats_.uploadedBytes += bytes;
+
+        if (e.requestedAt != Clock::time_point{} && e.residentMip <= e.wantedMip) {
+            const double ms = std::chrono::duration<double, std::milli>(
+                Clock::now() - e.requestedAt).count();
+            latencySumMs_ += ms;
+            ++latencyCount_;
+            stats_.maxLatencyMs = std::max(stats_.maxLatencyMs, ms);
+            e.requestedAt = {};
+        }
+    }
+    waiting_ = std::move(later);
+
+    // what's in use doesn't fit: coarsen every request
+    if (budgetMissed && bias_ < kMaxBias)
+        ++bias_;
+}
+
+void Core::Texture::TextureStreamer::startDecodes() {
+    std::vector<TextureId> candidates;
+    for (TextureId id = 0; id < entries_.size(); ++id) {
+        Entry const& e = entries_[id];
+        if (!e.alive || e.decoding || frame_ < e.retryFrame)
+            continue;
+        // a tail whose decode or upload failed goes again; streamed levels
+        // extend what is resident
+        if (e.residentMip == e.info.mipCount ||
+            (e.residentMip <= e.tailMip && e.wantedMip < e.residentMip))
+            candidates.push_back(id);
+    }
+    // missing tails first, then most recently requested, then the largest gap
+    std::ranges::sort(candidates, [this] (TextureId a, TextureId b) {
+        Entry const& ea = entries_[a];
+        Entry const& eb = entries_[b];
+        const bool tailA = ea.residentMip == ea.info.mipCount;
+        const bool tailB = eb.residentMip == eb.info.mipCount;
+        if (tailA != tailB)
+            return tailA;
+        if (ea.lastRequested != eb.lastRequested)
+            return ea.lastRequested > eb.lastRequested;
+        return ea.residentMip - ea.wantedMip > eb.residentMip - eb.wantedMip;
+    });
+
+    for (TextureId id : candidates) {
+        {
+            std::lock_guard lock(completion_->mutex);
+            if (completion_->inFlight >= options_.maxDecodesInFlight)
+                break;
+            ++completion_->inFlight;
+        }
+        Entry& e = entries_[id];
+        e.decoding = true;
+        const uint32_t first = e.residentMip == e.info.mipCount ? e.tailMip : e.wantedMip;
+        pool_->submit([completion = completion_, source = e.source, info = e.info, id,
+                       serial = e.serial, first, end = e.residentMip] {
+            auto decoded = decode(*source, info, id, serial, first, end);
+            std::lock_guard lock(completion->mutex);
+            completion->ready.push_back(std::move(decoded));
+            --completion->inFlight;
+            completion->idle.notify_all();
+        });
+    }
+
+    std::lock_guard lock(completion_->mutex);
+    stats_.decodesInFlight = completion_->inFlight;
+}
+
+bool Core::Texture::TextureStreamer::makeRoom(vk::raii::CommandBuffer& cmd,
+    vk::DeviceSize bytes, TextureId keep) {
+    if (residentBytes_ + bytes <= options_.budgetBytes)
+        return true;
+
+    // first levels nobody asked for any more, then whole textures by LRU
+    std::vector<TextureId> victims;
+    for (TextureId id = 0; id < entries_.size(); ++id) {
+        Entry const& e = entries_[id];
+        if (id != keep && e.alive && e.residentMip < e.tailMip)
+            victims.push_back(id);
+    }
+    for (TextureId id : victims) {
+        Entry& e = entries_[id];
+        if (e.residentMip < e.wantedMip) {
+            resize(cmd, id, e.wantedMip, nullptr, 0);
+            if (residentBytes_ + bytes <= options_.budgetBytes)
+                return true;
+        }
+    }
+    std::ranges::sort(victims, [this] (TextureId a, TextureId b) {
+        return entries_[a].lastRequested < entries_[b].lastRequested;
+    });
+    for (TextureId id : victims) {
+        Entry& e = entries_[id];
+        if (e.lastRequested == frame_ || e.residentMip == e.tailMip)
+            continue;
+        resize(cmd, id, e.tailMip, nullptr, 0);
+        e.wantedMip = e.tailMip;
+        e.requestedAt = {};
+        ++stats_.evictions;
+        if (residentBytes_ + bytes <= options_.budgetBytes)
+            return true;
+    }
+    return false;
+}
+
+void Core::Texture::TextureStreamer::resize(vk::raii::CommandBuffer& cmd, TextureId id,
+    uint32_t newResident, Decoded const* decoded, vk::DeviceSize stagingOffset) {
+    Entry& e = entries_[id];
+    const TextureInfo& info = e.info;
+    Memory::Image old = std::move(e.image);
+    const uint32_t oldResident = e.residentMip;
+
+    Memory::Image image(*device_, toVk(info.format),
+        { info.mipWidth(newResident), info.mipHeight(newResident) },
+        info.mipCount - newResident,
+        vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst |
+        vk::ImageUsageFlagBits::eTransferSrc);
+
+    std::vector<vk::ImageMemoryBarrier2> barriers{ {
+        .srcStageMask = vk::PipelineStageFlagBits2::eNone,
+        .srcAccessMask = {},
+        .dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .image = image.handle(),
+        .subresourceRange = image.range() } };
+    if (!old.empty())
+        barriers.push_back({
+            // its upload may have been recorded earlier in this same frame
+            .srcStageMask = options_.consumerStages | vk::PipelineStageFlagBits2::eTransfer,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
+            .dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+            .oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .image = old.handle(),
+            .subresourceRange = old.range() });
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size()),
+        .pImageMemoryBarriers = barriers.data() });
+
+    // levels already on the GPU move over; the rest come from staging
+    std::vector<vk::ImageCopy> copies;
+    for (uint32_t mip = std::max(newResident, oldResident); mip < info.mipCount && !old.empty(); ++mip) {
+        const vk::ImageSubresourceLayers src{ vk::ImageAspectFlagBits::eColor, mip - oldResident, 0, 1 };
+        const vk::ImageSubresourceLayers dst{ vk::ImageAspectFlagBits::eColor, mip - newResident, 0, 1 };
+        copies.push_back({ .srcSubresource = src, .dstSubresource = dst,
+            .extent = { info.mipWidth(mip), info.mipHeight(mip), 1 } });
+    }
+    if (!copies.empty())
+        cmd.copyImage(old.handle(), vk::ImageLayout::eTransferSrcOptimal, image.handle(),
+            vk::ImageLayout::eTransferDstOptimal, copies);
+
+    if (decoded) {
+        std::vector<vk::BufferImageCopy> uploads;
+        for (uint32_t mip = decoded->firstMip; mip < decoded->endMip; ++mip)
+            uploads.push_back({
+                .bufferOffset = stagingOffset + decoded->offsets[mip - decoded->firstMip],
+                .imageSubresource = { vk::ImageAspectFlagBits::eColor, mip - newResident, 0, 1 },
+                .imageExtent = { info.mipWidth(mip), info.mipHeight(mip), 1 } });
+        cmd.copyBufferToImage(staging_[slot_].handle(), image.handle(),
+            vk::ImageLayout::eTransferDstOptimal, uploads);
+    }
+
+    const vk::ImageMemoryBarrier2 ready{
+        .srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = options_.consumerStages,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+        .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+        .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .image = image.handle(),
+        .subresourceRange = image.range() };
+    cmd.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &ready });
+
+    if (!old.empty()) {
+        residentBytes_ -= old.memorySize();
+        retire(std::move(old));
+    }
+    residentBytes_ += image.memorySize();
+    stats_.peakResidentBytes = std::max(stats_.peakResidentBytes, residentBytes_);
+    e.image = std::move(image);
+    e.residentMip = newResident;
+    ++generation_;
+}
+
+Core::Texture::TextureStreamerStats Core::Texture::TextureStreamer::stats() const {
+    TextureStreamerStats out = stats_;
+    out.residentBytes = residentBytes_;
+    out.uploadsWaiting = static_cast<uint32_t>(waiting_.size());
+    out.averageLatencyMs = latencyCount_ ? latencySumMs_ / double(latencyCount_) : 0.0;
+    return out;
+}
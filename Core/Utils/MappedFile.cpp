@@ -0,0 +1,125 @@
+#include <Core/Utils/MappedFile.h>
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Core::MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open file: " + path);
+    file_ = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0)
+        return; // zero-length files can't be mapped; an empty view is fine
+
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        close();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+    data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        close();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+        throw std::runtime_error("Failed to open file: " + path);
+
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        close();
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0)
+        return;
+
+    void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (view == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+    data_ = static_cast<const std::byte*>(view);
+#endif
+}
+
+Core::MappedFile::~MappedFile() {
+    close();
+}
+
+Core::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+#ifdef _WIN32
+    , file_(std::exchange(other.file_, nullptr)), mapping_(std::exchange(other.mapping_, nullptr))
+#else
+    , fd_(std::exchange(other.fd_, -1))
+#endif
+{
+}
+
+Core::MappedFile& Core::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_ = std::exchange(other.file_, nullptr);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+        fd_ = std::exchange(other.fd_, -1);
+#endif
+    }
+    return *this;
+}
+
+void Core::MappedFile::adviseSequential() const noexcept {
+    if (!data_)
+        return;
+#ifdef _WIN32
+    // PrefetchVirtualMemory needs Windows 8; FILE_FLAG_SEQUENTIAL_SCAN above
+    // already steers the cache manager
+    WIN32_MEMORY_RANGE_ENTRY range{ const_cast<std::byte*>(data_), size_ };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // advice values are not flags: one call each
+    madvise(const_cast<std::byte*>(data_), size_, MADV_SEQUENTIAL);
+    madvise(const_cast<std::byte*>(data_), size_, MADV_WILLNEED);
+#endif
+}
+
+void Core::MappedFile::close() noexcept {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    file_ = mapping_ = nullptr;
+#else
+    if (data_) munmap(const_cast<std::byte*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,95 @@
+#include <Core/Utils/RadixSort.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    constexpr size_t kRadix = 256;
+    constexpr size_t kMinChunk = 8 * 1024;
+
+} // namespace
+
+void Core::RadixSorter::sort(std::span<uint64_t> keys, std::span<uint32_t> values,
+    ThreadPool* pool) {
+    CORE_PROFILE_ZONE("RadixSorter::sort");
+    if (keys.size() != values.size())
+        throw std::runtime_error("RadixSorter: key and value counts differ");
+    const size_t n = keys.size();
+    if (n < 2)
+        return;
+
+    // bits that differ between any two keys; bytes outside it need no pass
+    uint64_t varying = 0;
+    for (size_t i = 1; i < n; ++i)
+        varying |= keys[i] ^ keys[0];
+    if (varying == 0)
+        return;
+
+    const bool parallel = pool && pool->workerCount() > 0 && n >= kParallelThreshold;
+    const size_t chunks = parallel
+        ? std::min<size_t>(pool->concurrency() * 4, (n + kMinChunk - 1) / kMinChunk)
+        : 1;
+    const size_t grain = (n + chunks - 1) / chunks;
+    const auto forChunks = [&] (auto const& fn) {
+        if (chunks == 1) {
+            fn(0, 0, n);
+            return;
+        }
+        pool->parallelFor(chunks, 1, [&] (size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c)
+                fn(c, c * grain, std::min(n, (c + 1) * grain));
+        });
+    };
+
+    keyScratch_.resize(n);
+    valueScratch_.resize(n);
+    histograms_.resize(chunks * kRadix);
+
+    uint64_t* srcKeys = keys.data();
+    uint32_t* srcValues = values.data();
+    uint64_t* dstKeys = keyScratch_.data();
+    uint32_t* dstValues = valueScratch_.data();
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xff) == 0)
+            continue;
+
+        std::fill(histograms_.begin(), histograms_.end(), size_t{ 0 });
+        forChunks([&] (size_t chunk, size_t begin, size_t end) {
+            size_t* h = histograms_.data() + chunk * kRadix;
+            for (size_t i = begin; i < end; ++i)
+                ++h[(srcKeys[i] >> shift) & 0xff];
+        });
+
+        // digit-major, chunk-minor prefix sum keeps the pass stable
+        size_t offset = 0;
+        for (size_t digit = 0; digit < kRadix; ++digit)
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                size_t& slot = histograms_[chunk * kRadix + digit];
+                const size_t count = slot;
+                slot = offset;
+                offset += count;
+            }
+
+        forChunks([&] (size_t chunk, size_t begin, size_t end) {
+            size_t* next = histograms_.data() + chunk * kRadix;
+            for (size_t i = begin; i < end; ++i) {
+                const size_t pos = next[(srcKeys[i] >> shift) & 0xff]++;
+                dstKeys[pos] = srcKeys[i];
+                dstValues[pos] = srcValues[i];
+            }
+        });
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // an odd number of passes leaves the result in scratch
+    if (srcKeys != keys.data()) {
+        std::memcpy(keys.data(), srcKeys, n * sizeof(uint64_t));
+        std::memcpy(values.data(), srcValues, n * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,120 @@
+#include <Core/Utils/TaskGraph.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+Core::TaskGraph::TaskId Core::TaskGraph::add(const char* name, std::function<void()> fn,
+    std::vector<TaskId> dependencies, Affinity affinity) {
+    const auto id = static_cast<TaskId>(tasks_.size());
+    for (TaskId dep : dependencies)
+        if (dep >= id) throw std::logic_error("TaskGraph: dependency on a later task");
+    tasks_.push_back(Task{ name, std::move(fn), std::move(dependencies), {}, affinity });
+    return id;
+}
+
+void Core::TaskGraph::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    const auto ms = [t0] (Clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(t - t0).count();
+    };
+
+    for (auto& task : tasks_) {
+        task.pending = static_cast<uint32_t>(task.dependencies.size());
+        task.dependents.clear();
+    }
+    for (TaskId id = 0; id < tasks_.size(); ++id)
+        for (TaskId dep : tasks_[id].dependencies)
+            tasks_[dep].dependents.push_back(id);
+    timings_.assign(tasks_.size(), Timing{});
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<TaskId> mainReady;
+    std::vector<std::thread> workers;
+    size_t running = 0;
+    std::exception_ptr failure;
+
+    // caller holds the lock
+    std::function<void(TaskId)> schedule;
+    const auto execute = [&] (TaskId id) {
+        Task& task = tasks_[id];
+        const auto start = Clock::now();
+        const uint64_t zoneStart = Profiling::now();
+        std::exception_ptr error;
+        try {
+            task.fn();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        const auto end = Clock::now();
+        Profiling::recordCpu(task.name, zoneStart, Profiling::now());
+
+        std::lock_guard lock(mutex);
+        timings_[id] = { task.name, ms(start), ms(end), task.affinity };
+        --running;
+        if (error && !failure) failure = error;
+        if (!failure)
+            for (TaskId next : task.dependents)
+                if (--tasks_[next].pending == 0) schedule(next);
+        cv.notify_all();
+    };
+    schedule = [&] (TaskId id) {
+        ++running;
+        if (tasks_[id].affinity == Affinity::MainThread)
+            mainReady.push_back(id);
+        else
+            workers.emplace_back(execute, id);
+    };
+
+    {
+        std::unique_lock lock(mutex);
+        for (TaskId id = 0; id < tasks_.size(); ++id)
+            if (tasks_[id].pending == 0) schedule(id);
+
+        while (running > 0) {
+            cv.wait(lock, [&] { return !mainReady.empty() || running == 0; });
+            while (!mainReady.empty()) {
+                const TaskId id = mainReady.front();
+                mainReady.pop_front();
+                lock.unlock();
+                execute(id);
+                lock.lock();
+            }
+        }
+    }
+    for (auto& worker : workers) worker.join();
+    wallMs_ = ms(Clock::now());
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+std::string Core::TaskGraph::report() const {
+    std::vector<Timing> sorted = timings_;
+    std::erase_if(sorted, [] (Timing const& t) { return t.name == nullptr; });
+    std::sort(sorted.begin(), sorted.end(),
+        [] (auto const& a, auto const& b) { return a.startMs < b.startMs; });
+
+    double serialMs = 0;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "startup report\n";
+    oss << "  " << std::left << std::setw(20) << "phase" << std::right
+        << std::setw(10) << "start ms" << std::setw(10) << "took ms" << "  thread\n";
+    for (auto const& t : sorted) {
+        serialMs += t.endMs - t.startMs;
+        oss << "  " << std::left << std::setw(20) << t.name << std::right
+            << std::setw(10) << t.startMs << std::setw(10) << (t.endMs - t.startMs)
+            << "  " << (t.affinity == Affinity::MainThread ? "main" : "worker") << '\n';
+    }
+    oss << "  total " << wallMs_ << " ms (" << serialMs << " ms if run in sequence)\n";
+    return oss.str();
+}
@@ -0,0 +1,113 @@
+#include <Core/Utils/ThreadPool.h>
+#include <Core/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+Core::ThreadPool::ThreadPool(uint32_t workers) {
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    threads_.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i)
+        threads_.emplace_back([this] { work(); });
+}
+
+Core::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+Core::ThreadPool& Core::ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void Core::ThreadPool::submit(std::function<void()> job) {
+    if (threads_.empty()) {
+        job(); // nobody would ever pop it
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void Core::ThreadPool::work() {
+    CORE_PROFILE_THREAD("pool worker");
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty())
+                return; // stop_ and drained
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+void Core::ThreadPool::parallelFor(size_t count, size_t grain,
+    std::function<void(size_t begin, size_t end)> const& fn) {
+    if (count == 0)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || threads_.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // shared with the helpers, which may still hold it after the caller
+    // has seen the last chunk finish
+    struct Loop {
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto loop = std::make_shared<Loop>();
+
+    const auto drain = [loop, &fn, count, grain, chunks] {
+        for (size_t c; (c = loop->next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            try {
+                fn(c * grain, std::min(count, (c + 1) * grain));
+            } catch (...) {
+                std::lock_guard lock(loop->mutex);
+                if (!loop->error) loop->error = std::current_exception();
+            }
+            if (loop->done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+                std::lock_guard lock(loop->mutex);
+                loop->finished.notify_all();
+            }
+        }
+    };
+
+    // `fn` lives on the caller's stack: helpers only call it for chunks
+    // claimed before `next` ran out, all of which finish before we return
+    const size_t helpers = std::min<size_t>(threads_.size(), chunks - 1);
+    {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < helpers; ++i)
+            jobs_.emplace_back(drain);
+    }
+    if (helpers == 1) cv_.notify_one();
+    else cv_.notify_all();
+
+    drain();
+    std::unique_lock lock(loop->mutex);
+    loop->finished.wait(lock, [&] { return loop->done.load(std::memory_order_acquire) == chunks; });
+    if (loop->error)
+        std::rethrow_exception(loop->error);
+}
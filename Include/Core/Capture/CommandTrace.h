@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Binary command trace (.ctrace): what a capture saw go through the compute
+// submission layer, in submission order. Little-endian, versioned:
+//
+//   TraceHeader
+//   { TraceRecordHeader, payload[size] }...
+//
+// Buffers are numbered by the capture and referenced by id; shaders are
+// referenced by their blob's contentHash, with the SPIR-V stored once in a
+// Shader record ahead of first use. Readers skip record types they don't
+// know, so newer writers stay readable by older replays.
+namespace Core::Capture {
+
+    constexpr uint32_t kTraceMagic = 0x43525443; // "CTRC"
+    constexpr uint32_t kTraceVersion = 1;
+
+    struct TraceHeader {
+        uint32_t magic = kTraceMagic;
+        uint32_t version = kTraceVersion;
+        uint64_t reserved = 0;
+    };
+    static_assert(sizeof(TraceHeader) == 16);
+
+    enum class RecordType : uint32_t {
+        Info = 1,     // capturing device, for the replay report
+        Shader = 2,
+        Buffer = 3,   // creation, at first use
+        Upload = 4,   // bytes the host wrote since the previous batch
+        Batch = 5,    // one command buffer
+        FrameEnd = 6,
+    };
+
+    struct TraceRecordHeader {
+        RecordType type{};
+        uint32_t reserved = 0;
+        uint64_t size = 0; // payload bytes
+    };
+    static_assert(sizeof(TraceRecordHeader) == 16);
+
+    struct TraceInfo {
+        std::string device;
+    };
+
+    struct TraceShader {
+        uint64_t contentHash = 0;
+        std::string entry;
+        std::vector<uint32_t> spirv;
+    };
+
+    // memory: the captured buffer's raw VkMemoryPropertyFlags.
+    struct TraceBuffer {
+        uint32_t id = 0;
+        uint32_t memory = 0;
+        uint64_t size = 0;
+    };
+
+    struct TraceUpload {
+        uint32_t buffer = 0;
+        uint64_t offset = 0;
+        std::vector<std::byte> bytes;
+    };
+
+    struct TraceBinding {
+        uint32_t set = 0, binding = 0, buffer = 0;
+        uint64_t offset = 0, range = 0; // range: VK_WHOLE_SIZE kept as ~0
+    };
+
+    struct TraceJob {
+        uint64_t shader = 0; // contentHash
+        uint32_t groups[3] = { 1, 1, 1 };
+        std::vector<TraceBinding> bindings;
+        std::vector<std::byte> pushConstants;
+    };
+
+    struct TraceReadback {
+        uint32_t buffer = 0;
+        uint64_t offset = 0, size = 0;
+    };
+
+    struct TraceBatch {
+        std::vector<TraceJob> jobs;
+        std::vector<TraceReadback> readbacks;
+    };
+
+    struct TraceFrameEnd {};
+
+    using TraceRecord = std::variant<TraceInfo, TraceShader, TraceBuffer, TraceUpload,
+        TraceBatch, TraceFrameEnd>;
+
+    // Appends records to a trace file as they are captured. Throws
+    // std::runtime_error on I/O failure.
+    class TraceWriter {
+    public:
+        explicit TraceWriter(std::string const& path);
+
+        void write(TraceRecord const& record);
+        void flush();
+        uint64_t bytesWritten() const noexcept { return written_; }
+
+    private:
+        std::ofstream out_;
+        std::vector<std::byte> payload_; // reused between records
+        uint64_t written_ = 0;
+    };
+
+    // Every record of the trace at `path`, in file order. Throws
+    // std::runtime_error on a bad header, a newer version or truncation.
+    std::vector<TraceRecord> readTrace(std::string const& path);
+
+} // namespace Core::Capture
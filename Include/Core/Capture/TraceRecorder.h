@@ -0,0 +1,80 @@
+#pragma once
+#include <Core/Capture/CommandTrace.h>
+#include <Core/Compute/ComputeDispatcher.h>
+#include <Core/Shaders/ShaderBlobCache.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace Core::Capture {
+
+    struct TraceRecorderStats {
+        uint64_t batches = 0;
+        uint64_t frames = 0;
+        uint64_t shaders = 0;
+        uint64_t buffers = 0;
+        uint64_t uploadBytes = 0;
+        uint64_t fileBytes = 0;
+    };
+
+    // Writes what a ComputeDispatcher submits to a command trace, for
+    // TraceReplay. Attach with ComputeDispatcher::setCapture(); batch() is
+    // then called from submit(), so everything here runs on the submit
+    // thread.
+    //
+    // Buffers are recorded at first use. Host-visible buffers are diffed
+    // against the previous submission and the changed range written as an
+    // upload, so the trace carries the inputs as the GPU saw them. Once a
+    // shader binds a buffer writable it belongs to the GPU: replay
+    // reproduces its writes, and diffing it would race with batches still in
+    // flight and record their results as uploads. Host writes to such a
+    // buffer after its first use are not captured. Batches submitted before
+    // the capture started are waited for once, at the first batch.
+    // Device-local buffers can't be read back without stalling; replay
+    // starts them zeroed.
+    class TraceRecorder {
+    public:
+        // `blobs` supplies the SPIR-V behind each pipeline's contentHash.
+        TraceRecorder(std::string const& path, Device const& device,
+            Shaders::ShaderBlobCache const& blobs);
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        // `value` is what the batch will signal on the dispatcher's
+        // `timeline`. Throws std::runtime_error for a raw BufferBinding
+        // without a source buffer, or a pipeline whose blob is not in the
+        // cache.
+        void batch(Compute::ComputeBatch const& batch, vk::Semaphore timeline, uint64_t value);
+        // Marks a frame boundary; replay reports frame times between them.
+        void endFrame();
+
+        TraceRecorderStats const& stats() const noexcept { return stats_; }
+
+    private:
+        struct Tracked {
+            uint32_t id = 0;
+            uint64_t size = 0;
+            std::vector<std::byte> shadow; // host-visible: contents at the last upload
+            bool gpuWritten = false;       // bound writable; no longer diffed
+        };
+
+        uint32_t buffer(const Memory::Buffer* source, vk::Buffer handle, bool writable);
+        void shader(Compute::ComputePipeline const& pipeline);
+        void upload(Tracked& tracked, Memory::Buffer const& source);
+
+        TraceWriter writer_;
+        vk::Device device_;
+        Shaders::ShaderBlobCache const& blobs_;
+        std::unordered_map<VkBuffer, Tracked> buffers_;
+        std::unordered_set<uint64_t> shaders_;
+        uint32_t nextId_ = 0;
+        bool started_ = false;
+        TraceRecorderStats stats_;
+    };
+
+} // namespace Core::Capture
@@ -0,0 +1,72 @@
+#pragma once
+#include <Core/Compute/ComputeDispatcher.h>
+#include <Core/Compute/ComputePipeline.h>
+#include <Core/Device.h>
+#include <Core/Memory/Buffer.h>
+#include <Core/Shaders/ShaderLoader.h>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Compute {
+
+    struct ComputeContextOptions {
+        // Requires VK_LAYER_KHRONOS_validation; throws when it is missing.
+        bool validation = false;
+        uint32_t apiVersion = VK_API_VERSION_1_3;
+        // Shared with other contexts so each shader compiles once per
+        // process; null gives the context a cache of its own.
+        std::shared_ptr<Shaders::ShaderBlobCache> shaderBlobs;
+    };
+
+    struct PipelineCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0; // pipelines created
+    };
+
+    // Instance, headless device, shader loader and dispatcher for GPGPU work
+    // without a window: no GLFW, no surface, no Renderer. Runs on CPU
+    // implementations (lavapipe, SwiftShader) as well as GPUs.
+    class ComputeContext {
+    public:
+        explicit ComputeContext(ComputeContextOptions options = {});
+        // On `physical` of an instance owned by the caller (a DeviceGroup),
+        // which must outlive the context. `validation` is the instance's.
+        ComputeContext(vk::raii::Instance& instance, vk::raii::PhysicalDevice physical,
+            ComputeContextOptions options = {});
+        ~ComputeContext();
+
+        ComputeContext(const ComputeContext&) = delete;
+        ComputeContext& operator=(const ComputeContext&) = delete;
+
+        Device& device() noexcept { return device_; }
+        Shaders::ShaderLoader& shaders() noexcept { return *shaders_; }
+        ComputeDispatcher& dispatcher() noexcept { return *dispatcher_; }
+
+        // Built once per shader key; the reference stays valid for the
+        // context's lifetime.
+        ComputePipeline const& pipeline(Shaders::ShaderKey const& key);
+        PipelineCacheStats const& pipelineStats() const noexcept { return pipelineStats_; }
+        // Storage buffer usable as a dispatch binding and a readback source.
+        // Host-visible buffers are mapped, so inputs can be written directly.
+        Memory::Buffer storageBuffer(vk::DeviceSize size, bool hostVisible = true);
+
+    private:
+        struct GlslangProcess {
+            GlslangProcess();
+            ~GlslangProcess();
+        };
+
+        GlslangProcess glslang_; // first in, last out
+        vk::raii::Context context_{};
+        vk::raii::Instance instance_ = nullptr; // null on a shared instance
+        Device device_;
+        std::optional<Shaders::ShaderLoader> shaders_;
+        std::optional<ComputeDispatcher> dispatcher_;
+        std::unordered_map<Shaders::ShaderKey, std::unique_ptr<ComputePipeline>,
+            Shaders::ShaderKeyHasher> pipelines_;
+        PipelineCacheStats pipelineStats_;
+    };
+
+} // namespace Core::Compute
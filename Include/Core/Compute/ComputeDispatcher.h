@@ -0,0 +1,168 @@
+#pragma once
+#include <Core/Compute/ComputePipeline.h>
+#include <Core/Device.h>
+#include <Core/Memory/Buffer.h>
+#include <Core/Memory/ReadbackManager.h>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Capture { class TraceRecorder; }
+
+namespace Core::Compute {
+
+    struct BufferBinding {
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        vk::Buffer buffer{};
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize range = vk::WholeSize;
+        // Set by bind(Memory::Buffer); a capture needs it to size and
+        // snapshot the buffer.
+        const Memory::Buffer* source = nullptr;
+    };
+
+    struct ComputeJob {
+        const ComputePipeline* pipeline = nullptr;
+        std::array<uint32_t, 3> groups{ 1, 1, 1 };
+        std::vector<BufferBinding> buffers;
+        std::vector<std::byte> pushConstants;
+
+        ComputeJob& bind(uint32_t binding, Memory::Buffer const& buffer, uint32_t set = 0) {
+            buffers.push_back({ set, binding, buffer.handle(), 0, vk::WholeSize, &buffer });
+            return *this;
+        }
+        ComputeJob& bind(BufferBinding b) { buffers.push_back(b); return *this; }
+        template <class T>
+        ComputeJob& push(T const& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            pushConstants.resize(sizeof(T));
+            std::memcpy(pushConstants.data(), &value, sizeof(T));
+            return *this;
+        }
+    };
+
+    // Jobs run in order, each seeing the previous ones' writes. Readbacks are
+    // copied after the last job.
+    class ComputeBatch {
+    public:
+        struct Readback {
+            vk::Buffer buffer;
+            vk::DeviceSize offset, size;
+            const Memory::Buffer* source;
+        };
+
+        // The reference is valid until the next dispatch().
+        ComputeJob& dispatch(ComputePipeline const& pipeline, uint32_t x, uint32_t y = 1, uint32_t z = 1) {
+            jobs_.push_back(ComputeJob{ .pipeline = &pipeline, .groups = { x, y, z } });
+            return jobs_.back();
+        }
+        // Returns the index of the copy in ComputeResult::readbacks.
+        size_t readback(Memory::Buffer const& buffer, vk::DeviceSize offset = 0,
+            vk::DeviceSize size = vk::WholeSize) {
+            readbacks_.push_back({ buffer.handle(), offset,
+                size == vk::WholeSize ? buffer.size() - offset : size, &buffer });
+            return readbacks_.size() - 1;
+        }
+
+        bool empty() const noexcept { return jobs_.empty() && readbacks_.empty(); }
+        std::span<const ComputeJob> jobs() const noexcept { return jobs_; }
+        std::span<const Readback> readbacks() const noexcept { return readbacks_; }
+
+    private:
+        friend class ComputeDispatcher;
+        std::vector<ComputeJob> jobs_;
+        std::vector<Readback> readbacks_;
+    };
+
+    struct ComputeResult {
+        std::vector<std::vector<std::byte>> readbacks;
+
+        template <class T>
+        std::span<const T> as(size_t index) const {
+            auto const& bytes = readbacks.at(index);
+            return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+        }
+    };
+
+    // Records batches into one-shot command buffers on the device's compute
+    // queue; readbacks go through a ReadbackManager tied to the dispatcher's
+    // timeline. A completion thread resolves each future once the batch's
+    // timeline value is reached. submit() must be called from one
+    // thread; on devices without a compute-only family the compute queue is
+    // the graphics queue, so that thread should also be the render thread.
+    class ComputeDispatcher {
+    public:
+        explicit ComputeDispatcher(Device& device);
+        ~ComputeDispatcher();
+
+        ComputeDispatcher(const ComputeDispatcher&) = delete;
+        ComputeDispatcher& operator=(const ComputeDispatcher&) = delete;
+
+        // Throws std::runtime_error for unbound reflected bindings or short
+        // push constant data; GPU-side failures arrive through the future.
+        std::future<ComputeResult> submit(ComputeBatch batch);
+        // Blocks until every submitted batch has resolved.
+        void waitIdle();
+        // Every batch submitted while set is also written to `recorder`
+        // (null stops capturing). Call from the submit thread.
+        void setCapture(Capture::TraceRecorder* recorder) noexcept { capture_ = recorder; }
+
+        uint64_t submitted() const noexcept { return submitted_; }
+        // Batches submitted but not yet resolved.
+        size_t inFlight() const;
+        vk::Semaphore timeline() const noexcept { return *timeline_; }
+        Memory::ReadbackStats readbackStats() const { return readback_->stats(); }
+
+    private:
+        // Reset and reused once the submission holding it has retired.
+        struct Descriptors {
+            vk::raii::DescriptorPool pool = nullptr;
+            uint32_t sets = 0;
+            uint32_t buffers = 0;       // of each buffer descriptor type
+        };
+
+        struct Submission {
+            uint64_t value = 0;
+            vk::raii::CommandBuffer cmd = nullptr;
+            Descriptors descriptors;
+            std::vector<std::future<Memory::ReadbackData>> readbacks;
+            std::promise<ComputeResult> promise;
+        };
+
+        void record(Submission& s, ComputeBatch const& batch);
+        Descriptors takeDescriptors(uint32_t sets, uint32_t buffers);
+        void complete();
+        void collectRetired();
+
+        Device* device_;
+        vk::raii::CommandPool pool_ = nullptr;
+        vk::raii::Semaphore timeline_ = nullptr;
+        uint64_t submitted_ = 0;
+        std::optional<Memory::ReadbackManager> readback_;
+        Capture::TraceRecorder* capture_ = nullptr;
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::condition_variable idle_;
+        std::deque<std::unique_ptr<Submission>> inFlight_;
+        // finished on the completion thread, destroyed on the submit thread
+        // (the command pool is externally synchronized)
+        std::vector<std::unique_ptr<Submission>> retired_;
+        std::vector<Descriptors> freeDescriptors_; // submit thread only
+        bool stop_ = false;
+        std::thread completion_;
+    };
+
+} // namespace Core::Compute
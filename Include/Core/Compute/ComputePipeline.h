@@ -0,0 +1,54 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Shaders/ShaderHandle.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Compute {
+
+    // Compute pipeline whose descriptor set layouts and push constant range
+    // come from the shader's reflection. Buffers (uniform, storage) and images
+    // (storage, sampled, combined image sampler) are supported, one descriptor
+    // per binding; anything else throws.
+    class ComputePipeline {
+    public:
+        ComputePipeline(Device& device, Shaders::ShaderHandle const& shader);
+
+        ComputePipeline(ComputePipeline&&) noexcept = default;
+        ComputePipeline& operator=(ComputePipeline&&) noexcept = default;
+        ComputePipeline(const ComputePipeline&) = delete;
+        ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+        vk::Pipeline handle() const noexcept { return *pipeline_; }
+        vk::PipelineLayout layout() const noexcept { return *layout_; }
+        // index == set number; sets the shader skips get an empty layout
+        const std::vector<vk::raii::DescriptorSetLayout>& setLayouts() const noexcept { return setLayouts_; }
+        const Shaders::ReflectionInfo& reflection() const noexcept { return reflection_; }
+        // The shader blob's contentHash and entry point, for captures.
+        uint64_t blobHash() const noexcept { return blobHash_; }
+        const std::string& entry() const noexcept { return entry_; }
+        std::array<uint32_t, 3> localSize() const noexcept {
+            return { reflection_.localSize[0], reflection_.localSize[1], reflection_.localSize[2] };
+        }
+
+        // Workgroups needed to cover `invocations` along x.
+        uint32_t groupsFor(uint32_t invocations) const noexcept {
+            return (invocations + reflection_.localSize[0] - 1) / reflection_.localSize[0];
+        }
+
+    private:
+        Shaders::ReflectionInfo reflection_;
+        uint64_t blobHash_ = 0;
+        std::string entry_;
+        std::vector<vk::raii::DescriptorSetLayout> setLayouts_;
+        vk::raii::PipelineLayout layout_ = nullptr;
+        vk::raii::Pipeline pipeline_ = nullptr;
+    };
+
+    vk::DescriptorType toVk(Shaders::DescriptorKind kind);
+
+} // namespace Core::Compute
@@ -0,0 +1,66 @@
+#pragma once
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Shaders/ShaderBlobCache.h>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Compute {
+
+    struct DeviceGroupOptions {
+        bool validation = false;
+        uint32_t apiVersion = VK_API_VERSION_1_3;
+        size_t maxDevices = 0; // 0: every suitable device
+        // CPU implementations (lavapipe, SwiftShader) only join when there is
+        // no GPU, unless this is set: they are usually far slower and would
+        // take an equal share of batches.
+        bool mixCpuDevices = false;
+    };
+
+    // One headless ComputeContext per suitable device on a shared instance.
+    // Contexts share one ShaderBlobCache, so a shader is compiled once and
+    // only its modules and pipelines are created per device. Buffers and
+    // pipelines belong to one context; they can't be used on another.
+    //
+    // submit() must be called from one thread, like ComputeDispatcher's.
+    class DeviceGroup {
+    public:
+        explicit DeviceGroup(DeviceGroupOptions options = {});
+        ~DeviceGroup();
+
+        DeviceGroup(const DeviceGroup&) = delete;
+        DeviceGroup& operator=(const DeviceGroup&) = delete;
+
+        size_t size() const noexcept { return contexts_.size(); }
+        ComputeContext& operator[](size_t index) { return *contexts_.at(index); }
+        Shaders::ShaderBlobCache& blobs() noexcept { return *blobs_; }
+
+        // Submits `build(context, index)` on the device with the fewest
+        // batches in flight, round-robin among ties. `build` returns the
+        // ComputeBatch, recorded against the context it is given.
+        template <class F>
+        std::future<ComputeResult> submit(F&& build) {
+            const size_t index = pick();
+            ComputeContext& context = *contexts_[index];
+            ++scheduled_[index];
+            return context.dispatcher().submit(build(context, index));
+        }
+        void waitIdle();
+
+        // Batches submitted to each device so far.
+        std::vector<uint64_t> const& scheduled() const noexcept { return scheduled_; }
+
+    private:
+        size_t pick();
+
+        vk::raii::Context context_{};
+        vk::raii::Instance instance_ = nullptr;
+        std::shared_ptr<Shaders::ShaderBlobCache> blobs_;
+        std::vector<std::unique_ptr<ComputeContext>> contexts_;
+        std::vector<uint64_t> scheduled_;
+        size_t next_ = 0;
+    };
+
+} // namespace Core::Compute
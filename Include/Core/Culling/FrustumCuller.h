@@ -0,0 +1,61 @@
+#pragma once
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Utils/ThreadPool.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core::Culling {
+
+    // Inside when nx*x + ny*y + nz*z + d >= 0; (nx, ny, nz) is unit length.
+    struct Plane {
+        float nx, ny, nz, d;
+    };
+
+    struct Frustum {
+        std::array<Plane, 6> planes; // left, right, bottom, top, near, far
+
+        // Column-major view-projection with Vulkan clip space (0 <= z <= w).
+        static Frustum fromViewProjection(const float m[16]);
+    };
+
+    enum class CullKernel : uint8_t {
+        Auto,    // widest SIMD path compiled in (Simd.h)
+        Scalar,  // reference
+    };
+
+    // World-space bounds of many objects as structure-of-arrays: one float
+    // stream per component, so a kernel tests 4 (SSE2/NEON) or 8 (AVX2)
+    // objects per instruction against each plane with no gathers. An object
+    // is visible when both its bounding sphere and its box intersect the
+    // frustum; the sphere test is cheap, the box test is tighter for long
+    // thin objects. Both are conservative.
+    class CullingSet {
+    public:
+        // Returns the object's index, which cull() reports.
+        uint32_t add(Geometry::Bounds const& bounds);
+        void set(uint32_t index, Geometry::Bounds const& bounds);
+        void reserve(size_t count);
+        void clear();
+        size_t size() const noexcept { return count_; }
+
+        // Replaces `visible` with the indices of visible objects, ascending.
+        // With a pool, chunks run in parallel and are compacted afterwards.
+        void cull(Frustum const& frustum, std::vector<uint32_t>& visible,
+            ThreadPool* pool = nullptr, CullKernel kernel = CullKernel::Auto) const;
+
+        // Objects per parallel chunk; a multiple of every SIMD width.
+        static constexpr size_t kChunk = 16 * 1024;
+
+    private:
+        enum Stream : uint8_t {
+            CenterX, CenterY, CenterZ, Radius,
+            BoxX, BoxY, BoxZ, ExtentX, ExtentY, ExtentZ,
+            StreamCount
+        };
+        std::array<std::vector<float>, StreamCount> streams_;
+        size_t count_ = 0;
+    };
+
+} // namespace Core::Culling
@@ -0,0 +1,119 @@
+#pragma once
+#include <Core/Compute/ComputePipeline.h>
+#include <Core/Culling/FrustumCuller.h>
+#include <Core/Culling/HiZPyramid.h>
+#include <Core/Device.h>
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Memory/Buffer.h>
+#include <Core/Memory/FrameAllocator.h>
+#include <Core/Shaders/ShaderLoader.h>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Culling {
+
+    // One drawable as the culling shader sees it (std430, mirrors
+    // shaders/cull_instances.comp). Bounds are world space; the draw
+    // fields are copied into the VkDrawIndexedIndirectCommand, with
+    // `instanceId` as firstInstance so vertex shaders can find per-object
+    // data through gl_InstanceIndex.
+    struct GpuInstance {
+        float center[3];
+        float radius;
+        float boxCenter[3];
+        uint32_t indexCount;
+        float boxExtent[3];
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t instanceId;
+        uint32_t pad[2];
+
+        static GpuInstance from(Geometry::Bounds const& bounds, uint32_t indexCount,
+            uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceId);
+    };
+    static_assert(sizeof(GpuInstance) == 64);
+
+    // std140 uniform block of the culling shader.
+    struct GpuCullParams {
+        Plane planes[6];
+        float viewProj[16];
+        float hiZSize[2];
+        uint32_t hiZMips;
+        uint32_t instanceCount;
+    };
+    static_assert(sizeof(GpuCullParams) == 176);
+
+    // GPU-driven visibility: a compute pass tests every instance against the
+    // frustum, and optionally last frame's Hi-Z pyramid, and appends a
+    // VkDrawIndexedIndirectCommand per survivor plus a draw count. One
+    // vkCmdDrawIndexedIndirectCount then issues them all, so CPU cost per
+    // frame no longer depends on the object count.
+    //
+    // Instances live in a device-local buffer; add()/set() only mark a dirty
+    // range, which record() uploads through per-frame staging. record() and
+    // draw() go into the same frame's command buffer, after the frame
+    // allocator's beginFrame().
+    class GpuCuller {
+    public:
+        GpuCuller(Device& device, Shaders::ShaderLoader& shaders,
+            uint32_t framesInFlight, std::filesystem::path const& shaderDir = "shaders");
+
+        GpuCuller(const GpuCuller&) = delete;
+        GpuCuller& operator=(const GpuCuller&) = delete;
+
+        // Returns the instance's index.
+        uint32_t add(GpuInstance const& instance);
+        void set(uint32_t index, GpuInstance const& instance);
+        void reserve(size_t count);
+        void clear();
+        size_t size() const noexcept { return instances_.size(); }
+
+        // Uploads pending changes and records the culling dispatch, followed by
+        // the barrier that makes its output readable as indirect arguments.
+        // With a pyramid, `occlusionViewProj` must be the column-major matrix
+        // its depth was rendered with (normally last frame's). Outside a
+        // render pass.
+        void record(vk::raii::CommandBuffer& cmd, Memory::FrameAllocator& frameAllocator,
+            Frustum const& frustum, const float occlusionViewProj[16] = nullptr,
+            HiZPyramid const* hiZ = nullptr);
+
+        // Inside a render pass with the index buffer and pipeline bound.
+        void draw(vk::raii::CommandBuffer& cmd) const;
+
+        // For custom draw recording: drawCount lives at offset 0 of countBuffer().
+        vk::Buffer drawBuffer() const noexcept { return draws_.handle(); }
+        vk::Buffer countBuffer() const noexcept { return count_.handle(); }
+        static constexpr uint32_t kDrawStride = sizeof(vk::DrawIndexedIndirectCommand);
+
+    private:
+        void grow(size_t capacity);
+        void releaseRetired();
+
+        Device* device_;
+        Compute::ComputePipeline frustumPipeline_;
+        Compute::ComputePipeline hiZPipeline_;   // compiled with HI_Z
+        vk::raii::DescriptorPool pool_ = nullptr;
+        std::vector<vk::DescriptorSet> frustumSets_; // one per frame slot, owned by pool_
+        std::vector<vk::DescriptorSet> hiZSets_;
+
+        std::vector<GpuInstance> instances_;
+        size_t dirtyBegin_ = 0, dirtyEnd_ = 0;
+        size_t capacity_ = 0;
+        Memory::Buffer instanceBuffer_;
+        Memory::Buffer draws_;
+        Memory::Buffer count_;
+        std::vector<Memory::Buffer> staging_; // per frame slot, grown on demand
+
+        // replaced by grow() while earlier frames may still read them
+        struct Retired {
+            Memory::Buffer instances, draws;
+            uint64_t releaseAt; // records_ value at which no frame uses them
+        };
+        std::vector<Retired> retired_;
+        uint64_t records_ = 0;
+        uint32_t framesInFlight_;
+    };
+
+} // namespace Core::Culling
@@ -0,0 +1,48 @@
+#pragma once
+#include <Core/Compute/ComputePipeline.h>
+#include <Core/Device.h>
+#include <Core/Memory/Image.h>
+#include <Core/Shaders/ShaderLoader.h>
+#include <filesystem>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Culling {
+
+    // Max-depth pyramid over a depth buffer, for occlusion culling against the
+    // previous frame (GpuCuller). Mip 0 has the depth buffer's extent and each
+    // level halves it; every texel holds the farthest depth it covers, so an
+    // object whose nearest point is behind that value is hidden. Assumes the
+    // usual depth convention (0 near, 1 far). The pyramid stays in the General
+    // layout; the depth view is bound once at construction and must be in
+    // `depthLayout` whenever build() runs.
+    class HiZPyramid {
+    public:
+        HiZPyramid(Device& device, Shaders::ShaderLoader& shaders,
+            vk::ImageView depth, vk::ImageLayout depthLayout, vk::Extent2D extent,
+            std::filesystem::path const& shaderDir = "shaders");
+
+        HiZPyramid(const HiZPyramid&) = delete;
+        HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+        // Reduces the depth buffer into every mip. Expects the depth writes to
+        // be made visible to compute reads by the caller; leaves the pyramid
+        // readable by later compute shaders.
+        void build(vk::raii::CommandBuffer& cmd);
+
+        vk::ImageView view() const noexcept { return image_.view(); }
+        vk::Sampler sampler() const noexcept { return *sampler_; }
+        vk::Extent2D extent() const noexcept { return image_.extent(); }
+        uint32_t mipLevels() const noexcept { return image_.mipLevels(); }
+
+    private:
+        Memory::Image image_;
+        Compute::ComputePipeline pipeline_;
+        vk::raii::Sampler sampler_ = nullptr;
+        std::vector<vk::raii::ImageView> mipViews_;
+        vk::raii::DescriptorPool pool_ = nullptr;
+        std::vector<vk::DescriptorSet> sets_; // one per mip, owned by pool_
+        bool initialized_ = false;            // first build() leaves Undefined
+    };
+
+} // namespace Core::Culling
@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace Core::Debug {
+
+    struct DebugMessageConfig {
+        vk::DebugUtilsMessageSeverityFlagsEXT severities =
+            vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning |
+            vk::DebugUtilsMessageSeverityFlagBitsEXT::eError;
+        vk::DebugUtilsMessageTypeFlagsEXT types =
+            vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral |
+            vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation;
+        // per message id: print the first `burst` occurrences, then at most
+        // one per `interval` with the number suppressed in between
+        uint32_t burst = 3;
+        std::chrono::milliseconds interval{ 1000 };
+    };
+
+    struct DebugMessageStats {
+        int32_t id = 0;
+        std::string name;       // pMessageIdName of the first occurrence
+        uint64_t count = 0;     // everything the driver reported
+        uint64_t printed = 0;   // made it past the rate limit
+        vk::DebugUtilsMessageSeverityFlagBitsEXT severity{};
+    };
+
+    // Debug-utils messenger callback that does as little as possible inside
+    // the driver call: count the message id in a lock-free table, and if the
+    // rate limit lets it through, copy it into a lock-free ring. A background
+    // thread formats and writes the messages.
+    class DebugMessageSink {
+    public:
+        explicit DebugMessageSink(DebugMessageConfig config = {}, std::ostream* out = nullptr);
+        ~DebugMessageSink();
+
+        DebugMessageSink(const DebugMessageSink&) = delete;
+        DebugMessageSink& operator=(const DebugMessageSink&) = delete;
+
+        // Messenger create info pointing at this sink.
+        vk::DebugUtilsMessengerCreateInfoEXT createInfo();
+
+        // Per message id counters, most frequent first.
+        std::vector<DebugMessageStats> stats() const;
+        uint64_t totalMessages() const noexcept { return total_.load(std::memory_order_relaxed); }
+        // Messages lost because the ring was full.
+        uint64_t droppedMessages() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+        // Blocks until everything queued so far is written.
+        void flush();
+
+    private:
+        static VKAPI_ATTR vk::Bool32 VKAPI_CALL callback(
+            vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
+            vk::DebugUtilsMessageTypeFlagsEXT type,
+            const vk::DebugUtilsMessengerCallbackDataEXT* data, void* user);
+
+        struct Counter {
+            std::atomic<uint64_t> key{ 0 };  // 0: empty, else id | kUsed
+            std::atomic<uint64_t> count{ 0 };
+            std::atomic<uint64_t> printed{ 0 };
+            std::atomic<uint64_t> lastPrinted{ 0 }; // occurrence number
+            std::atomic<int64_t> lastPrintNs{ 0 };
+            std::atomic<uint32_t> severity{ 0 };
+        };
+        static constexpr uint64_t kUsed = 1ull << 32;
+        Counter* counter(int32_t id);
+        bool admit(Counter& c, uint64_t occurrence, uint64_t& suppressed);
+
+        struct Message {
+            int32_t id;
+            uint32_t severity;
+            uint32_t type;
+            uint64_t occurrence;        // count when this copy was queued
+            uint64_t suppressedBefore;  // occurrences skipped since the previous print
+            char name[96];
+            char text[1536];
+        };
+        struct Cell {
+            std::atomic<uint64_t> sequence;
+            Message message;
+        };
+        bool push(Message const& m);
+        bool pop(Message& m);
+        void run();
+        void write(Message const& m);
+
+        DebugMessageConfig config_;
+        std::ostream* out_;
+
+        static constexpr size_t kCounters = 4096;  // open addressing, power of two
+        std::unique_ptr<Counter[]> counters_;
+
+        static constexpr size_t kRing = 1024;      // power of two
+        std::unique_ptr<Cell[]> ring_;
+        alignas(64) std::atomic<uint64_t> enqueue_{ 0 };
+        alignas(64) std::atomic<uint64_t> dequeue_{ 0 };
+
+        std::atomic<uint64_t> total_{ 0 };
+        std::atomic<uint64_t> dropped_{ 0 };
+        std::atomic<uint64_t> written_{ 0 };
+        std::atomic<uint64_t> queued_{ 0 };
+        std::atomic<uint32_t> wake_{ 0 };    // bumped by push() and stop; the worker waits on it
+
+        // consumer side: names for stats()
+        mutable std::mutex namesMutex_;
+        std::unordered_map<int32_t, std::string> names_;
+
+        std::atomic<bool> stop_{ false };
+        std::thread worker_;
+    };
+
+} // namespace Core::Debug
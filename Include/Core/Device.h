@@ -10,8 +10,12 @@ namespace Core {
 struct Queues {
   uint32_t graphicsFamily = UINT32_MAX;
   uint32_t presentFamily = UINT32_MAX;
+  // a compute-only family when the device has one (async compute),
+  // otherwise the graphics family
+  uint32_t computeFamily = UINT32_MAX;
   vk::Queue graphics{};
   vk::Queue present{};
+  vk::Queue compute{};
 };
 
 class Device {
@@ -19,14 +23,56 @@ public:
   Device() = default;
   Device(vk::raii::Instance &instance, vk::raii::SurfaceKHR &surface,
          uint32_t apiVersion = VK_API_VERSION_1_3);
+  // Skips selection; `physical` usually comes from selectPhysical().
+  Device(vk::raii::Instance &instance, vk::raii::SurfaceKHR &surface,
+         vk::raii::PhysicalDevice physical,
+         uint32_t apiVersion = VK_API_VERSION_1_3);
+  // Headless: no surface, no swapchain extension, only a compute queue is
+  // required (graphicsFamily may stay UINT32_MAX). Accepts CPU
+  // implementations such as lavapipe or SwiftShader.
+  explicit Device(vk::raii::Instance &instance,
+                  uint32_t apiVersion = VK_API_VERSION_1_3);
+  // Headless on a given GPU, usually one of selectAllPhysical(instance, true).
+  // Several Devices may share one instance.
+  Device(vk::raii::Instance &instance, vk::raii::PhysicalDevice physical,
+         uint32_t apiVersion = VK_API_VERSION_1_3);
+
+  // First suitable GPU in enumeration order. GPUs are probed in parallel,
+  // so this only needs the instance and can overlap window/surface creation.
+  static vk::raii::PhysicalDevice selectPhysical(vk::raii::Instance &instance,
+                                                 bool headless = false);
+  // Every suitable GPU, in enumeration order; empty if there is none.
+  static std::vector<vk::raii::PhysicalDevice>
+  selectAllPhysical(vk::raii::Instance &instance, bool headless = false);
 
   vk::raii::Device &vkDevice() { return device; }
   vk::raii::Device const &vkDevice() const { return device; }
 
     vk::raii::PhysicalDevice vkPhysicalDevice() { return physicalDevice; }
   const Queues &queues() const { return q; }
+  vk::raii::Queue const &graphicsQueue() const { return graphicsQueue_; }
+  vk::raii::Queue const &presentQueue() const { return presentQueue_; }
+  vk::raii::Queue const &computeQueue() const { return computeQueue_; }
+  bool headless() const { return surface_ == nullptr; }
+
+  // VK_KHR_present_id + VK_KHR_present_wait, enabled only when both the
+  // extensions and their features are available
+  bool presentWaitEnabled() const { return presentWait_; }
+  // Vulkan 1.2 drawIndirectCount (vkCmdDrawIndexedIndirectCount)
+  bool drawIndirectCountEnabled() const { return drawIndirectCount_; }
   uint32_t api() const { return apiVersion_; }
 
+  const vk::PhysicalDeviceProperties &properties() const { return properties_; }
+  const vk::PhysicalDeviceLimits &limits() const { return properties_.limits; }
+  const vk::PhysicalDeviceMemoryProperties &memoryProperties() const {
+    return memoryProperties_;
+  }
+
+  // Index of the first memory type in typeBits that has all of props;
+  // UINT32_MAX if none does.
+  uint32_t findMemoryType(uint32_t typeBits,
+                          vk::MemoryPropertyFlags props) const;
+
 private:
   vk::raii::Instance *instance_{};
 
@@ -36,15 +82,28 @@ private:
 
   vk::raii::Device device = nullptr;
   Queues q{};
+  vk::raii::Queue graphicsQueue_ = nullptr;
+  vk::raii::Queue presentQueue_ = nullptr;
+  vk::raii::Queue computeQueue_ = nullptr;
+  bool presentWait_ = false;
+  bool drawIndirectCount_ = false;
+
+  vk::PhysicalDeviceProperties properties_{};
+  vk::PhysicalDeviceMemoryProperties memoryProperties_{};
 
   uint32_t apiVersion_{}; //
 
   void pickPhysical();
-  bool isSuitable(vk::raii::PhysicalDevice const &dev) const;
+  static bool isSuitable(vk::raii::PhysicalDevice const &dev, bool headless);
+  static uint32_t findComputeFamily(
+      std::vector<vk::QueueFamilyProperties> const &families);
+  static bool hasExtension(
+      std::vector<vk::ExtensionProperties> const &available, const char *name);
 
   void createLogical();
+  void createHeadless();
 
-  std::vector<const char *> requiredDeviceExtension = {
+  static inline const std::vector<const char *> requiredDeviceExtension = {
       vk::KHRSwapchainExtensionName, vk::KHRSpirv14ExtensionName,
       vk::KHRSynchronization2ExtensionName,
       vk::KHRCreateRenderpass2ExtensionName};
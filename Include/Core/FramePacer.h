@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+struct GLFWwindow;
+
+namespace Core {
+    enum class PacingMode : uint8_t {
+        Unlimited, // poll and render as fast as the swapchain allows
+        Capped,    // render at targetFps, hybrid sleep/spin between frames
+        OnDemand,  // block in glfwWaitEventsTimeout until input or a redraw request
+    };
+
+    const char* toString(PacingMode mode);
+
+    // Decides when the main loop renders the next frame and pumps window
+    // events in between, so an idle window doesn't burn a core.
+    class FramePacer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit FramePacer(PacingMode mode = PacingMode::Capped, double targetFps = 60.0);
+
+        void setMode(PacingMode mode);
+        void setTargetFps(double fps); // <= 0: uncapped
+        PacingMode mode() const noexcept { return mode_; }
+        double targetFps() const noexcept { return targetFps_; }
+
+        // Pumps window events and sleeps until the next frame is due. Returns
+        // false when the loop should just come back (OnDemand, nothing to draw).
+        bool waitForNextFrame();
+        void frameRendered();
+
+        // Content changed; safe from any thread (wakes the event wait).
+        void requestRedraw();
+        // Input arrived; keeps rendering at full rate for a few frames so the
+        // result reaches the screen through the swapchain queue.
+        void notifyInput();
+
+        // Longest OnDemand wait for an event; on timeout waitForNextFrame()
+        // returns false without drawing, so the loop can check for exit.
+        void setIdleTimeout(std::chrono::milliseconds timeout) { idleTimeout_ = timeout; }
+
+        struct ModeStats {
+            uint64_t frames = 0;
+            double wallSeconds = 0;
+            double cpuSeconds = 0;     // whole process
+            double meanFrameMs = 0;
+            double jitterMs = 0;       // std deviation of frame-to-frame time
+            double cpuUtilization() const {
+                return wallSeconds > 0 ? cpuSeconds / wallSeconds : 0.0;
+            }
+        };
+        ModeStats stats(PacingMode mode) const;
+        std::string report() const;
+
+    private:
+        void sleepUntil(Clock::time_point deadline);
+        void account();
+
+        PacingMode mode_;
+        double targetFps_ = 0;
+        Clock::duration period_{};
+        Clock::time_point nextFrame_{};
+
+        std::atomic<bool> redrawRequested_{ true };
+        uint32_t activeFrames_ = 0;
+        std::chrono::milliseconds idleTimeout_{ 500 };
+
+        // sleep granularity is OS dependent; spin for the last `spinMargin_`
+        // and adapt it to the worst oversleep seen
+        Clock::duration spinMargin_ = std::chrono::microseconds(2000);
+
+        struct Accumulator {
+            uint64_t frames = 0;
+            uint64_t intervals = 0;
+            double mean = 0, m2 = 0;   // Welford over frame intervals, ms
+            double wallSeconds = 0, cpuSeconds = 0;
+        };
+        std::array<Accumulator, 3> acc_{};
+        Clock::time_point lastFrame_{};
+        bool lastFrameValid_ = false;  // false after an idle wait or mode switch
+        Clock::time_point lastTick_{};
+        double lastCpu_ = 0;
+    };
+}
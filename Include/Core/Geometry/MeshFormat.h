@@ -0,0 +1,167 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Binary mesh container (.cmesh). Little-endian, versioned, laid out so a
+// memory-mapped file can be copied stream by stream into GPU staging memory
+// without parsing:
+//
+//   MeshHeader (128 B)
+//   Submesh[submeshCount]              at submeshOffset
+//   vertex stream (interleaved)        at vertexOffset, kStreamAlignment aligned
+//   index stream (uint16 or uint32)    at indexOffset,  kStreamAlignment aligned
+//   MeshletStreams + its streams       at meshletOffset (version 2, optional)
+//
+// Version 2 only gives meaning to fields version 1 wrote as zero, so
+// version 1 files still parse.
+namespace Core::Geometry {
+
+    constexpr uint32_t kMeshMagic = 0x48534D43; // "CMSH"
+    constexpr uint32_t kMeshVersion = 2;
+    constexpr uint64_t kStreamAlignment = 256;   // >= any minStorageBufferOffsetAlignment
+
+    enum MeshAttribute : uint32_t {
+        AttributePosition = 1u << 0,
+        AttributeNormal = 1u << 1,
+        AttributeTexCoord = 1u << 2,
+    };
+
+    enum MeshFlag : uint32_t {
+        MeshIndex32 = 1u << 0,   // otherwise uint16 indices
+        MeshQuantized = 1u << 1, // vertex stream is QuantizedVertex, decoded against bounds
+        MeshMeshlets = 1u << 2,  // meshletOffset points at a MeshletStreams block
+    };
+
+    struct Bounds {
+        float min[3];
+        float max[3];
+        float center[3];
+        float radius;
+    };
+
+    // Version 1 vertex layout; absent attributes are zero.
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        float uv[2];
+    };
+    static_assert(sizeof(Vertex) == 32);
+
+    // Compressed vertex (16 B), see VertexQuantization.h. As vertex input:
+    //   position  R16G16B16A16_UNORM  offset 0   (w unused)
+    //   normal    R16G16_SNORM        offset 8   octahedral
+    //   uv        R16G16_SFLOAT       offset 12
+    struct QuantizedVertex {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+    static_assert(sizeof(QuantizedVertex) == 16);
+
+    // std430-compatible: vec4, vec4, uvec4. Backface cone test, true when
+    // every triangle faces away from the camera:
+    //   dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius
+    struct Meshlet {
+        float center[3];
+        float radius;
+        float coneAxis[3];
+        float coneCutoff;       // 1 when the cone is too wide to ever cull
+        uint32_t vertexOffset;  // into the meshlet vertex stream
+        uint32_t triangleOffset; // byte offset into the meshlet triangle stream, 4-aligned
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+    static_assert(sizeof(Meshlet) == 48);
+
+    // Local indices are 8-bit, so maxVertices <= 256.
+    struct MeshletLimits {
+        uint32_t maxVertices = 64;
+        uint32_t maxTriangles = 124;
+    };
+
+    struct MeshHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t flags;          // MeshFlag
+        uint32_t attributes;     // MeshAttribute
+        uint32_t vertexStride;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t submeshCount;
+        uint32_t reserved0;
+        uint64_t vertexOffset, vertexBytes;
+        uint64_t indexOffset, indexBytes;
+        uint64_t submeshOffset;
+        Bounds bounds;           // quantized positions decode against min/max
+        uint64_t meshletOffset;  // MeshletStreams, 0 when absent
+    };
+    static_assert(sizeof(MeshHeader) == 128);
+
+    struct Submesh {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t material;       // index into the source file's material list
+        uint32_t firstMeshlet;
+        Bounds bounds;
+        uint32_t meshletCount;   // meshlets never span submeshes
+        uint32_t reserved0;
+    };
+    static_assert(sizeof(Submesh) == 64);
+
+    struct MeshletStreams {
+        uint32_t meshletCount;
+        uint32_t vertexCount;    // uint32 mesh-vertex references
+        uint32_t triangleBytes;  // uint8 local index triples
+        uint32_t maxVertices;
+        uint32_t maxTriangles;
+        uint32_t reserved0;
+        uint64_t meshletsOffset, verticesOffset, trianglesOffset;
+    };
+    static_assert(sizeof(MeshletStreams) == 48);
+
+    // Validated view into a mesh file; every span points into the input.
+    struct MeshView {
+        const MeshHeader* header = nullptr;
+        std::span<const Submesh> submeshes;
+        std::span<const std::byte> vertices;
+        std::span<const std::byte> indices;
+        std::span<const Meshlet> meshlets;           // empty without MeshMeshlets
+        std::span<const uint32_t> meshletVertices;
+        std::span<const uint8_t> meshletTriangles;
+
+        bool index32() const noexcept { return header->flags & MeshIndex32; }
+        bool quantized() const noexcept { return header->flags & MeshQuantized; }
+    };
+
+    // Checks magic, version, that every stream lies inside `bytes` and that
+    // submesh and meshlet ranges lie inside their streams. `checkIndices`
+    // also checks every index against the vertex count (a pass over the
+    // index stream; for untrusted files). `bytes` must be 8-byte aligned
+    // (mappings are). Throws std::runtime_error.
+    MeshView parseMesh(std::span<const std::byte> bytes, bool checkIndices = false);
+
+    // In-memory mesh the importers produce and writeMesh() serializes.
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Submesh> submeshes; // empty: one submesh covering everything
+        uint32_t attributes = AttributePosition;
+    };
+
+    Bounds computeBounds(std::span<const Vertex> vertices);
+    Bounds computeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+    struct MeshWriteOptions {
+        bool quantize = false;  // QuantizedVertex stream instead of Vertex
+        bool meshlets = false;  // build meshlets; the index stream follows their order
+        MeshletLimits limits{};
+    };
+
+    // Uses 16-bit indices when every vertex is addressable with them.
+    void writeMesh(const std::string& path, MeshData const& mesh, MeshWriteOptions const& options = {});
+
+} // namespace Core::Geometry
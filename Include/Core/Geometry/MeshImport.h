@@ -0,0 +1,26 @@
+#pragma once
+#include <Core/Geometry/MeshFormat.h>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Core::Geometry {
+
+    // Importers for the offline converter (and the load benchmark's text
+    // baseline). Polygons are fan-triangulated, identical corners are
+    // welded, and smooth normals are generated when the source has none.
+    // All throw std::runtime_error on malformed input.
+
+    // Wavefront OBJ: v/vt/vn/f, negative indices, one submesh per usemtl.
+    MeshData importObj(std::string_view text);
+    // STL, binary or ASCII.
+    MeshData importStl(std::span<const std::byte> bytes);
+    // PLY, ascii or binary_little_endian: vertex x/y/z, nx/ny/nz, u/v (or
+    // s/t), face vertex_indices lists.
+    MeshData importPly(std::span<const std::byte> bytes);
+
+    // Picks the importer by extension (.obj, .stl, .ply).
+    MeshData importMesh(const std::string& path);
+
+} // namespace Core::Geometry
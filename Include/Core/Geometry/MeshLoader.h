@@ -0,0 +1,73 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Geometry/VertexQuantization.h>
+#include <Core/Memory/Buffer.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Geometry {
+
+    struct GpuMesh {
+        Memory::Buffer vertices;
+        Memory::Buffer indices;
+        vk::IndexType indexType = vk::IndexType::eUint16;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t vertexStride = 0;
+        uint32_t attributes = 0;
+        Bounds bounds{};
+        std::vector<Submesh> submeshes;
+
+        // QuantizedVertex stream: decode with `transform` (push constants)
+        bool quantized = false;
+        QuantizationTransform transform{};
+
+        // Storage buffers for mesh shading / meshlet culling; empty when the
+        // file has no meshlets.
+        Memory::Buffer meshlets;
+        Memory::Buffer meshletVertices;
+        Memory::Buffer meshletTriangles;
+        uint32_t meshletCount = 0;
+    };
+
+    struct MeshLoadStats {
+        uint64_t meshes = 0;
+        uint64_t bytes = 0;          // stream bytes uploaded
+        uint64_t directWrites = 0;   // streams written straight into host-visible VRAM
+        double seconds = 0.0;        // map to upload complete
+
+        double megabytesPerSecond() const {
+            return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+    };
+
+    // Loads .cmesh files into device-local vertex, index and meshlet buffers.
+    // The file is memory-mapped and each stream is copied once, from the
+    // mapping into mapped staging memory (or directly into the destination
+    // when it is host-visible, as on UMA and ReBAR), then copied on the GPU.
+    // Nothing is parsed beyond the headers; quantized streams upload as-is.
+    // Blocks until the upload has completed.
+    class MeshLoader {
+    public:
+        explicit MeshLoader(Device& device);
+
+        MeshLoader(const MeshLoader&) = delete;
+        MeshLoader& operator=(const MeshLoader&) = delete;
+
+        GpuMesh load(const std::string& path);
+        GpuMesh upload(MeshView const& mesh);
+
+        MeshLoadStats const& stats() const noexcept { return stats_; }
+
+    private:
+        Device* device_;
+        vk::raii::Queue const* queue_;
+        vk::raii::CommandPool pool_ = nullptr;
+        vk::raii::Fence fence_ = nullptr;
+        MeshLoadStats stats_;
+    };
+
+} // namespace Core::Geometry
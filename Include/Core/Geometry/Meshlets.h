@@ -0,0 +1,39 @@
+#pragma once
+#include <Core/Geometry/MeshFormat.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core::Geometry {
+
+    struct MeshletData {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> vertices;   // meshlet-local -> mesh vertex
+        std::vector<uint8_t> triangles;   // local index triples, each meshlet 4-byte padded
+    };
+
+    // Partitions one index range into meshlets and appends them to `out`.
+    // Greedy: keeps adding the adjacent triangle that brings the fewest new
+    // vertices, so meshlets stay compact (tight spheres, narrow cones) and
+    // reuse their vertices. Runs at import time in the converter and is
+    // cheap enough for runtime-generated geometry.
+    void appendMeshlets(MeshletData& out, std::span<const Vertex> vertices,
+        std::span<const uint32_t> indices, MeshletLimits limits = {});
+
+    // Index buffer in meshlet order: the same triangles, better vertex
+    // cache locality for the classic vertex pipeline.
+    std::vector<uint32_t> meshletIndices(MeshletData const& data,
+        size_t firstMeshlet = 0, size_t meshletCount = SIZE_MAX);
+
+    struct VertexCacheStats {
+        double acmr = 0.0;     // vertex shader invocations per triangle (0.5 .. 3)
+        double atvr = 0.0;     // invocations per unique vertex (1 is ideal)
+        double hitRate = 0.0;  // fraction of indices served from the cache
+    };
+
+    // Simulates a FIFO post-transform cache of `cacheSize` entries.
+    VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+        uint32_t cacheSize = 16);
+
+} // namespace Core::Geometry
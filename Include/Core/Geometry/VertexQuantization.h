@@ -0,0 +1,32 @@
+#pragma once
+#include <Core/Geometry/MeshFormat.h>
+#include <cstdint>
+#include <span>
+
+namespace Core::Geometry {
+
+    // position = offset + unorm16 * scale, per mesh. Taken from the mesh
+    // bounds, so a .cmesh needs no extra fields to decode.
+    struct QuantizationTransform {
+        float offset[3];
+        float scale[3];
+    };
+
+    QuantizationTransform quantizationTransform(Bounds const& bounds);
+
+    // Vertex -> QuantizedVertex: positions to 16-bit unorm within the
+    // transform, normals octahedral-encoded to 2 x snorm16, uvs to half.
+    // `out` must hold vertices.size() elements. The SIMD path (Simd.h)
+    // produces the same bytes as quantizeVerticesScalar.
+    void quantizeVertices(std::span<const Vertex> vertices, std::span<QuantizedVertex> out,
+        QuantizationTransform const& transform);
+    void quantizeVerticesScalar(std::span<const Vertex> vertices, std::span<QuantizedVertex> out,
+        QuantizationTransform const& transform);
+
+    // CPU mirror of shaders/quantized_vertex.glsl, for tools and checks.
+    Vertex dequantize(QuantizedVertex const& v, QuantizationTransform const& transform);
+
+    uint16_t floatToHalf(float value);
+    float halfToFloat(uint16_t value);
+
+} // namespace Core::Geometry
@@ -0,0 +1,41 @@
+#pragma once
+#include <Core/Device.h>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Memory {
+
+    // One VkBuffer with its own dedicated VkDeviceMemory. Host-visible buffers
+    // stay mapped for their whole lifetime.
+    class Buffer {
+    public:
+        Buffer() = default;
+        Buffer(Device& device, vk::DeviceSize size, vk::BufferUsageFlags usage,
+            vk::MemoryPropertyFlags required,
+            vk::MemoryPropertyFlags preferred = {});
+
+        Buffer(Buffer&&) noexcept = default;
+        Buffer& operator=(Buffer&&) noexcept = default;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        vk::Buffer handle() const noexcept { return *buffer_; }
+        vk::DeviceSize size() const noexcept { return size_; }
+        void* mapped() const noexcept { return mapped_; }
+        vk::DeviceAddress address() const noexcept { return address_; }
+        vk::MemoryPropertyFlags memoryFlags() const noexcept { return memoryFlags_; }
+
+        bool empty() const noexcept { return size_ == 0; }
+
+    private:
+        // memory first so the buffer is destroyed before its backing store
+        vk::raii::DeviceMemory memory_ = nullptr;
+        vk::raii::Buffer buffer_ = nullptr;
+        vk::DeviceSize size_ = 0;
+        void* mapped_ = nullptr;
+        vk::DeviceAddress address_ = 0;
+        vk::MemoryPropertyFlags memoryFlags_{};
+    };
+
+} // namespace Core::Memory
@@ -0,0 +1,73 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Memory/Buffer.h>
+#include <Core/Memory/LinearAllocator.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Core::Memory {
+
+    struct FrameAllocation {
+        void* cpu = nullptr;            // persistently mapped, write-only from the CPU
+        vk::Buffer buffer{};            // the allocator's single backing buffer
+        uint32_t dynamicOffset = 0;     // offset from the start of `buffer`
+        vk::DeviceSize size = 0;
+        vk::DeviceAddress address = 0;  // buffer address + dynamicOffset
+
+        explicit operator bool() const noexcept { return cpu != nullptr; }
+        template <class T> T* as() const noexcept { return static_cast<T*>(cpu); }
+    };
+
+    // Per-frame-in-flight bump allocator for small, short-lived GPU data
+    // (per-draw constants, dynamic storage). One mapped buffer is split into
+    // `framesInFlight` slots; allocating is a single atomic add, so any number
+    // of recording threads can share it. A slot is recycled in O(1) once the
+    // frame that last used it has retired on the frame timeline.
+    class FrameAllocator {
+    public:
+        FrameAllocator(Device& device, vk::DeviceSize bytesPerFrame,
+            uint32_t framesInFlight);
+
+        FrameAllocator(FrameAllocator&&) noexcept = default;
+        FrameAllocator& operator=(FrameAllocator&&) noexcept = default;
+
+        // Frame N is expected to signal `timeline` to N when its work is
+        // submitted. Waits only if the slot's previous frame is still in flight.
+        // Frames count from 1, as a timeline can't be signalled to its initial
+        // 0; slotFrame_ uses 0 for a slot that hasn't been used yet.
+        void beginFrame(uint64_t frameNumber, vk::raii::Semaphore const& timeline);
+
+        // Thread-safe. Returns an empty allocation when the slot is full.
+        FrameAllocation allocate(vk::DeviceSize size);
+
+        template <class T>
+        FrameAllocation push(T const& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            FrameAllocation a = allocate(sizeof(T));
+            if (a) std::memcpy(a.cpu, &value, sizeof(T));
+            return a;
+        }
+
+        vk::Buffer buffer() const noexcept { return buffer_.handle(); }
+        vk::DeviceSize alignment() const noexcept { return alignment_; }
+        vk::DeviceSize bytesPerFrame() const noexcept { return slotSize_; }
+        uint32_t framesInFlight() const noexcept { return framesInFlight_; }
+        uint32_t currentSlot() const noexcept { return current_; }
+        vk::DeviceSize bytesUsed() const noexcept;
+
+    private:
+        Device* device_ = nullptr;
+        Buffer buffer_;
+        vk::DeviceSize alignment_ = 0;
+        vk::DeviceSize slotSize_ = 0;
+        uint32_t framesInFlight_ = 0;
+        uint32_t current_ = 0;
+
+        std::vector<std::unique_ptr<LinearAllocator>> slots_; // atomics don't move
+        std::vector<uint64_t> slotFrame_; // frame number that last used each slot, 0 = none
+    };
+
+} // namespace Core::Memory
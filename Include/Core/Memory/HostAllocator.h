@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <vulkan/vulkan.hpp>
+
+namespace Core::Memory {
+
+    // Which part of the engine an allocation was made for. Each tag gets its
+    // own vk::AllocationCallbacks whose pUserData identifies it.
+    enum class HostTag : uint8_t {
+        Instance, Device, Swapchain, Shader, Pipeline, Memory, Commands, Sync, Query, Other,
+        Count
+    };
+    const char* toString(HostTag tag);
+
+    struct HostAllocationStats {
+        uint64_t bytes = 0;            // live
+        uint64_t count = 0;            // live
+        uint64_t peakBytes = 0;
+        uint64_t totalAllocations = 0; // allocations + reallocations ever made: churn
+    };
+
+    // Engine-wide Vulkan host allocator. Small blocks (<= 4 KiB including
+    // header and alignment padding) come from power-of-two size-class pools,
+    // larger ones from malloc. Every block carries a small header, so frees
+    // and reallocations find their class and account to the right tag and
+    // VkSystemAllocationScope. Pools are never returned to the OS; that is
+    // what keeps long sessions from fragmenting the general heap.
+    class HostAllocator {
+    public:
+        static HostAllocator& instance();
+
+        // Null when tracking is disabled, which makes Vulkan use its default.
+        const vk::AllocationCallbacks* callbacks(HostTag tag) const noexcept;
+        // Only affects objects created afterwards; each object keeps the
+        // callbacks it was created with.
+        void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+        HostAllocationStats stats(HostTag tag) const noexcept;
+        HostAllocationStats stats(vk::SystemAllocationScope scope) const noexcept;
+        // Driver-internal allocations reported through pfnInternalAllocation.
+        HostAllocationStats internalStats() const noexcept;
+        std::string report() const;
+
+        static constexpr size_t kSizeClasses = 9;   // 16 B .. 4 KiB
+        static constexpr size_t kMaxPooled = 4096;
+
+    private:
+        HostAllocator();
+
+        struct Counters {
+            std::atomic<uint64_t> bytes{ 0 }, count{ 0 }, peakBytes{ 0 }, total{ 0 };
+            void add(uint64_t size) noexcept;
+            void remove(uint64_t size) noexcept;
+            HostAllocationStats load() const noexcept;
+        };
+
+        void* allocate(size_t size, size_t alignment, HostTag tag, vk::SystemAllocationScope scope);
+        void* reallocate(void* original, size_t size, size_t alignment, HostTag tag,
+            vk::SystemAllocationScope scope);
+        void free(void* memory) noexcept;
+
+        // C signatures: the PFN types in vk::AllocationCallbacks differ
+        // between vulkan-hpp versions, the C struct layout does not
+        static VKAPI_ATTR void* VKAPI_CALL vkAllocate(void* user, size_t size, size_t alignment,
+            VkSystemAllocationScope scope);
+        static VKAPI_ATTR void* VKAPI_CALL vkReallocate(void* user, void* original, size_t size,
+            size_t alignment, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL vkFree(void* user, void* memory);
+        static VKAPI_ATTR void VKAPI_CALL vkInternalAllocate(void* user, size_t size,
+            VkInternalAllocationType type, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL vkInternalFree(void* user, size_t size,
+            VkInternalAllocationType type, VkSystemAllocationScope scope);
+
+        struct TagState {
+            HostAllocator* owner;
+            HostTag tag;
+        };
+        std::array<TagState, static_cast<size_t>(HostTag::Count)> tagStates_{};
+        std::array<VkAllocationCallbacks, static_cast<size_t>(HostTag::Count)> callbacks_{};
+
+        std::array<Counters, static_cast<size_t>(HostTag::Count)> tagCounters_;
+        std::array<Counters, 5> scopeCounters_;  // VkSystemAllocationScope
+        Counters internal_;
+
+        struct Pool;
+        std::array<Pool*, kSizeClasses> pools_{};
+        std::atomic<bool> enabled_{ true };
+    };
+
+    // Shorthand used at every vk::raii creation site.
+    inline const vk::AllocationCallbacks* hostCallbacks(HostTag tag) noexcept {
+        return HostAllocator::instance().callbacks(tag);
+    }
+
+} // namespace Core::Memory
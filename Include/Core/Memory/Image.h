@@ -0,0 +1,57 @@
+#pragma once
+#include <Core/Device.h>
+#include <algorithm>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Memory {
+
+    // One 2D VkImage with its own dedicated device-local VkDeviceMemory and a
+    // view over the whole mip chain.
+    class Image {
+    public:
+        Image() = default;
+        Image(Device& device, vk::Format format, vk::Extent2D extent,
+            uint32_t mipLevels, vk::ImageUsageFlags usage,
+            vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+
+        Image(Image&&) noexcept = default;
+        Image& operator=(Image&&) noexcept = default;
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+
+        vk::Image handle() const noexcept { return *image_; }
+        vk::ImageView view() const noexcept { return *view_; }
+        vk::Format format() const noexcept { return format_; }
+        vk::Extent2D extent() const noexcept { return extent_; }
+        uint32_t mipLevels() const noexcept { return mipLevels_; }
+        vk::ImageAspectFlags aspect() const noexcept { return aspect_; }
+        vk::DeviceSize memorySize() const noexcept { return memorySize_; }
+
+        vk::Extent2D mipExtent(uint32_t mip) const noexcept {
+            return { std::max(1u, extent_.width >> mip), std::max(1u, extent_.height >> mip) };
+        }
+        vk::ImageSubresourceRange range(uint32_t baseMip = 0,
+            uint32_t mipCount = vk::RemainingMipLevels) const noexcept {
+            return { aspect_, baseMip, mipCount, 0, 1 };
+        }
+
+        bool empty() const noexcept { return mipLevels_ == 0; }
+
+        // floor(log2(max(w, h))) + 1
+        static uint32_t fullMipCount(vk::Extent2D extent) noexcept;
+
+    private:
+        // memory first so the image is destroyed before its backing store
+        vk::raii::DeviceMemory memory_ = nullptr;
+        vk::raii::Image image_ = nullptr;
+        vk::raii::ImageView view_ = nullptr;
+        vk::Format format_ = vk::Format::eUndefined;
+        vk::Extent2D extent_{};
+        uint32_t mipLevels_ = 0;
+        vk::ImageAspectFlags aspect_{};
+        vk::DeviceSize memorySize_ = 0;
+    };
+
+} // namespace Core::Memory
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace Core::Memory {
+
+    constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Lock-free bump allocator over an abstract [0, capacity) range. Every
+    // request is rounded up to `granularity` (a power of two), so a single
+    // fetch_add is enough and allocation never retries under contention.
+    // It only hands out offsets; the owner decides what memory they index.
+    class LinearAllocator {
+    public:
+        static constexpr uint64_t kInvalid = ~0ull;
+
+        LinearAllocator() = default;
+        LinearAllocator(uint64_t capacity, uint64_t granularity) noexcept
+            : capacity_(capacity), granularity_(granularity) {}
+
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+        // Offset of the new block, or kInvalid once the range is exhausted.
+        uint64_t allocate(uint64_t size) noexcept {
+            const uint64_t rounded = alignUp(size, granularity_);
+            const uint64_t offset = head_.fetch_add(rounded, std::memory_order_relaxed);
+            return offset + rounded <= capacity_ ? offset : kInvalid;
+        }
+
+        // O(1); the caller guarantees nobody still reads the old blocks.
+        void reset() noexcept { head_.store(0, std::memory_order_relaxed); }
+
+        uint64_t capacity() const noexcept { return capacity_; }
+        uint64_t granularity() const noexcept { return granularity_; }
+        // May exceed capacity() after failed allocations.
+        uint64_t used() const noexcept { return head_.load(std::memory_order_relaxed); }
+
+    private:
+        // keep the hot counter on its own cache line
+        alignas(64) std::atomic<uint64_t> head_{ 0 };
+        uint64_t capacity_ = 0;
+        uint64_t granularity_ = 1;
+    };
+
+} // namespace Core::Memory
@@ -0,0 +1,120 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Memory/Buffer.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Memory {
+
+    // What the worker threads turn the copied bytes into.
+    enum class ReadbackFormat : uint8_t {
+        Raw,    // bytes as copied (images: tightly packed texels)
+        RGBA8,  // images only: 8-bit RGBA, whatever the source format
+        PPM,    // images only: binary P6 file contents, ready to write to disk
+    };
+
+    struct ReadbackData {
+        std::vector<std::byte> bytes;
+        ReadbackFormat format = ReadbackFormat::Raw;
+        vk::Format sourceFormat = vk::Format::eUndefined; // images
+        uint32_t width = 0, height = 0;                   // images
+
+        template <class T>
+        std::span<const T> as() const {
+            return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+        }
+    };
+
+    struct ReadbackStats {
+        uint64_t requests = 0;
+        uint64_t bytes = 0;
+        uint64_t poolHits = 0, poolMisses = 0;
+        uint64_t pooledBytes = 0;  // idle staging memory currently kept
+        uint64_t pending = 0;      // recorded, waiting for the GPU or a worker
+    };
+
+    // Records copies into pooled, persistently mapped host-cached staging
+    // buffers. Each request names the timeline value of the submission it
+    // was recorded into; poll() hands retired ones to worker threads, which
+    // convert, resolve the future and return the staging buffer to the pool.
+    // Nothing here waits on the GPU except the destructor.
+    //
+    // Recording and poll() may happen on different threads.
+    class ReadbackManager {
+    public:
+        explicit ReadbackManager(Device& device, uint32_t workers = 1,
+            vk::DeviceSize maxPooledBytes = 64u << 20);
+        ~ReadbackManager();
+
+        ReadbackManager(const ReadbackManager&) = delete;
+        ReadbackManager& operator=(const ReadbackManager&) = delete;
+
+        // The copy waits for earlier shader/transfer writes in `cmd`.
+        std::future<ReadbackData> readBuffer(vk::raii::CommandBuffer& cmd, vk::Buffer buffer,
+            vk::DeviceSize offset, vk::DeviceSize size,
+            vk::raii::Semaphore const& timeline, uint64_t value);
+
+        // `layout` is the image's layout at this point in `cmd`; it is
+        // restored after the copy. Single mip, single layer, color aspect.
+        std::future<ReadbackData> readImage(vk::raii::CommandBuffer& cmd, vk::Image image,
+            vk::ImageLayout layout, vk::Format format, vk::Extent2D extent,
+            vk::raii::Semaphore const& timeline, uint64_t value,
+            ReadbackFormat convertTo = ReadbackFormat::Raw);
+        void readImage(vk::raii::CommandBuffer& cmd, vk::Image image,
+            vk::ImageLayout layout, vk::Format format, vk::Extent2D extent,
+            vk::raii::Semaphore const& timeline, uint64_t value,
+            ReadbackFormat convertTo, std::promise<ReadbackData> promise);
+
+        // Non-blocking: reads each timeline's counter once.
+        void poll();
+
+        ReadbackStats stats() const;
+
+    private:
+        struct Request {
+            const vk::raii::Semaphore* timeline;
+            uint64_t value;
+            Buffer staging;
+            vk::DeviceSize size;
+            ReadbackFormat convertTo;
+            vk::Format format;
+            vk::Extent2D extent;
+            std::promise<ReadbackData> promise;
+        };
+
+        Buffer acquire(vk::DeviceSize size);
+        void release(Buffer buffer);
+        void enqueue(Request request);
+        void work();
+
+        Device* device_;
+        vk::DeviceSize maxPooledBytes_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::multimap<vk::DeviceSize, Buffer> pool_; // capacity -> idle buffer
+        std::deque<Request> pending_;                 // waiting for the GPU
+        std::deque<Request> ready_;                   // waiting for a worker
+        ReadbackStats stats_;
+        bool stop_ = false;
+        std::vector<std::thread> workers_;
+    };
+
+    // Tightly packed texels of a supported 8/16/32-bit RGBA or BGRA format
+    // to 8-bit RGBA. Float formats are clamped, not tone mapped. Throws
+    // std::runtime_error for anything else.
+    std::vector<std::byte> toRgba8(std::span<const std::byte> texels, vk::Format format,
+        uint32_t width, uint32_t height);
+    // Binary PPM (P6) from 8-bit RGBA; alpha is dropped.
+    std::vector<std::byte> encodePpm(std::span<const std::byte> rgba8, uint32_t width, uint32_t height);
+
+} // namespace Core::Memory
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace Core {
+    class Swapchain;
+
+    // Input-to-present latency: from the moment a frame sampled input (right
+    // after polling window events) until the presentation engine reports the
+    // image on screen (VK_KHR_present_wait). Without present_wait the end
+    // point falls back to vkQueuePresentKHR returning, which only captures the
+    // CPU side of the queue.
+    class PresentLatency {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Summary {
+            size_t samples = 0;
+            double p50Ms = 0, p95Ms = 0, p99Ms = 0, maxMs = 0;
+            bool onScreen = false; // true when measured with present_wait
+        };
+
+        void presented(uint64_t presentId, Clock::time_point inputSampled,
+            bool presentWait);
+
+        // Non-blocking; resolves presents that have completed. Resolution is
+        // one call, i.e. one frame.
+        void poll(Swapchain const& swapchain);
+        // A present the caller just blocked on has completed.
+        void completed(uint64_t presentId);
+
+        // Pending ids belong to the old swapchain after a recreate.
+        void dropPending() { pending_.clear(); }
+
+        Summary summary() const;
+        std::string report() const;
+
+    private:
+        void addSample(Clock::time_point inputSampled, Clock::time_point shown);
+
+        struct Pending {
+            uint64_t presentId;
+            Clock::time_point inputSampled;
+        };
+        std::deque<Pending> pending_;
+
+        static constexpr size_t kWindow = 512;
+        std::array<float, kWindow> samplesMs_{};
+        size_t count_ = 0;
+        bool onScreen_ = false;
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Profiling/Profiler.h>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Profiling {
+
+    // Timestamp queries around passes, one query pool per frame in flight.
+    // Results of a slot are read back when the slot comes round again, i.e.
+    // once its frame has retired, so resolving never waits on the GPU. Zones
+    // also open a VK_EXT_debug_utils label when `debugLabels` is set. Each
+    // profiler has its own row in the trace.
+    class GpuProfiler {
+    public:
+        GpuProfiler(Device& device, uint32_t framesInFlight, bool debugLabels,
+            uint32_t maxZonesPerFrame = 256);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // Record first thing in the slot's command buffer, after the slot's
+        // previous frame has retired.
+        void beginFrame(vk::raii::CommandBuffer& cmd, uint32_t slot);
+
+        void begin(vk::raii::CommandBuffer& cmd, const char* name);
+        void end(vk::raii::CommandBuffer& cmd);
+
+        bool timestampsSupported() const noexcept { return validBits_ != 0; }
+
+    private:
+        void resolve(uint32_t slot);
+
+        struct Zone {
+            const char* name;
+            uint32_t beginQuery;
+            uint32_t endQuery;
+        };
+        struct Frame {
+            vk::raii::QueryPool pool = nullptr;
+            std::vector<Zone> zones;
+            uint32_t used = 0;
+        };
+
+        Track* track_ = nullptr;
+        std::vector<Frame> frames_;
+        std::vector<uint32_t> open_; // zone indices, innermost last
+        uint32_t current_ = 0;
+        uint32_t capacity_ = 0;      // queries per pool
+        uint32_t validBits_ = 0;
+        double periodNs_ = 1.0;
+        bool debugLabels_ = false;
+        // GPU ticks -> profiler clock; tightened every frame, see resolve()
+        int64_t offsetNs_ = INT64_MAX;
+    };
+
+    class GpuZone {
+    public:
+        GpuZone(GpuProfiler* profiler, vk::raii::CommandBuffer& cmd, const char* name)
+            : profiler_(profiler), cmd_(cmd) {
+            if (profiler_) profiler_->begin(cmd_, name);
+        }
+        ~GpuZone() { if (profiler_) profiler_->end(cmd_); }
+
+        GpuZone(const GpuZone&) = delete;
+        GpuZone& operator=(const GpuZone&) = delete;
+
+    private:
+        GpuProfiler* profiler_;
+        vk::raii::CommandBuffer& cmd_;
+    };
+
+} // namespace Core::Profiling
+
+#if CORE_PROFILER_ENABLED
+#define CORE_PROFILE_GPU_ZONE(profiler, cmd, name) \
+    ::Core::Profiling::GpuZone CORE_PROFILE_CONCAT(coreProfileGpuZone_, __LINE__)(profiler, cmd, name)
+#else
+#define CORE_PROFILE_GPU_ZONE(profiler, cmd, name) ((void)0)
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// CPU zones are recorded into per-thread lock-free buffers and exported as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev). Build with
+// CORE_ENABLE_PROFILER=ON to compile them in; otherwise every macro below
+// expands to nothing.
+#ifndef CORE_PROFILER_ENABLED
+#define CORE_PROFILER_ENABLED 0
+#endif
+
+namespace Core::Profiling {
+
+    // Nanoseconds on the steady clock, relative to process start.
+    uint64_t now() noexcept;
+
+    // A trace row of its own, for events recorded away from the thread
+    // that timed them (GPU queries). One producer at a time.
+    struct Track;
+    Track* createTrack(std::string name);
+    // Keeps the recorded events; the track must not be used afterwards.
+    void releaseTrack(Track* track) noexcept;
+
+    // `name` must outlive the profiler (string literals).
+    void recordCpu(const char* name, uint64_t startNs, uint64_t endNs) noexcept;
+    void recordGpu(Track* track, const char* name, uint64_t startNs, uint64_t endNs) noexcept;
+    void setThreadName(std::string name);
+
+    // Moves every thread buffer's events into the trace. Each buffer holds
+    // 16K events, so call this regularly (once per frame) in long sessions.
+    // The trace keeps the most recent 1M events; older ones count as
+    // dropped.
+    void collect();
+    // Drains every thread buffer and writes all events recorded so far.
+    bool writeChromeTrace(const std::string& path);
+    // Events dropped because a thread's buffer was full between drains, or
+    // pushed out of the trace by newer ones.
+    uint64_t droppedEvents() noexcept;
+
+    class CpuZone {
+    public:
+        explicit CpuZone(const char* name) noexcept : name_(name), start_(now()) {}
+        ~CpuZone() { recordCpu(name_, start_, now()); }
+
+        CpuZone(const CpuZone&) = delete;
+        CpuZone& operator=(const CpuZone&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t start_;
+    };
+
+} // namespace Core::Profiling
+
+#define CORE_PROFILE_CONCAT_INNER(a, b) a##b
+#define CORE_PROFILE_CONCAT(a, b) CORE_PROFILE_CONCAT_INNER(a, b)
+
+#if CORE_PROFILER_ENABLED
+#define CORE_PROFILE_ZONE(name) \
+    ::Core::Profiling::CpuZone CORE_PROFILE_CONCAT(coreProfileZone_, __LINE__)(name)
+#define CORE_PROFILE_THREAD(name) ::Core::Profiling::setThreadName(name)
+#define CORE_PROFILE_COLLECT() ::Core::Profiling::collect()
+#else
+#define CORE_PROFILE_ZONE(name) ((void)0)
+#define CORE_PROFILE_THREAD(name) ((void)0)
+#define CORE_PROFILE_COLLECT() ((void)0)
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Utils/Hash/Hash.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Render {
+
+    // Hashes what a cached recording depends on: pipelines, descriptor sets,
+    // buffers, extents. Handles alone can repeat after a free, so the
+    // owner's generation must be covered where there is one
+    // (Swapchain::generation(), ShaderLoader::generation(),
+    // TextureStreamer::generation()): add it here, or have the cache watch()
+    // it.
+    class CommandKey {
+    public:
+        template <class T>
+        CommandKey& add(T const& value) noexcept {
+            static_assert(std::is_trivially_copyable_v<T>);
+            hash_ = Hash::combine64(hash_, Hash::fnv1a(&value, sizeof(T)));
+            return *this;
+        }
+        template <class T>
+        CommandKey& add(std::span<const T> values) noexcept {
+            for (T const& v : values) add(v);
+            return *this;
+        }
+        uint64_t value() const noexcept { return hash_; }
+
+    private:
+        uint64_t hash_ = Hash::fnv1a(nullptr, 0);
+    };
+
+    // Attachments of the dynamic render pass a recording is executed in.
+    struct RenderingInheritance {
+        std::span<const vk::Format> colorFormats;
+        vk::Format depthFormat = vk::Format::eUndefined;
+        vk::Format stencilFormat = vk::Format::eUndefined;
+        vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+    };
+
+    struct CommandCacheStats {
+        uint64_t replays = 0;        // served without recording
+        uint64_t records = 0;        // first use, key change or invalidation
+        uint64_t invalidations = 0;  // invalidate() calls
+        double recordMs = 0.0;       // CPU time spent in recorders
+        double savedMs = 0.0;        // each replay credited with its entry's last recording time
+
+        double hitRate() const noexcept {
+            return replays + records ? double(replays) / double(replays + records) : 0.0;
+        }
+    };
+
+    // Secondary command buffers recorded once and replayed with
+    // executeCommands() for as long as their key stays the same. Recordings
+    // are SIMULTANEOUS_USE, so one buffer can be pending in every frame in
+    // flight; a replaced recording is kept until the frame timeline passes
+    // the last frame that executed it, then reset and reused.
+    //
+    // Not thread-safe: the pool is externally synchronized.
+    class CommandCache {
+    public:
+        CommandCache(Device& device, uint32_t queueFamily);
+
+        CommandCache(const CommandCache&) = delete;
+        CommandCache& operator=(const CommandCache&) = delete;
+
+        // Frees recordings no frame up to `completedValue` still uses.
+        void collect(uint64_t completedValue);
+
+        // The recording for `id`, re-recorded through `record(cmd)` when the
+        // key changed or the cache was invalidated. `frame` is the timeline
+        // value of the submission it will be executed in. With `rendering`
+        // the recording continues that dynamic render pass (which must be
+        // begun with eContentsSecondaryCommandBuffers); without, it runs
+        // outside render passes.
+        template <class F>
+        vk::CommandBuffer get(uint32_t id, CommandKey const& key, uint64_t frame,
+            RenderingInheritance const* rendering, F&& record) {
+            checkWatched();
+            const uint64_t fullKey = keyFor(key, rendering);
+            if (const vk::CommandBuffer cmd = replay(id, fullKey, frame))
+                return cmd;
+            vk::raii::CommandBuffer& cmd = beginRecording(id, fullKey, frame, rendering);
+            const auto start = std::chrono::steady_clock::now();
+            record(cmd);
+            return endRecording(id, std::chrono::steady_clock::now() - start);
+        }
+
+        // Swapchain recreation, shader reload, reallocation the keys can't
+        // see: everything is re-recorded on next use.
+        void invalidate() noexcept;
+        // Invalidates on the next get() whenever `generation` returns
+        // something new; for the owners of what recordings reference.
+        void watch(std::function<uint64_t()> generation);
+        // Drops the recording once the frames that executed it retire.
+        void remove(uint32_t id);
+
+        CommandCacheStats const& stats() const noexcept { return stats_; }
+        size_t size() const noexcept { return entries_.size(); }
+
+    private:
+        struct Entry {
+            vk::raii::CommandBuffer cmd = nullptr;
+            uint64_t key = 0;
+            uint64_t epoch = 0;        // invalidate() count at recording time
+            uint64_t lastFrame = 0;    // newest submission it was executed in
+            std::chrono::steady_clock::duration recordTime{};
+        };
+        struct Retired {
+            vk::raii::CommandBuffer cmd;
+            uint64_t releaseAt;
+        };
+        struct Watched {
+            std::function<uint64_t()> generation;
+            uint64_t seen;
+        };
+
+        static uint64_t keyFor(CommandKey const& key, RenderingInheritance const* rendering) noexcept;
+        vk::CommandBuffer replay(uint32_t id, uint64_t key, uint64_t frame);
+        vk::raii::CommandBuffer& beginRecording(uint32_t id, uint64_t key, uint64_t frame,
+            RenderingInheritance const* rendering);
+        vk::CommandBuffer endRecording(uint32_t id, std::chrono::steady_clock::duration elapsed);
+        vk::raii::CommandBuffer acquire();
+        void checkWatched();
+
+        Device* device_;
+        vk::raii::CommandPool pool_ = nullptr;
+        std::unordered_map<uint32_t, Entry> entries_;
+        std::vector<Retired> retired_;
+        std::vector<vk::raii::CommandBuffer> free_;
+        std::vector<Watched> watched_;
+        uint64_t epoch_ = 0;
+        CommandCacheStats stats_;
+    };
+
+} // namespace Core::Render
@@ -0,0 +1,97 @@
+#pragma once
+#include <Core/Utils/RadixSort.h>
+#include <Core/Utils/ThreadPool.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core::Render {
+
+    // 64-bit draw order. Opaque draws sort by state, most expensive change
+    // first, then front to back inside a state group:
+    //
+    //   63      62..51    50..35     34..19   18..0
+    //   layer=0 pipeline  material   mesh     depth
+    //
+    // Translucent draws come after every opaque one and sort back to front;
+    // state only breaks ties:
+    //
+    //   63      62..44           43..32    31..16     15..0
+    //   layer=1 inverted depth   pipeline  material   mesh
+    //
+    // Ids wider than their field are truncated: only the order depends on
+    // the key, batching compares the full ids.
+    namespace SortKey {
+        constexpr uint32_t kPipelineBits = 12;
+        constexpr uint32_t kMaterialBits = 16;
+        constexpr uint32_t kMeshBits = 16;
+        constexpr uint32_t kDepthBits = 19;
+
+        // depth: normalized view depth, 0 at the near plane; clamped to [0, 1]
+        uint64_t opaque(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+        uint64_t translucent(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+    }
+
+    struct DrawItem {
+        uint32_t pipeline = 0;  // indices into the DrawTable the list is recorded with
+        uint32_t material = 0;
+        uint32_t mesh = 0;
+        uint32_t object = 0;    // per-object data index, read by the shader per instance
+        uint64_t key = 0;       // SortKey::opaque / translucent
+    };
+
+    // Consecutive sorted draws with equal pipeline, material and mesh become
+    // one instanced draw. Instance i of a batch draws object
+    // instanceObjects()[firstInstance + i]; the vertex shader finds it
+    // through gl_InstanceIndex.
+    struct DrawBatch {
+        uint32_t pipeline = 0;
+        uint32_t material = 0;
+        uint32_t mesh = 0;
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+    };
+
+    struct DrawCounters {
+        uint64_t draws = 0;
+        uint64_t pipelineBinds = 0;
+        uint64_t descriptorBinds = 0;  // material descriptor sets
+        uint64_t meshBinds = 0;        // vertex + index buffer pairs
+    };
+
+    struct DrawListStats {
+        DrawCounters submitted;  // one draw per item in submission order, binds skipped when equal
+        DrawCounters merged;     // after sorting and instancing
+        double sortMs = 0.0;
+        double buildMs = 0.0;    // sort + merge
+    };
+
+    // One frame's draws. Fill with add(), then build() sorts by key, merges
+    // compatible neighbours into instanced batches and counts the state
+    // changes recording will make (DrawRecorder skips the redundant binds).
+    class DrawList {
+    public:
+        void reserve(size_t count);
+        void clear();
+        uint32_t add(DrawItem const& item);
+        size_t size() const noexcept { return items_.size(); }
+
+        // With a pool, large lists sort in parallel.
+        void build(ThreadPool* pool = nullptr);
+
+        std::span<const DrawItem> items() const noexcept { return items_; }
+        std::span<const DrawBatch> batches() const noexcept { return batches_; }
+        std::span<const uint32_t> instanceObjects() const noexcept { return instanceObjects_; }
+        DrawListStats const& stats() const noexcept { return stats_; }
+
+    private:
+        std::vector<DrawItem> items_;
+        std::vector<uint64_t> keys_;
+        std::vector<uint32_t> order_;
+        std::vector<DrawBatch> batches_;
+        std::vector<uint32_t> instanceObjects_;
+        RadixSorter sorter_;
+        DrawListStats stats_{};
+    };
+
+} // namespace Core::Render
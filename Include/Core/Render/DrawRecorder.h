@@ -0,0 +1,46 @@
+#pragma once
+#include <Core/Render/DrawList.h>
+#include <cstdint>
+#include <span>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Render {
+
+    struct PipelineState {
+        vk::Pipeline pipeline{};
+        vk::PipelineLayout layout{};
+    };
+
+    struct MeshBinding {
+        vk::Buffer vertexBuffer{};
+        vk::DeviceSize vertexBufferOffset = 0;
+        vk::Buffer indexBuffer{};
+        vk::DeviceSize indexBufferOffset = 0;
+        vk::IndexType indexType = vk::IndexType::eUint32;
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+    };
+
+    // What DrawItem ids refer to. Materials are bound at `materialSet` of
+    // the current pipeline's layout; per-frame sets below it are the
+    // caller's and stay bound across compatible layouts.
+    struct DrawTable {
+        std::span<const PipelineState> pipelines;
+        std::span<const vk::DescriptorSet> materials;
+        std::span<const MeshBinding> meshes;
+        uint32_t materialSet = 1;
+    };
+
+    // Records a built DrawList into a graphics command buffer, one
+    // drawIndexed per batch, binding only what changed since the previous
+    // batch. Must be inside a render pass.
+    class DrawRecorder {
+    public:
+        // Returns what was actually recorded. A pipeline whose layout differs
+        // from the previous one also gets its material set rebound.
+        static DrawCounters record(vk::raii::CommandBuffer& cmd, DrawTable const& table,
+            DrawList const& list);
+    };
+
+} // namespace Core::Render
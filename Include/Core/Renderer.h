@@ -1,14 +1,25 @@
 #pragma once
+#include <Core/Debug/DebugMessageSink.h>
 #include <Core/Device.h>
+#include <Core/FramePacer.h>
+#include <Core/Memory/FrameAllocator.h>
+#include <Core/Memory/ReadbackManager.h>
+#include <Core/PresentLatency.h>
+#include <Core/Profiling/GpuProfiler.h>
+#include <Core/Render/CommandCache.h>
 #include <Core/Shaders/ShaderLoader.h>
 #include <Core/Swapchain.h>
+#include <Core/Utils/TaskGraph.h>
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <cstdint> // for uint32_t
 #include <vulkan/vk_platform.h>
 #include <vulkan/vulkan_raii.hpp>
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 const std::vector validationLayers = { "VK_LAYER_KHRONOS_validation" };
 
 #ifdef NDEBUG
@@ -18,12 +29,65 @@ constexpr bool enableValidationLayers = true;
 #endif
 
 namespace Core {
+    struct RendererOptions {
+        PresentStrategy presentStrategy = PresentStrategy::LowLatency;
+        // With present_wait: how many presents may be queued before the CPU
+        // starts the next frame. 1 keeps input-to-photon latency lowest.
+        uint32_t maxQueuedPresents = 1;
+        vk::DeviceSize frameAllocatorBytes = 4u << 20; // per frame in flight
+        PacingMode pacing = PacingMode::Capped;
+        double targetFps = 0.0; // 0: the primary monitor's refresh rate
+        // Chrome trace written on exit; needs CORE_ENABLE_PROFILER
+        std::string traceOutput = "trace.json";
+        // Validation output filtering and rate limiting (debug builds).
+        Debug::DebugMessageConfig debugMessages{};
+        // Print per-phase startup timings (--startup-report).
+        bool startupReport = false;
+        // Compiled into the blob cache while the device is being created.
+        // The cache lives in memory only: this hides compile time behind
+        // startup within one run, and every run compiles these again.
+        std::vector<Shaders::ShaderKey> warmupShaders;
+        // Shared with compute contexts on other devices (see
+        // Compute::DeviceGroup); null: the renderer's own cache.
+        std::shared_ptr<Shaders::ShaderBlobCache> shaderBlobs;
+        // Route Vulkan host allocations through Memory::HostAllocator and
+        // print per-tag usage on exit. Off: the driver's own allocator.
+        bool trackHostAllocations = true;
+    };
+
     class Renderer {
     public:
-        Renderer();           // <-- well define it to build everything
+        static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+        explicit Renderer(RendererOptions options = {});
         ~Renderer() = default;
         void run();
 
+        // Takes effect through a swapchain recreate, without a device wait.
+        void setPresentStrategy(PresentStrategy strategy);
+        void setPacing(PacingMode mode) { pacer_.setMode(mode); }
+        // Content changed outside of input handling (thread-safe).
+        void requestRedraw() { pacer_.requestRedraw(); }
+
+        const std::string& startupReport() const { return startupReport_; }
+
+        // Copy of the next rendered frame, converted on a readback worker.
+        // Main thread only. F12 writes one to screenshot-<n>.ppm.
+        std::future<Memory::ReadbackData> captureFrame(
+            Memory::ReadbackFormat format = Memory::ReadbackFormat::PPM);
+
+        // Main pass content that only changes with `key`: recorded once
+        // into a cached secondary command buffer and replayed every frame.
+        // The swapchain and shader reloads invalidate it on their own; watch
+        // other owners through commandCache(). Null records the pass inline.
+        // Main thread only.
+        using StaticPass = std::function<void(vk::raii::CommandBuffer&, vk::Extent2D)>;
+        void setStaticPass(StaticPass record, Render::CommandKey key = {});
+        Render::CommandCache& commandCache() { return *commandCache_; }
+
+        // Validation message counters; null without validation layers.
+        const Debug::DebugMessageSink* debugMessages() const { return debugSink_.get(); }
+
     private:
         void initVulkan();
         void initWindow();
@@ -31,36 +95,59 @@ namespace Core {
         void cleanup();
         void createSurface();
         void createInstance();
+        void createFrameResources();
 
-        std::vector<const char*> getRequiredExtensions();
+        void drawFrame();
+        void recordFrame(vk::raii::CommandBuffer& cmd, uint32_t imageIndex, uint64_t frame);
+        void recreateSwapchain();
+        void saveScreenshots();
 
-        void setupDebugMessenger();
+        static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
+        static void installInputCallbacks(GLFWwindow* window);
 
-        static VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(
-            vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
-            vk::DebugUtilsMessageTypeFlagsEXT type,
-            const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData, void*) {
-            if (severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eError ||
-                severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning) {
-                std::cerr << "validation layer: type " << to_string(type)
-                    << " msg: " << pCallbackData->pMessage << std::endl;
-            }
+        std::vector<const char*> getRequiredExtensions();
 
-            return vk::False;
-        }
+        void setupDebugMessenger();
 
         const uint32_t WIDTH = 800;
         const uint32_t HEIGHT = 600;
 
         GLFWwindow* window = nullptr;
 
+        // outlives the messenger that calls into it
+        std::unique_ptr<Debug::DebugMessageSink> debugSink_;
         vk::raii::Context context{};
         vk::raii::Instance instance{ nullptr };
         vk::raii::SurfaceKHR surface{nullptr};
         vk::raii::DebugUtilsMessengerEXT debugMessenger{ nullptr };
 
-        //std::optional < Shaders::ShaderLoader> shaderLoader;
         Device device;
+        std::optional<Shaders::ShaderLoader> shaderLoader;
         std::optional<Swapchain> swapchain;
+
+        RendererOptions options_;
+
+        // frame N signals frameTimeline_ to N; slot N % MAX_FRAMES_IN_FLIGHT
+        vk::raii::Semaphore frameTimeline_ = nullptr;
+        uint64_t frameNumber_ = 0;
+        vk::raii::CommandPool commandPool_ = nullptr;
+        std::vector<vk::raii::CommandBuffer> commandBuffers_;
+        std::vector<vk::raii::Semaphore> imageAvailable_;  // per frame slot
+        std::optional<Memory::FrameAllocator> frameAllocator_;
+        std::optional<Profiling::GpuProfiler> gpuProfiler_; // profiler builds only
+        std::optional<Memory::ReadbackManager> readback_;
+        std::optional<Render::CommandCache> commandCache_;
+        StaticPass staticPass_;
+        Render::CommandKey staticPassKey_;
+        // recorded into the next frame's command buffer
+        std::vector<std::pair<Memory::ReadbackFormat, std::promise<Memory::ReadbackData>>> captures_;
+        std::vector<std::future<Memory::ReadbackData>> screenshots_;
+        bool screenshotRequested_ = false;
+        uint32_t screenshotCount_ = 0;
+
+        bool framebufferResized_ = false;
+        PresentLatency latency_;
+        FramePacer pacer_;
+        std::string startupReport_;
     };
 } // namespace Core
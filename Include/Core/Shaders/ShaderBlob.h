@@ -7,12 +7,24 @@
 
 namespace Core::Shaders {
 
-// Fill this with what your reflection step produces
+// Kept free of Vulkan types so blobs stay device-agnostic.
+enum class DescriptorKind : uint8_t {
+    UniformBuffer, StorageBuffer, StorageImage, SampledImage, Sampler, CombinedImageSampler,
+    UniformTexelBuffer, StorageTexelBuffer
+};
+
+// Filled by reflect() (ShaderReflection.h) when the blob is compiled.
 struct ReflectionInfo {
-    // Example:
-    // struct DescriptorBinding { uint32_t set, binding; /* type, count, stages... */ };
-    // std::vector<DescriptorBinding> bindings;
-    // uint32_t pushConstantSize = 0;
+    struct DescriptorBinding {
+        uint32_t set = 0, binding = 0;
+        DescriptorKind kind{};
+        uint32_t count = 1;        // array size; 0 for runtime arrays
+        bool readOnly = false;     // NonWritable on every member (storage buffers)
+        std::string name;          // empty once debug info is stripped
+    };
+    std::vector<DescriptorBinding> bindings; // sorted by (set, binding)
+    uint32_t pushConstantSize = 0;
+    uint32_t localSize[3] = { 1, 1, 1 };    // compute only
 };
 
 struct ShaderBlob {
@@ -0,0 +1,35 @@
+#pragma once
+#include <Core/Shaders/ShaderBlob.h>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Core::Shaders {
+
+    // contentHash -> blob, shareable between the ShaderLoaders of several
+    // devices: SPIR-V is device-agnostic, so a shader compiles once per
+    // process and only its modules are per device. Thread-safe; a blob that
+    // another loader is compiling is waited for, not compiled again.
+    class ShaderBlobCache {
+    public:
+        using Compile = std::function<std::shared_ptr<ShaderBlob>()>;
+
+        // The cached blob, or `compile()`'s result stored under contentHash.
+        // `compiled` says which. A failed compile is not cached: its
+        // exception reaches every caller that waited for it.
+        std::shared_ptr<ShaderBlob> findOrCompile(uint64_t contentHash, Compile const& compile,
+            bool& compiled);
+        // Null when missing or still compiling.
+        std::shared_ptr<ShaderBlob> find(uint64_t contentHash) const;
+
+        size_t size() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::unordered_map<uint64_t, std::shared_future<std::shared_ptr<ShaderBlob>>> blobs_;
+    };
+
+} // namespace Core::Shaders
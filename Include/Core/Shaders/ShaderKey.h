@@ -16,6 +16,7 @@ struct ShaderKey {
     Stage       stage{};           // your own stage enum (map to Vk later)
     std::string entry;             // e.g. "main"
     uint64_t    optionsHash = 0;   // computed internally
+    std::vector<std::string> defines; // sorted "NAME" / "NAME=VALUE"; empty for prehashed keys
 
     // 1) If you already have a precomputed hash
     ShaderKey(std::string path, Stage st, std::string entryName, uint64_t prehashed)
@@ -25,17 +26,29 @@ struct ShaderKey {
     ShaderKey(std::string path, Stage  st, std::string entryName,
               std::initializer_list<std::string_view> defines)
       : canonicalPath(std::move(path)), stage(st), entry(std::move(entryName)),
-        optionsHash(makeOptionsHash(defines)) {}
+        optionsHash(makeOptionsHash(defines)), defines(sorted(defines)) {}
 
     // 3) Vector overload if you build the list elsewhere
     ShaderKey(std::string path, Stage  st, std::string entryName,
               const std::vector<std::string>& defines)
       : canonicalPath(std::move(path)), stage(st), entry(std::move(entryName)),
-        optionsHash(makeOptionsHash(defines)) {}
+        optionsHash(makeOptionsHash(defines)), defines(sorted(defines)) {}
 
     bool operator==(const ShaderKey&) const = default;
 
 private:
+    static std::vector<std::string> sorted(std::initializer_list<std::string_view> defines) {
+        std::vector<std::string> out(defines.begin(), defines.end());
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    static std::vector<std::string> sorted(const std::vector<std::string>& defines) {
+        std::vector<std::string> out(defines);
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
     // Deterministic hashing: sort to ignore define order; join with '\n'
     static uint64_t makeOptionsHash(std::initializer_list<std::string_view> defines) {
         std::vector<std::string_view> tmp(defines.begin(), defines.end());
@@ -1,22 +1,68 @@
 #pragma once
 #include <Core/Device.h>
 #include <Core/Shaders/ShaderBlob.h>
+#include <Core/Shaders/ShaderBlobCache.h>
 #include <Core/Shaders/ShaderHandle.h>
 #include <Core/Shaders/ShaderKey.h>
+#include <chrono>
+#include <memory>
 #include <unordered_map>
 
 namespace Core::Shaders {
+    // Cumulative wall time per loader stage. Live-handle hits are not timed:
+    // a clock read would cost as much as the lookup.
+    struct ShaderStageTimes {
+        uint64_t readNs = 0;
+        uint64_t preprocessNs = 0;   // GlslangPreprocess, includes resolved
+        uint64_t hashNs = 0;         // content hash of the preprocessed text
+        uint64_t compileNs = 0;      // GlslangCompileToSpv
+        uint64_t reflectNs = 0;
+        uint64_t moduleNs = 0;       // vkCreateShaderModule
+    };
+
+    // Where get()/prewarm() requests were satisfied, cumulative.
+    struct ShaderCacheStats {
+        uint64_t handleHits = 0;     // get() served from the live handle table
+        uint64_t blobHits = 0;       // preprocessed source matched a cached blob
+        uint64_t compiles = 0;       // blob misses: compiled to SPIR-V
+        uint64_t moduleHits = 0;
+        uint64_t modulesCreated = 0;
+        ShaderStageTimes times;
+    };
+
+    // Per-device: modules and live handles belong to one Device. Blobs come
+    // from a ShaderBlobCache that loaders of other devices may share.
     class ShaderLoader {
     public:
-        explicit ShaderLoader(Device &device) : device_(device) {}
+        explicit ShaderLoader(Device &device, std::shared_ptr<ShaderBlobCache> blobs = nullptr)
+            : device_(device),
+              blobCache_(blobs ? std::move(blobs) : std::make_shared<ShaderBlobCache>()) {}
         ShaderHandle get(const ShaderKey& key);
-        void pollAndReload(); // (optional; not shown here)
+        // Compiles into the blob cache without touching the device, so it can
+        // run while the device is still being created. Not thread-safe with
+        // respect to this loader; loaders sharing a blob cache may run
+        // concurrently.
+        void prewarm(const ShaderKey& key);
+        // Drops live handles whose source or includes changed on disk since
+        // they were compiled and bumps generation(); the next get() of those
+        // keys recompiles. Handles already handed out keep the old module.
+        // Returns whether anything changed.
+        bool pollAndReload();
+        // Changes whenever pollAndReload() found edits: anything built from
+        // handles (pipelines, cached command buffers) should be rebuilt.
+        uint64_t generation() const noexcept { return generation_; }
+
+        const std::shared_ptr<ShaderBlobCache>& blobCache() const noexcept { return blobCache_; }
+        const ShaderCacheStats& stats() const noexcept { return stats_; }
+        void resetStats() noexcept { stats_ = {}; }
 
     private:
+        std::shared_ptr<ShaderBlob> loadBlob(const ShaderKey& key);
+
         Device& device_;
 
-        // contentHash -> blob (device-agnostic)
-        std::unordered_map<uint64_t, std::shared_ptr<ShaderBlob>> blobCache_;
+        // contentHash -> blob (device-agnostic, possibly shared)
+        std::shared_ptr<ShaderBlobCache> blobCache_;
 
         // (blobHash, device) -> module (device-specific)
         std::unordered_map<uint64_t, std::shared_ptr<ShaderModule>> moduleCache_;
@@ -24,5 +70,11 @@ namespace Core::Shaders {
         // ShaderKey -> ShaderHandle
         std::unordered_map<ShaderKey, ShaderHandle, ShaderKeyHasher> liveHandles_;
 
+        ShaderCacheStats stats_;
+        uint64_t generation_ = 0;
+        // contentHash -> newest source time pollAndReload() has seen; kept
+        // here because blobs may be shared with other loaders
+        std::unordered_map<uint64_t, std::chrono::file_clock::time_point> reloadStamps_;
+
     };
 }
@@ -1,6 +1,8 @@
 // Core/Shaders/ShaderModule.hpp
 #pragma once
 #include <Core/Device.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Shaders/ShaderBlob.h>
 #include <cstdint>
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_raii.hpp>
@@ -9,12 +11,14 @@ namespace Core::Shaders {
     struct ShaderModule {
         vk::raii::ShaderModule module = nullptr; // owns/destroys VkShaderModule
         uint64_t blobHash = 0;
+        ReflectionInfo reflect;                  // copied from the blob; drives pipeline layouts
 
         ShaderModule() = default;
 
         ShaderModule(Core::Device const& dev, vk::ShaderModuleCreateInfo const& ci,
-            uint64_t hash)
-            : module{ dev.vkDevice(), ci }, blobHash{ hash } {
+            uint64_t hash, ReflectionInfo reflection = {})
+            : module{ dev.vkDevice(), ci, Memory::hostCallbacks(Memory::HostTag::Shader) },
+              blobHash{ hash }, reflect{ std::move(reflection) } {
         }
 
         // convenience when you need the raw VkShaderModule
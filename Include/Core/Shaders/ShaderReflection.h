@@ -0,0 +1,12 @@
+#pragma once
+#include <Core/Shaders/ShaderBlob.h>
+#include <cstdint>
+#include <span>
+
+namespace Core::Shaders {
+
+    // Minimal SPIR-V walk: descriptor bindings, push constant block size and
+    // the compute local size. Throws std::runtime_error on malformed input.
+    ReflectionInfo reflect(std::span<const uint32_t> spirv);
+
+} // namespace Core::Shaders
@@ -5,17 +5,64 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <vulkan/vulkan_structs.hpp>
 namespace Core {
+    // How the swapchain trades latency against power / tearing.
+    enum class PresentStrategy : uint8_t {
+        LowLatency,   // MAILBOX, then IMMEDIATE, then FIFO
+        PowerSaving,  // FIFO: strict vsync, the GPU idles between frames
+        FifoRelaxed,  // FIFO_RELAXED: vsync, but late frames tear instead of stalling
+    };
+
+    enum class SwapchainStatus : uint8_t { Ok, Suboptimal, OutOfDate };
+
     class Swapchain {
     public:
         Swapchain(const Swapchain&) = delete;
         Swapchain& operator=(const Swapchain&) = delete;
 
         Swapchain(Swapchain&&) noexcept = default;      // ok
-        Swapchain& operator=(Swapchain&&) = delete;
-        Swapchain(Device& device, vk::raii::SurfaceKHR& surface, GLFWwindow& window);
+        Swapchain& operator=(Swapchain&&) noexcept = default;
+        Swapchain(Device& device, vk::raii::SurfaceKHR& surface, GLFWwindow& window,
+            PresentStrategy strategy = PresentStrategy::LowLatency);
+
+        // Rebuilds against the current surface size, handing the old swapchain
+        // over through oldSwapchain. No device-wide wait: the old swapchain and
+        // its views are kept until the frame timeline passes `retireValue`
+        // (the last frame submitted against it), see collectRetired().
+        void recreate(uint64_t retireValue);
+        void setPresentStrategy(PresentStrategy strategy, uint64_t retireValue);
+        void collectRetired(uint64_t completedValue);
+
+        SwapchainStatus acquire(vk::Semaphore signal, uint32_t& imageIndex);
+        // Tags the present with a present id when VK_KHR_present_id is enabled.
+        SwapchainStatus present(uint32_t imageIndex, vk::Semaphore wait);
+
+        // VK_KHR_present_wait; false on timeout or when unsupported.
+        bool waitForPresent(uint64_t presentId, uint64_t timeoutNs) const;
+        bool presentWaitEnabled() const noexcept { return device_->presentWaitEnabled(); }
+        uint64_t lastPresentId() const noexcept { return presentId_; }
+
+        vk::Format format() const noexcept { return swapChainSurfaceFormat.format; }
+        vk::Extent2D extent() const noexcept { return swapChainExtent; }
+        vk::PresentModeKHR presentMode() const noexcept { return presentMode_; }
+        PresentStrategy presentStrategy() const noexcept { return strategy_; }
+        const std::vector<vk::Image>& images() const noexcept { return swapChainImages; }
+        const std::vector<vk::raii::ImageView>& imageViews() const noexcept {
+            return swapChainImageViews;
+        }
+        // Binary semaphore the present of `imageIndex` waits on. Per image, so
+        // it's never re-signaled while a present might still wait on it.
+        vk::Semaphore presentSemaphore(uint32_t imageIndex) const noexcept {
+            return *presentSemaphores_[imageIndex];
+        }
+        // Bumped on every recreate; lets dependants notice stale state.
+        uint64_t generation() const noexcept { return generation_; }
+        // Images can be copied from (screenshots, golden-image readback).
+        bool readable() const noexcept {
+            return !!(imageUsage_ & vk::ImageUsageFlagBits::eTransferSrc);
+        }
 
     private:
-        void createSwapchain();
+        void createSwapchain(vk::SwapchainKHR oldSwapchain = {});
         void createImageViews();
 
         static uint32_t chooseSwapMinImageCount(
@@ -40,27 +87,54 @@ namespace Core {
         }
 
         static vk::PresentModeKHR chooseSwapPresentMode(
-            const std::vector<vk::PresentModeKHR>& availablePresentModes) {
+            const std::vector<vk::PresentModeKHR>& availablePresentModes,
+            PresentStrategy strategy) {
             assert(std::ranges::any_of(availablePresentModes, [] (auto presentMode) {
                 return presentMode == vk::PresentModeKHR::eFifo;
             }));
-            return std::ranges::any_of(availablePresentModes,
-                [] (const vk::PresentModeKHR value) {
-                return vk::PresentModeKHR::eMailbox == value;
-            })
-                ? vk::PresentModeKHR::eMailbox
-                : vk::PresentModeKHR::eFifo;
+            const auto has = [&] (vk::PresentModeKHR mode) {
+                return std::ranges::find(availablePresentModes, mode) !=
+                    availablePresentModes.end();
+            };
+            switch (strategy) {
+                case PresentStrategy::LowLatency:
+                    if (has(vk::PresentModeKHR::eMailbox)) return vk::PresentModeKHR::eMailbox;
+                    if (has(vk::PresentModeKHR::eImmediate)) return vk::PresentModeKHR::eImmediate;
+                    break;
+                case PresentStrategy::FifoRelaxed:
+                    if (has(vk::PresentModeKHR::eFifoRelaxed)) return vk::PresentModeKHR::eFifoRelaxed;
+                    break;
+                case PresentStrategy::PowerSaving:
+                    break;
+            }
+            return vk::PresentModeKHR::eFifo;
         }
 
         vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities);
 
-        GLFWwindow& window_;
-        Device& device_;
-        vk::raii::SurfaceKHR& surface_;
+        // pointers rather than references so the swapchain stays move-assignable
+        GLFWwindow* window_;
+        Device* device_;
+        vk::raii::SurfaceKHR* surface_;
+        PresentStrategy strategy_;
+        vk::PresentModeKHR presentMode_ = vk::PresentModeKHR::eFifo;
         vk::raii::SwapchainKHR swapChain = nullptr;
         std::vector<vk::Image> swapChainImages;
         vk::SurfaceFormatKHR swapChainSurfaceFormat;
         vk::Extent2D swapChainExtent;
+        vk::ImageUsageFlags imageUsage_{};
         std::vector<vk::raii::ImageView> swapChainImageViews;
+        std::vector<vk::raii::Semaphore> presentSemaphores_;
+        uint64_t presentId_ = 0;
+        uint64_t firstPresentId_ = 1; // ids below this went to a retired swapchain
+        uint64_t generation_ = 0;
+
+        struct Retired {
+            vk::raii::SwapchainKHR swapChain;
+            std::vector<vk::raii::ImageView> imageViews;
+            std::vector<vk::raii::Semaphore> presentSemaphores;
+            uint64_t retireValue;
+        };
+        std::vector<Retired> retired_;
     };
 }
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Binary texture container (.ctex). Little-endian, versioned, with the whole
+// mip chain pre-filtered so a streamer can read any level straight out of a
+// memory mapping:
+//
+//   TextureHeader (64 B)
+//   TextureMip[mipCount]      at mipOffset, largest level first
+//   level texels              each at its TextureMip::offset, kTexelAlignment
+//                             aligned, rows tightly packed
+namespace Core::Texture {
+
+    constexpr uint32_t kTextureMagic = 0x58455443; // "CTEX"
+    constexpr uint32_t kTextureVersion = 1;
+    constexpr uint64_t kTexelAlignment = 256;      // >= optimalBufferCopyOffsetAlignment
+
+    enum class TexelFormat : uint32_t {
+        RGBA8Unorm = 1,
+        RGBA8Srgb = 2,
+        R8Unorm = 3,
+    };
+    uint32_t bytesPerTexel(TexelFormat format);
+
+    struct TextureHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        TexelFormat format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipCount;
+        uint32_t reserved0;
+        uint64_t mipOffset;     // TextureMip table
+        uint64_t reserved1[3];
+    };
+    static_assert(sizeof(TextureHeader) == 64);
+
+    struct TextureMip {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+    static_assert(sizeof(TextureMip) == 24);
+
+    // Validated view into a texture file; every span points into the input.
+    struct TextureView {
+        const TextureHeader* header = nullptr;
+        std::span<const TextureMip> mips;
+        std::span<const std::byte> base; // the whole file
+
+        std::span<const std::byte> level(uint32_t mip) const {
+            return base.subspan(mips[mip].offset, mips[mip].bytes);
+        }
+    };
+
+    // Checks magic, version and that every level lies inside `bytes` with
+    // the size its extent implies. `bytes` must be 8-byte aligned (mappings
+    // are). Throws std::runtime_error.
+    TextureView parseTexture(std::span<const std::byte> bytes);
+
+    // Level 0 as decoded from an image; writeTexture() filters the rest.
+    struct TextureData {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        TexelFormat format = TexelFormat::RGBA8Unorm;
+        std::vector<std::byte> texels;
+    };
+
+    // Next level down: 2x2 box filter, odd edges folded into the last
+    // texel; sRGB data is averaged in linear space.
+    TextureData downsample(TextureData const& level);
+
+    // Writes the full mip chain down to 1x1.
+    void writeTexture(const std::string& path, TextureData const& level0);
+
+} // namespace Core::Texture
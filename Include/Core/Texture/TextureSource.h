@@ -0,0 +1,53 @@
+#pragma once
+#include <Core/Texture/TextureFormat.h>
+#include <Core/Utils/MappedFile.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Core::Texture {
+
+    struct TextureInfo {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipCount = 0;
+        TexelFormat format = TexelFormat::RGBA8Unorm;
+
+        uint32_t mipWidth(uint32_t mip) const noexcept { return std::max(1u, width >> mip); }
+        uint32_t mipHeight(uint32_t mip) const noexcept { return std::max(1u, height >> mip); }
+        uint64_t mipBytes(uint32_t mip) const {
+            return uint64_t(mipWidth(mip)) * mipHeight(mip) * bytesPerTexel(format);
+        }
+    };
+
+    // Where a streamed texture's levels come from. decodeMip() runs on the
+    // streamer's worker threads, possibly for several levels of the same
+    // source at once, so implementations must be thread-safe. Decoders and
+    // transcoders (compressed files, procedural content) plug in here.
+    class TextureSource {
+    public:
+        virtual ~TextureSource() = default;
+        virtual TextureInfo info() const = 0;
+        // Writes level `mip`, rows tightly packed, into `out`
+        // (info().mipBytes(mip) bytes). Throws on failure.
+        virtual void decodeMip(uint32_t mip, std::span<std::byte> out) const = 0;
+    };
+
+    // A memory-mapped .ctex file; decoding is a copy out of the mapping, so
+    // only the levels actually streamed are ever paged in.
+    class TextureFile final : public TextureSource {
+    public:
+        explicit TextureFile(const std::string& path);
+
+        TextureInfo info() const override { return info_; }
+        void decodeMip(uint32_t mip, std::span<std::byte> out) const override;
+
+    private:
+        MappedFile file_;
+        TextureView view_;
+        TextureInfo info_;
+    };
+
+} // namespace Core::Texture
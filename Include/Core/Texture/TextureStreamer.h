@@ -0,0 +1,196 @@
+#pragma once
+#include <Core/Device.h>
+#include <Core/Memory/Buffer.h>
+#include <Core/Memory/Image.h>
+#include <Core/Texture/TextureSource.h>
+#include <Core/Utils/ThreadPool.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Core::Texture {
+
+    using TextureId = uint32_t;
+
+    struct TextureStreamerOptions {
+        vk::DeviceSize budgetBytes = 256u << 20;   // device memory for all streamed images
+        uint32_t tailSize = 64;                    // levels no larger than this are always resident
+        vk::DeviceSize stagingBytesPerFrame = 16u << 20; // upload bandwidth per frame
+        uint32_t framesInFlight = 2;
+        uint32_t maxDecodesInFlight = 8;
+        // where the textures are sampled, for the barrier after each upload
+        vk::PipelineStageFlags2 consumerStages = vk::PipelineStageFlagBits2::eFragmentShader;
+    };
+
+    struct TextureStreamerStats {
+        uint32_t textures = 0;
+        vk::DeviceSize residentBytes = 0;
+        vk::DeviceSize peakResidentBytes = 0;
+        vk::DeviceSize budgetBytes = 0;
+        uint32_t decodesInFlight = 0;
+        uint32_t uploadsWaiting = 0;        // decoded, waiting for staging space
+        uint64_t uploads = 0;               // residency increases
+        uint64_t uploadedBytes = 0;
+        uint64_t evictions = 0;             // textures dropped back to their tail
+        // Residency: a texture is stalled in a frame when it was requested at
+        // a finer level than the one it has.
+        uint32_t requestedThisFrame = 0;
+        uint32_t stalledThisFrame = 0;
+        uint64_t stalledTextureFrames = 0;  // summed over all frames
+        uint64_t budgetMisses = 0;          // uploads dropped: nothing evictable left
+        uint64_t decodeFailures = 0;        // retried with a growing backoff
+        uint32_t mipBias = 0;               // levels every request is coarsened by
+        // request of a level until it is resident
+        double averageLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+    };
+
+    // Streams texture levels by demand under a device memory budget.
+    //
+    // add() makes a texture resident down to its mip tail (levels no larger
+    // than tailSize) right away; finer levels follow requests. Requests come
+    // from request() or from the GPU feedback buffer, where shaders
+    // atomicMin the level they would like to sample, in full-resolution
+    // mip numbers, at the texture's id. Worker threads decode the missing
+    // levels; update() copies them into per-frame staging memory and swaps
+    // in a new image holding levels [residentMip, mipCount), copying the
+    // levels it already had on the GPU. When the budget is exceeded the least
+    // recently requested textures drop back to their tail; when the textures
+    // in use alone don't fit, every request is coarsened by a global mip bias
+    // that relaxes again once there is headroom.
+    //
+    // Images are re-created when residency changes, so views change too:
+    // rewrite descriptors when generation() moves. An image's level 0 is
+    // residentMip() of the full texture; normalized coordinates need no
+    // adjustment. Main thread only, apart from the decode workers.
+    class TextureStreamer {
+    public:
+        TextureStreamer(Device& device, TextureStreamerOptions options = {},
+            ThreadPool* pool = nullptr);
+        // Waits for outstanding decodes. The GPU must be done with the images.
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        TextureId add(std::shared_ptr<const TextureSource> source);
+        // The image is released once the current frame has retired.
+        void remove(TextureId id);
+
+        // Finest level wanted this frame (0 = full resolution).
+        void request(TextureId id, uint32_t mip);
+
+        // Same contract as FrameAllocator::beginFrame(): frame N signals
+        // `timeline` to N, counting from 1; waits only if the slot's previous
+        // frame is still in flight. Reads back the feedback that frame wrote.
+        void beginFrame(uint64_t frameNumber, vk::raii::Semaphore const& timeline);
+        // Starts decodes, records the uploads that fit this frame's staging
+        // and evicts down to the budget. Outside a render pass.
+        void update(vk::raii::CommandBuffer& cmd);
+        // Makes this frame's feedback writes visible to the host read in the
+        // slot's next beginFrame(). Record after the last pass that writes
+        // feedback, outside a render pass; the timeline wait alone doesn't.
+        void finishFrame(vk::raii::CommandBuffer& cmd);
+
+        // One uint32 per texture id for this frame's shaders, written with
+        // atomicMin in consumerStages; reset to UINT32_MAX at beginFrame().
+        vk::Buffer feedbackBuffer() const noexcept { return feedback_[slot_].handle(); }
+
+        // Null until the tail has been uploaded.
+        vk::ImageView view(TextureId id) const {
+            Entry const& e = entries_.at(id);
+            return e.image.empty() ? vk::ImageView{} : e.image.view();
+        }
+        uint32_t residentMip(TextureId id) const { return entries_.at(id).residentMip; }
+        TextureInfo const& info(TextureId id) const { return entries_.at(id).info; }
+        uint64_t generation() const noexcept { return generation_; }
+
+        TextureStreamerStats stats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            std::shared_ptr<const TextureSource> source;
+            TextureInfo info;
+            Memory::Image image;        // levels [residentMip, mipCount)
+            uint32_t tailMip = 0;       // first level of the tail
+            uint32_t residentMip = 0;   // == mipCount before the tail is in
+            uint32_t wantedMip = 0;     // finest level asked for, sticky until evicted
+            uint32_t frameRequest = UINT32_MAX; // this frame's request, before the bias
+            uint64_t lastRequested = 0; // frame number, for LRU
+            uint32_t serial = 0;        // tells a reused id's decodes apart
+            uint32_t failures = 0;      // decodes failed in a row
+            uint64_t retryFrame = 0;    // no decode starts before this frame
+            bool decoding = false;
+            bool alive = false;
+            Clock::time_point requestedAt{}; // unset unless waiting for a level
+        };
+
+        // Levels [firstMip, endMip) of one texture, decoded by a worker.
+        struct Decoded {
+            TextureId id;
+            uint32_t serial;
+            uint32_t firstMip, endMip;
+            std::vector<std::byte> texels;  // levels back to back
+            std::vector<uint64_t> offsets;  // per level into texels
+            bool failed = false;
+        };
+
+        // shared with the decode jobs
+        struct Completion {
+            std::mutex mutex;
+            std::condition_variable idle;
+            std::vector<std::unique_ptr<Decoded>> ready;
+            uint32_t inFlight = 0;
+        };
+
+        struct Retired {
+            Memory::Image image;
+            Memory::Buffer buffer;
+            uint64_t frame;             // last frame that could use it
+        };
+
+        static std::unique_ptr<Decoded> decode(TextureSource const& source, TextureInfo const& info,
+            TextureId id, uint32_t serial, uint32_t firstMip, uint32_t endMip);
+
+        void readFeedback();
+        void applyRequests();
+        void upload(vk::raii::CommandBuffer& cmd);
+        void startDecodes();
+        bool makeRoom(vk::raii::CommandBuffer& cmd, vk::DeviceSize bytes, TextureId keep);
+        void resize(vk::raii::CommandBuffer& cmd, TextureId id, uint32_t newResident,
+            Decoded const* decoded, vk::DeviceSize stagingOffset);
+        void growFeedback(size_t count);
+        void retire(Memory::Image image, Memory::Buffer buffer = {});
+
+        Device* device_;
+        TextureStreamerOptions options_;
+        ThreadPool* pool_;
+        std::shared_ptr<Completion> completion_;
+        std::vector<std::unique_ptr<Decoded>> waiting_; // decoded, not uploaded yet
+
+        std::vector<Entry> entries_;
+        std::vector<TextureId> freeIds_;
+        std::vector<Memory::Buffer> feedback_;   // per frame slot
+        std::vector<Memory::Buffer> staging_;    // per frame slot
+        size_t feedbackCapacity_ = 0;
+        std::vector<Retired> retired_;
+
+        std::vector<uint64_t> slotFrame_;        // frame that last used each slot, 0 = none
+        uint64_t frame_ = 0;
+        uint32_t slot_ = 0;
+        uint32_t bias_ = 0;
+        uint32_t calmFrames_ = 0;               // frames with headroom, to relax bias_
+        uint64_t generation_ = 0;
+        vk::DeviceSize residentBytes_ = 0;
+        TextureStreamerStats stats_{};
+        double latencySumMs_ = 0.0;
+        uint64_t latencyCount_ = 0;
+    };
+
+} // namespace Core::Texture
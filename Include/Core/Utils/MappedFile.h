@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Core {
+
+    // Read-only memory mapping of a whole file (MapViewOfFile / mmap). The
+    // view stays valid until the object is destroyed or moved from.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        // Throws std::runtime_error if the file can't be opened or mapped.
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::span<const std::byte> bytes() const noexcept { return { data_, size_ }; }
+        const std::byte* data() const noexcept { return data_; }
+        size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // Sequential-access hint so the OS reads ahead; best effort.
+        void adviseSequential() const noexcept;
+
+    private:
+        void close() noexcept;
+
+        const std::byte* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void* file_ = nullptr;     // HANDLE
+        void* mapping_ = nullptr;  // HANDLE
+#else
+        int fd_ = -1;
+#endif
+    };
+
+} // namespace Core
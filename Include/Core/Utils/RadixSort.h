@@ -0,0 +1,32 @@
+#pragma once
+#include <Core/Utils/ThreadPool.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core {
+
+    // LSD radix sort of 64-bit keys carrying a 32-bit payload, one byte per
+    // pass. Passes over bytes that are equal in every key are skipped, so
+    // keys using only their upper bits cost what their used bits cost. With
+    // a pool, large inputs are split into chunks that build histograms and
+    // scatter in parallel. Stable. Scratch memory is kept between calls, so
+    // a per-frame sort stops allocating once it has seen its peak size.
+    class RadixSorter {
+    public:
+        // Sorts `keys` ascending and permutes `values` with them; both spans
+        // must have the same size.
+        void sort(std::span<uint64_t> keys, std::span<uint32_t> values,
+            ThreadPool* pool = nullptr);
+
+        // Below this many keys the sort stays on the calling thread.
+        static constexpr size_t kParallelThreshold = 32 * 1024;
+
+    private:
+        std::vector<uint64_t> keyScratch_;
+        std::vector<uint32_t> valueScratch_;
+        std::vector<size_t> histograms_; // 256 per chunk
+    };
+
+} // namespace Core
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shared by the benchmarks and tools that print or write timing reports, so
+// their numbers agree.
+namespace Core::Report {
+
+    // Nearest-rank percentile, p in [0, 1]: 0 is the minimum, 1 the maximum.
+    // 0 for no values.
+    double percentile(std::vector<double> values, double p);
+
+    // `s` as a quoted JSON string; quotes, backslashes and control
+    // characters are escaped. Other bytes pass through.
+    std::string jsonString(std::string_view s);
+    // %.6g; JSON has no NaN or infinity, so those come out as null.
+    std::string jsonNumber(double value);
+
+} // namespace Core::Report
@@ -0,0 +1,40 @@
+#pragma once
+
+// Compile-time SIMD selection. Kernels pick the widest path the translation
+// unit is built for and keep a scalar version alongside, which benchmarks
+// and tests use as the reference.
+//
+//   CORE_SIMD_AVX2  x86 with -mavx2 (or /arch:AVX2)
+//   CORE_SIMD_SSE2  any x86-64 (baseline)
+//   CORE_SIMD_NEON  AArch64
+#if defined(__AVX2__)
+#define CORE_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CORE_SIMD_SSE2 1
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CORE_SIMD_NEON 1
+#endif
+
+#if CORE_SIMD_AVX2 || CORE_SIMD_SSE2
+#include <immintrin.h>
+#elif CORE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Core::Simd {
+
+    // Name of the path compiled in, for benchmark output.
+    constexpr const char* kPathName =
+#if CORE_SIMD_AVX2
+        "avx2";
+#elif CORE_SIMD_SSE2
+        "sse2";
+#elif CORE_SIMD_NEON
+        "neon";
+#else
+        "scalar";
+#endif
+
+} // namespace Core::Simd
@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+    // Small one-shot dependency graph. Worker tasks get their own thread as
+    // soon as their dependencies are done; main-thread tasks (GLFW window
+    // calls) run on the thread that calls run(). Every task is timed.
+    class TaskGraph {
+    public:
+        using TaskId = uint32_t;
+        enum class Affinity : uint8_t { Worker, MainThread };
+
+        // `name` must be a string literal (it also names the profiler zone).
+        TaskId add(const char* name, std::function<void()> fn,
+            std::vector<TaskId> dependencies = {}, Affinity affinity = Affinity::Worker);
+
+        // Runs everything; rethrows the first exception once all tasks that
+        // had already started are done. Tasks depending on a failed one never run.
+        void run();
+
+        struct Timing {
+            const char* name;
+            double startMs;
+            double endMs;
+            Affinity affinity;
+        };
+        const std::vector<Timing>& timings() const noexcept { return timings_; }
+        double wallMs() const noexcept { return wallMs_; }
+        // Human readable per-task table plus total vs. serial time.
+        std::string report() const;
+
+    private:
+        struct Task {
+            const char* name;
+            std::function<void()> fn;
+            std::vector<TaskId> dependencies;
+            std::vector<TaskId> dependents;
+            Affinity affinity;
+            uint32_t pending = 0;
+        };
+        std::vector<Task> tasks_;
+        std::vector<Timing> timings_;
+        double wallMs_ = 0;
+    };
+
+} // namespace Core
@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+
+    // Persistent workers for per-frame data-parallel loops (culling, sorting)
+    // and background jobs (decode). Unlike TaskGraph, which is one-shot,
+    // threads are created once and reused.
+    class ThreadPool {
+    public:
+        // 0: one worker per hardware thread, minus the caller.
+        explicit ThreadPool(uint32_t workers = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        uint32_t workerCount() const noexcept { return static_cast<uint32_t>(threads_.size()); }
+        // Workers plus the calling thread.
+        uint32_t concurrency() const noexcept { return workerCount() + 1; }
+
+        // Calls fn(begin, end) for consecutive chunks of at most `grain`
+        // items covering [0, count). The caller takes chunks too and returns
+        // once all are done; the first exception is rethrown. Chunks are
+        // handed out dynamically, so uneven work balances itself.
+        void parallelFor(size_t count, size_t grain,
+            std::function<void(size_t begin, size_t end)> const& fn);
+
+        // Fire and forget; runs on a worker in FIFO order, or before
+        // returning when the pool has no workers (a single-CPU machine).
+        void submit(std::function<void()> job);
+
+        // Process-wide pool, created on first use.
+        static ThreadPool& shared();
+
+    private:
+        void work();
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::function<void()>> jobs_;
+        bool stop_ = false;
+        std::vector<std::thread> threads_;
+    };
+
+} // namespace Core
@@ -1,14 +1,21 @@
 #include <Core/Renderer.h>
 #include <glslang/Public/ShaderLang.h>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 void InitGlslang() { glslang::InitializeProcess(); }
 void ShutdownGlslang() { glslang::FinalizeProcess(); }
 
-int main() {
+int main(int argc, char** argv) {
+    Core::RendererOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--startup-report") == 0)
+            options.startupReport = true;
+    }
+
     InitGlslang();
-    Core::Renderer r;
+    Core::Renderer r(options);
 
     try {
         r.run();
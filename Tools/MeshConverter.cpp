@@ -0,0 +1,63 @@
+// Offline converter: OBJ / STL / PLY to the engine's .cmesh container.
+//
+//   MeshConverter [--quantize] [--meshlets] input.{obj,stl,ply} output.cmesh
+//
+// --quantize  16-byte QuantizedVertex stream instead of 32-byte Vertex
+// --meshlets  meshlets with sphere/cone bounds; indices follow meshlet order
+#include <Core/Geometry/MeshFormat.h>
+#include <Core/Geometry/MeshImport.h>
+#include <Core/Geometry/Meshlets.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+
+int main(int argc, char** argv) {
+    Core::Geometry::MeshWriteOptions options;
+    const char* paths[2] = {};
+    int pathCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quantize") == 0) options.quantize = true;
+        else if (std::strcmp(argv[i], "--meshlets") == 0) options.meshlets = true;
+        else if (pathCount < 2) paths[pathCount++] = argv[i];
+        else pathCount = 3;
+    }
+    if (pathCount != 2) {
+        std::fprintf(stderr, "usage: %s [--quantize] [--meshlets] input.{obj,stl,ply} output.cmesh\n",
+            argv[0]);
+        return 2;
+    }
+    try {
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto mesh = Core::Geometry::importMesh(paths[0]);
+        const auto t1 = std::chrono::steady_clock::now();
+        Core::Geometry::writeMesh(paths[1], mesh, options);
+        const auto t2 = std::chrono::steady_clock::now();
+
+        const auto before = mesh.vertices.size() * sizeof(Core::Geometry::Vertex) +
+            mesh.indices.size() * sizeof(uint32_t);
+        std::printf("%s: %zu vertices, %zu triangles, %zu submeshes\n", paths[1],
+            mesh.vertices.size(), mesh.indices.size() / 3,
+            mesh.submeshes.empty() ? size_t{ 1 } : mesh.submeshes.size());
+        std::printf("%.1f MiB of float vertices + 32-bit indices -> %.1f MiB file\n",
+            double(before) / (1 << 20), double(std::filesystem::file_size(paths[1])) / (1 << 20));
+        if (options.meshlets) {
+            const auto before16 = Core::Geometry::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+            Core::Geometry::MeshletData meshlets;
+            Core::Geometry::appendMeshlets(meshlets, mesh.vertices, mesh.indices, options.limits);
+            const auto after16 = Core::Geometry::analyzeVertexCache(
+                Core::Geometry::meshletIndices(meshlets), mesh.vertices.size());
+            std::printf("%zu meshlets, ACMR %.3f -> %.3f (16-entry FIFO)\n",
+                meshlets.meshlets.size(), before16.acmr, after16.acmr);
+        }
+        std::printf("import %.1f ms, write %.1f ms\n",
+            std::chrono::duration<double, std::milli>(t1 - t0).count(),
+            std::chrono::duration<double, std::milli>(t2 - t1).count());
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
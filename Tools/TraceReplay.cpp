@@ -0,0 +1,322 @@
+// Headless replay of a command trace captured with Capture::TraceRecorder.
+// Runs on any Vulkan implementation, lavapipe / SwiftShader included, so a
+// spike captured on a user's machine can be reproduced and bisected on a
+// CPU-only box.
+//
+// Only what went through a Compute::ComputeDispatcher is in a trace; work a
+// renderer records into its own command buffers is not captured.
+//
+//   TraceReplay trace.ctrace [--loop 10] [--pipelined] [--top 20] [--json out.json]
+//
+// Shaders, pipelines and buffers are created once up front; uploads and
+// batches are then replayed --loop times, in capture order. Every batch is
+// waited for before the next is submitted and timed from submit to
+// resolution (record + execute + readback), per command buffer. With
+// --pipelined a frame's batches overlap and only frame times are reported;
+// an upload then waits only for the in-flight batches that use its buffer.
+// Frame times are always from a frame's first submit until all its batches
+// have resolved.
+#include <Core/Capture/CommandTrace.h>
+#include <Core/Compute/ComputeContext.h>
+#include <Core/Memory/HostAllocator.h>
+#include <Core/Shaders/ShaderReflection.h>
+#include <Core/Utils/Report.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using namespace Core::Capture;
+    using Clock = std::chrono::steady_clock;
+    using Core::Report::jsonNumber;
+    using Core::Report::jsonString;
+    using Core::Report::percentile;
+
+    struct Options {
+        std::string trace;
+        uint32_t loops = 1;
+        bool pipelined = false;
+        size_t top = 20;
+        std::string json;
+    };
+
+    double ms(Clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    // The GPU objects a trace refers to, created before any timing.
+    class ReplayState {
+    public:
+        ReplayState(Core::Compute::ComputeContext& context, std::vector<TraceRecord> const& records)
+            : context_(context) {
+            for (auto const& record : records) {
+                if (auto const* s = std::get_if<TraceShader>(&record)) addShader(*s);
+                else if (auto const* b = std::get_if<TraceBuffer>(&record)) addBuffer(*b);
+            }
+            zeroDeviceLocal();
+        }
+
+        Core::Compute::ComputePipeline const& pipeline(uint64_t contentHash) const {
+            const auto it = pipelines_.find(contentHash);
+            if (it == pipelines_.end())
+                throw std::runtime_error("trace: batch uses shader " + std::to_string(contentHash) +
+                    " before its Shader record");
+            return *it->second;
+        }
+        Core::Memory::Buffer const& buffer(uint32_t id) const {
+            if (id >= buffers_.size() || buffers_[id].empty())
+                throw std::runtime_error("trace: unknown buffer " + std::to_string(id));
+            return buffers_[id];
+        }
+        size_t shaderCount() const noexcept { return pipelines_.size(); }
+        size_t bufferCount() const noexcept { return buffers_.size(); }
+
+    private:
+        void addShader(TraceShader const& s) {
+            auto& device = context_.device();
+            auto module = std::make_shared<Core::Shaders::ShaderModule>(device,
+                vk::ShaderModuleCreateInfo{
+                    .codeSize = s.spirv.size() * sizeof(uint32_t),
+                    .pCode = s.spirv.data() },
+                s.contentHash, Core::Shaders::reflect(s.spirv));
+            const Core::Shaders::ShaderHandle handle(std::move(module),
+                Core::Shaders::ShaderKey("trace:" + std::to_string(s.contentHash),
+                    Core::Shaders::Stage::Compute, s.entry, uint64_t{ 0 }));
+            pipelines_[s.contentHash] = std::make_unique<Core::Compute::ComputePipeline>(device, handle);
+        }
+
+        void addBuffer(TraceBuffer const& b) {
+            if (b.id >= buffers_.size())
+                buffers_.resize(b.id + 1);
+            const bool hostVisible = static_cast<bool>(
+                vk::MemoryPropertyFlags(b.memory) & vk::MemoryPropertyFlagBits::eHostVisible);
+            buffers_[b.id] = context_.storageBuffer(b.size, hostVisible);
+        }
+
+        // Device-local contents weren't captured; start them at zero rather
+        // than whatever the allocation held.
+        void zeroDeviceLocal() {
+            auto& device = context_.device();
+            vk::raii::CommandPool pool(device.vkDevice(), vk::CommandPoolCreateInfo{
+                .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                .queueFamilyIndex = device.queues().computeFamily },
+                Core::Memory::hostCallbacks(Core::Memory::HostTag::Commands));
+            auto cmd = std::move(device.vkDevice().allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                .commandPool = *pool,
+                .level = vk::CommandBufferLevel::ePrimary,
+                .commandBufferCount = 1 }).front());
+            cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            for (auto const& b : buffers_)
+                if (!b.empty() && !b.mapped())
+                    cmd.fillBuffer(b.handle(), 0, vk::WholeSize, 0);
+            cmd.end();
+            const vk::CommandBufferSubmitInfo cmdInfo{ .commandBuffer = *cmd };
+            device.computeQueue().submit2(vk::SubmitInfo2{
+                .commandBufferInfoCount = 1,
+                .pCommandBufferInfos = &cmdInfo });
+            device.computeQueue().waitIdle();
+        }
+
+        Core::Compute::ComputeContext& context_;
+        std::unordered_map<uint64_t, std::unique_ptr<Core::Compute::ComputePipeline>> pipelines_;
+        std::vector<Core::Memory::Buffer> buffers_; // by trace id
+    };
+
+    Core::Compute::ComputeBatch build(ReplayState const& state, TraceBatch const& b) {
+        Core::Compute::ComputeBatch batch;
+        for (auto const& job : b.jobs) {
+            auto& j = batch.dispatch(state.pipeline(job.shader), job.groups[0], job.groups[1], job.groups[2]);
+            for (auto const& binding : job.bindings) {
+                auto const& buffer = state.buffer(binding.buffer);
+                j.bind(Core::Compute::BufferBinding{ binding.set, binding.binding, buffer.handle(),
+                    binding.offset, binding.range, &buffer });
+            }
+            j.pushConstants = job.pushConstants;
+        }
+        for (auto const& r : b.readbacks)
+            batch.readback(state.buffer(r.buffer), r.offset, r.size);
+        return batch;
+    }
+
+    void upload(ReplayState const& state, TraceUpload const& u) {
+        auto const& buffer = state.buffer(u.buffer);
+        if (!buffer.mapped())
+            throw std::runtime_error("trace: upload into device-local buffer " + std::to_string(u.buffer));
+        if (u.offset > buffer.size() || u.bytes.size() > buffer.size() - u.offset)
+            throw std::runtime_error("trace: upload outside buffer " + std::to_string(u.buffer));
+        std::memcpy(static_cast<std::byte*>(buffer.mapped()) + u.offset, u.bytes.data(), u.bytes.size());
+    }
+
+    struct Pending {
+        std::future<Core::Compute::ComputeResult> result;
+        std::vector<uint32_t> buffers; // trace ids the batch binds or reads back
+    };
+
+    std::vector<uint32_t> buffersOf(TraceBatch const& b) {
+        std::vector<uint32_t> ids;
+        for (auto const& job : b.jobs)
+            for (auto const& binding : job.bindings) ids.push_back(binding.buffer);
+        for (auto const& r : b.readbacks) ids.push_back(r.buffer);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return ids;
+    }
+
+    struct BatchTimes {
+        size_t frame = 0;
+        size_t jobs = 0;
+        std::vector<double> ms; // one per loop
+    };
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--pipelined") options.pipelined = true;
+        else if (arg == "--loop" && i + 1 < argc) options.loops = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--top" && i + 1 < argc) options.top = std::stoul(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc) options.json = argv[++i];
+        else if (options.trace.empty() && arg[0] != '-') options.trace = arg;
+        else usage = true;
+    }
+    if (usage || options.trace.empty()) {
+        std::fprintf(stderr, "usage: %s trace.ctrace [--loop N] [--pipelined] [--top N] [--json out.json]\n"
+            "Replays the ComputeDispatcher batches of a capture; render passes are not captured.\n",
+            argv[0]);
+        return 2;
+    }
+
+    try {
+        const auto records = readTrace(options.trace);
+        std::string capturedOn = "unknown";
+        for (auto const& record : records)
+            if (auto const* info = std::get_if<TraceInfo>(&record)) capturedOn = info->device;
+
+        Core::Compute::ComputeContext context;
+        auto& dispatcher = context.dispatcher();
+        const auto setupStart = Clock::now();
+        const ReplayState state(context, records);
+        std::printf("%s: captured on %s, replaying on %s\n", options.trace.c_str(), capturedOn.c_str(),
+            context.device().properties().deviceName.data());
+        std::printf("setup: %zu shaders, %zu buffers in %.1f ms\n", state.shaderCount(),
+            state.bufferCount(), ms(Clock::now() - setupStart));
+
+        std::vector<BatchTimes> batches;
+        std::vector<double> frames;
+        std::vector<Pending> pending; // in submission order
+        for (uint32_t loop = 0; loop < options.loops; ++loop) {
+            size_t batchIndex = 0, frame = 0;
+            bool frameOpen = false;
+            Clock::time_point frameStart{};
+            const auto drain = [&] {
+                for (auto& p : pending) p.result.get();
+                pending.clear();
+            };
+            // batches resolve in order: wait up to the last one using `id`
+            const auto drainUsing = [&] (uint32_t id) {
+                auto last = std::find_if(pending.rbegin(), pending.rend(), [id] (Pending const& p) {
+                    return std::binary_search(p.buffers.begin(), p.buffers.end(), id);
+                });
+                if (last == pending.rend())
+                    return;
+                const auto end = last.base();
+                for (auto it = pending.begin(); it != end; ++it) it->result.get();
+                pending.erase(pending.begin(), end);
+            };
+            const auto closeFrame = [&] {
+                drain();
+                if (frameOpen) frames.push_back(ms(Clock::now() - frameStart));
+                frameOpen = false;
+                ++frame;
+            };
+            for (auto const& record : records) {
+                if (auto const* u = std::get_if<TraceUpload>(&record)) {
+                    // the captured write happened after the earlier batches
+                    // were done with the buffer
+                    drainUsing(u->buffer);
+                    upload(state, *u);
+                }
+                else if (auto const* b = std::get_if<TraceBatch>(&record)) {
+                    if (!frameOpen) {
+                        frameStart = Clock::now();
+                        frameOpen = true;
+                    }
+                    if (batchIndex == batches.size())
+                        batches.push_back({ frame, b->jobs.size(), {} });
+                    const auto start = Clock::now();
+                    pending.push_back({ dispatcher.submit(build(state, *b)), buffersOf(*b) });
+                    if (!options.pipelined) {
+                        drain();
+                        batches[batchIndex].ms.push_back(ms(Clock::now() - start));
+                    }
+                    ++batchIndex;
+                }
+                else if (std::holds_alternative<TraceFrameEnd>(record)) {
+                    closeFrame();
+                }
+            }
+            if (frameOpen) closeFrame(); // batches after the last frame marker
+        }
+        dispatcher.waitIdle();
+
+        std::printf("%u loop(s), %zu frames, %zu command buffers per loop\n\n", options.loops,
+            frames.size() / options.loops, batches.size());
+        std::printf("frame ms     p50 %8.3f   p95 %8.3f   p99 %8.3f   max %8.3f\n",
+            percentile(frames, 0.50), percentile(frames, 0.95), percentile(frames, 0.99),
+            percentile(frames, 1.0));
+
+        std::vector<size_t> order(batches.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        if (!options.pipelined) {
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return percentile(batches[a].ms, 0.5) > percentile(batches[b].ms, 0.5);
+            });
+            std::printf("\nslowest command buffers (median over loops):\n");
+            std::printf("%8s %6s %6s %10s %10s %10s\n", "batch", "frame", "jobs", "p50 ms", "min ms", "max ms");
+            for (size_t i = 0; i < std::min(options.top, order.size()); ++i) {
+                auto const& b = batches[order[i]];
+                std::printf("%8zu %6zu %6zu %10.3f %10.3f %10.3f\n", order[i], b.frame, b.jobs,
+                    percentile(b.ms, 0.5), percentile(b.ms, 0.0), percentile(b.ms, 1.0));
+            }
+        }
+
+        if (!options.json.empty()) {
+            std::ofstream out(options.json);
+            if (!out) throw std::runtime_error("Failed to open " + options.json);
+            out << "{\n  \"trace\": " << jsonString(options.trace)
+                << ",\n  \"device\": " << jsonString(context.device().properties().deviceName.data())
+                << ",\n  \"loops\": " << options.loops
+                << ",\n  \"frame_ms\": { \"p50\": " << jsonNumber(percentile(frames, 0.50))
+                << ", \"p95\": " << jsonNumber(percentile(frames, 0.95))
+                << ", \"p99\": " << jsonNumber(percentile(frames, 0.99))
+                << ", \"max\": " << jsonNumber(percentile(frames, 1.0)) << " },\n  \"batches\": [";
+            // in capture order, so runs on different machines line up
+            for (size_t i = 0; i < batches.size() && !options.pipelined; ++i) {
+                auto const& b = batches[i];
+                out << (i ? "," : "") << "\n    { \"frame\": " << b.frame << ", \"jobs\": " << b.jobs
+                    << ", \"p50_ms\": " << jsonNumber(percentile(b.ms, 0.5))
+                    << ", \"min_ms\": " << jsonNumber(percentile(b.ms, 0.0))
+                    << ", \"max_ms\": " << jsonNumber(percentile(b.ms, 1.0)) << " }";
+            }
+            out << "\n  ]\n}\n";
+        }
+        return 0;
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,23 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "quantized_vertex.glsl"
+
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inUv;
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 offset;  // xyz: GpuMesh::transform.offset
+    vec4 scale;   // xyz: GpuMesh::transform.scale
+} pc;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outUv;
+
+void main() {
+    vec3 position = decodePosition(inPosition.xyz, pc.offset.xyz, pc.scale.xyz);
+    gl_Position = pc.viewProj * vec4(position, 1.0);
+    outNormal = decodeOctahedral(inNormal);
+    outUv = inUv;
+}
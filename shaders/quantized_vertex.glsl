@@ -0,0 +1,24 @@
+// Decode helpers for Geometry::QuantizedVertex (VertexQuantization.h).
+// Vertex input layout, stride 16:
+//   location 0  R16G16B16A16_UNORM  offset 0   position in [0,1] within the mesh bounds
+//   location 1  R16G16_SNORM        offset 8   octahedral normal
+//   location 2  R16G16_SFLOAT       offset 12  uv
+// The fixed-function fetch already does the unorm/snorm/half conversion;
+// what is left is the affine position transform and the octahedral unfold.
+#ifndef QUANTIZED_VERTEX_GLSL
+#define QUANTIZED_VERTEX_GLSL
+
+// offset = bounds.min, scale = bounds.max - bounds.min (GpuMesh::transform)
+vec3 decodePosition(vec3 q, vec3 offset, vec3 scale) {
+    return offset + q * scale;
+}
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+#endif